@@ -0,0 +1,68 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/AddressTranslator.h"
+#include <cassert>
+
+using namespace NetworkAnalytical;
+
+FastDivisor::FastDivisor(const uint32_t divisor) noexcept {
+    assert(divisor > 0);
+
+    // wraps to 0 when divisor is 1, which divide() handles separately
+    multiplier = UINT64_MAX / divisor + 1;
+}
+
+AddressTranslator::AddressTranslator() noexcept : dims_count(0), npus_count_per_dim{}, strides{} {}
+
+void AddressTranslator::append_dimension(const int npus_count) noexcept {
+    assert(npus_count > 0);
+    assert(dims_count < MultiDimAddress::max_dims_count);
+
+    // the new dimension steps over every NPU of the lower dimensions
+    strides[dims_count] = (dims_count == 0) ? 1 : strides[dims_count - 1] * npus_count_per_dim[dims_count - 1];
+    npus_count_per_dim[dims_count] = npus_count;
+    divisors[dims_count] = FastDivisor(static_cast<uint32_t>(npus_count));
+    dims_count++;
+}
+
+MultiDimAddress AddressTranslator::translate_address(const DeviceId npu_id) const noexcept {
+    assert(npu_id >= 0);
+
+    // If units-count if [2, 8, 4], and the given id is 47, then
+    // 47 / 2 = 23, address[0] = 47 - 23 * 2 = 1
+    // 23 / 8 = 2, address[1] = 23 - 2 * 8 = 7
+    // 2 / 4 = 0, address[2] = 2 - 0 * 4 = 2
+    // therefore the address is [1, 7, 2]
+    auto address = MultiDimAddress(dims_count, 0);
+    auto leftover = static_cast<uint32_t>(npu_id);
+    for (auto dim = 0; dim < dims_count; dim++) {
+        const auto quotient = divisors[dim].divide(leftover);
+        address[dim] = static_cast<DeviceId>(leftover - quotient * npus_count_per_dim[dim]);
+        leftover = quotient;
+    }
+
+    // the id should fit in the topology
+    assert(leftover == 0);
+
+    return address;
+}
+
+DeviceId AddressTranslator::translate_address_back(const MultiDimAddress& address) const noexcept {
+    assert(address.size() == dims_count);
+
+    auto npu_id = DeviceId{0};
+    for (auto dim = 0; dim < dims_count; dim++) {
+        npu_id += strides[dim] * address[dim];
+    }
+
+    return npu_id;
+}
+
+DeviceId AddressTranslator::get_stride(const int dim) const noexcept {
+    assert(0 <= dim && dim < dims_count);
+
+    return strides[dim];
+}
@@ -8,7 +8,7 @@ LICENSE file in the root directory of this source tree.
 
 using namespace NetworkAnalytical;
 
-EventQueue::EventQueue() noexcept : current_time(0) {
+EventQueue::EventQueue() noexcept : current_time(0), drain_callback(nullptr), drain_callback_arg(nullptr) {
     // create empty event queue
     event_queue = std::list<EventList>();
 }
@@ -38,6 +38,11 @@ void EventQueue::proceed() noexcept {
 
     // drop processed event list
     event_queue.pop_front();
+
+    // nothing left to happen
+    if (finished() && drain_callback != nullptr) {
+        drain_callback(drain_callback_arg);
+    }
 }
 
 void EventQueue::schedule_event(const EventTime event_time,
@@ -69,3 +74,8 @@ void EventQueue::schedule_event(const EventTime event_time,
     // add event to event_list
     event_list_it->add_event(callback, callback_arg);
 }
+
+void EventQueue::set_drain_callback(const Callback callback, const CallbackArg callback_arg) noexcept {
+    drain_callback = callback;
+    drain_callback_arg = callback_arg;
+}
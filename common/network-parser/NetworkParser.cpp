@@ -4,12 +4,39 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "common/NetworkParser.h"
+#include "common/MultiDimAddress.h"
 #include <cassert>
+#include <filesystem>
 #include <iostream>
 
 using namespace NetworkAnalytical;
 
-NetworkParser::NetworkParser(const std::string& path) noexcept : dims_count(-1) {
+NetworkParser::NetworkParser(const std::string& path) noexcept
+    : dims_count(-1),
+      config_path(path),
+      virtual_channels_count(1),
+      vc_arbitration(VirtualChannelArbitration::StrictPriority),
+      bus_arbitration(BusArbitration::FIFO),
+      switch_queueing(SwitchQueueing::Ideal),
+      switch_arbitration(SwitchArbitration::RoundRobin),
+      crossbar_speedup(1.0),
+      nic_injection_bandwidth(0),
+      nic_ejection_bandwidth(0),
+      nic_dma_engines(1),
+      nic_scheduling(NicScheduling::FIFO),
+      bit_error_rate(0),
+      packet_error_rate(0),
+      retransmission(Retransmission::SelectiveRepeat),
+      retransmission_window(8),
+      error_seed(0),
+      construction_threads(0),
+      lazy_links(false),
+      implicit_topology(false),
+      adaptive_routing(false),
+      striping(StripingPolicy::None),
+      cluster_agents(1),
+      cluster_agent_selection(ClusterAgentSelection::Hash),
+      topology_cache("") {
     // initialize values
     npus_count_per_dim = {};
     bandwidth_per_dim = {};
@@ -17,6 +44,13 @@ NetworkParser::NetworkParser(const std::string& path) noexcept : dims_count(-1)
     topology_per_dim = {};
     faulty_links = {};
     non_recursive_topo = {};
+    bandwidth_schedule = {};
+    link_health_schedule = {};
+    input_buffer_size_per_dim = {};
+    vc_weights = {};
+    link_error_rates = {};
+    in_network_reduction_per_dim = {};
+    reduction_throughput_per_dim = {};
 
     try {
         // load network config file
@@ -71,6 +105,187 @@ std::vector<int> NetworkParser::get_non_recursive_topo() const noexcept {
     return non_recursive_topo;
 }
 
+std::vector<std::tuple<int, int, EventTime, double>> NetworkParser::get_bandwidth_schedule() const noexcept {
+    return bandwidth_schedule;
+}
+
+std::vector<std::tuple<int, int, EventTime, double>> NetworkParser::get_link_health_schedule() const noexcept {
+    return link_health_schedule;
+}
+
+std::vector<ChunkSize> NetworkParser::get_input_buffer_sizes_per_dim() const noexcept {
+    return input_buffer_size_per_dim;
+}
+
+int NetworkParser::get_virtual_channels_count() const noexcept {
+    assert(virtual_channels_count > 0);
+
+    return virtual_channels_count;
+}
+
+VirtualChannelArbitration NetworkParser::get_vc_arbitration() const noexcept {
+    return vc_arbitration;
+}
+
+std::vector<int> NetworkParser::get_vc_weights() const noexcept {
+    assert(vc_weights.size() == virtual_channels_count);
+
+    return vc_weights;
+}
+
+BusArbitration NetworkParser::get_bus_arbitration() const noexcept {
+    return bus_arbitration;
+}
+
+SwitchQueueing NetworkParser::get_switch_queueing() const noexcept {
+    return switch_queueing;
+}
+
+SwitchArbitration NetworkParser::get_switch_arbitration() const noexcept {
+    return switch_arbitration;
+}
+
+double NetworkParser::get_crossbar_speedup() const noexcept {
+    assert(crossbar_speedup > 0);
+
+    return crossbar_speedup;
+}
+
+Bandwidth NetworkParser::get_nic_injection_bandwidth() const noexcept {
+    assert(nic_injection_bandwidth >= 0);
+
+    return nic_injection_bandwidth;
+}
+
+Bandwidth NetworkParser::get_nic_ejection_bandwidth() const noexcept {
+    assert(nic_ejection_bandwidth >= 0);
+
+    return nic_ejection_bandwidth;
+}
+
+int NetworkParser::get_nic_dma_engines() const noexcept {
+    assert(nic_dma_engines > 0);
+
+    return nic_dma_engines;
+}
+
+NicScheduling NetworkParser::get_nic_scheduling() const noexcept {
+    return nic_scheduling;
+}
+
+double NetworkParser::get_bit_error_rate() const noexcept {
+    return bit_error_rate;
+}
+
+double NetworkParser::get_packet_error_rate() const noexcept {
+    return packet_error_rate;
+}
+
+std::vector<std::tuple<int, int, double>> NetworkParser::get_link_error_rates() const noexcept {
+    return link_error_rates;
+}
+
+Retransmission NetworkParser::get_retransmission() const noexcept {
+    return retransmission;
+}
+
+int NetworkParser::get_retransmission_window() const noexcept {
+    assert(retransmission_window > 0);
+
+    return retransmission_window;
+}
+
+uint64_t NetworkParser::get_error_seed() const noexcept {
+    return error_seed;
+}
+
+int NetworkParser::get_construction_threads() const noexcept {
+    assert(construction_threads >= 0);
+
+    return construction_threads;
+}
+
+bool NetworkParser::get_lazy_links() const noexcept {
+    return lazy_links;
+}
+
+bool NetworkParser::get_implicit_topology() const noexcept {
+    return implicit_topology;
+}
+
+bool NetworkParser::get_adaptive_routing() const noexcept {
+    return adaptive_routing;
+}
+
+StripingPolicy NetworkParser::get_striping() const noexcept {
+    return striping;
+}
+
+int NetworkParser::get_cluster_agents() const noexcept {
+    assert(cluster_agents > 0);
+
+    return cluster_agents;
+}
+
+ClusterAgentSelection NetworkParser::get_cluster_agent_selection() const noexcept {
+    return cluster_agent_selection;
+}
+
+std::string NetworkParser::get_topology_cache() const noexcept {
+    return topology_cache;
+}
+
+uint64_t NetworkParser::get_topology_hash() const noexcept {
+    // FNV-1a over the values the connections of the topology are built from
+    auto hash = uint64_t{14'695'981'039'346'656'037ULL};
+    const auto mix = [&hash](const auto value) {
+        const auto* const bytes = reinterpret_cast<const unsigned char*>(&value);
+        for (auto i = size_t{0}; i < sizeof(value); i++) {
+            hash = (hash ^ bytes[i]) * 1'099'511'628'211ULL;
+        }
+    };
+
+    mix(dims_count);
+    for (auto dim = 0; dim < dims_count; dim++) {
+        mix(static_cast<int>(topology_per_dim[dim]));
+        mix(npus_count_per_dim[dim]);
+        mix(bandwidth_per_dim[dim]);
+        mix(latency_per_dim[dim]);
+    }
+    mix(faulty_links.size());
+    for (const auto& [src, dest, health] : faulty_links) {
+        mix(src);
+        mix(dest);
+        mix(health);
+    }
+    mix(non_recursive_topo.size());
+    for (const auto non_recursive : non_recursive_topo) {
+        mix(non_recursive);
+    }
+    mix(cluster_agents);
+
+    return hash;
+}
+
+std::vector<bool> NetworkParser::get_in_network_reduction_per_dim() const noexcept {
+    assert(dims_count > 0);
+
+    auto enabled_per_dim = std::vector<bool>(dims_count, false);
+    for (auto dim = 0; dim < in_network_reduction_per_dim.size(); dim++) {
+        enabled_per_dim[dim] = (in_network_reduction_per_dim[dim] != 0);
+    }
+    return enabled_per_dim;
+}
+
+std::vector<Bandwidth> NetworkParser::get_reduction_throughputs_per_dim() const noexcept {
+    assert(dims_count > 0);
+
+    if (reduction_throughput_per_dim.empty()) {
+        return std::vector<Bandwidth>(dims_count, 0);
+    }
+    return reduction_throughput_per_dim;
+}
+
 void NetworkParser::parse_network_config_yml(const YAML::Node& network_config) noexcept {
     // parse topology_per_dim
     const auto topology_names = parse_vector<std::string>(network_config["topology"]);
@@ -86,6 +301,122 @@ void NetworkParser::parse_network_config_yml(const YAML::Node& network_config) n
     npus_count_per_dim = parse_vector<int>(network_config["npus_count"]);
     bandwidth_per_dim = parse_vector<Bandwidth>(network_config["bandwidth"]);
     latency_per_dim = parse_vector<Latency>(network_config["latency"]);
+    if (network_config["input_buffer_size"]) {
+        input_buffer_size_per_dim = parse_vector<ChunkSize>(network_config["input_buffer_size"]);
+    }
+
+    // virtual channels, a single channel with equal weight by default
+    if (network_config["virtual_channels"]) {
+        virtual_channels_count = network_config["virtual_channels"].as<int>();
+    }
+    if (network_config["vc_arbitration"]) {
+        vc_arbitration = parse_vc_arbitration_name(network_config["vc_arbitration"].as<std::string>());
+    }
+    if (network_config["vc_weights"]) {
+        vc_weights = parse_vector<int>(network_config["vc_weights"]);
+    } else if (virtual_channels_count > 0) {
+        vc_weights.resize(virtual_channels_count, 1);
+    }
+
+    // shared-medium bus arbitration
+    if (network_config["bus_arbitration"]) {
+        bus_arbitration = parse_bus_arbitration_name(network_config["bus_arbitration"].as<std::string>());
+    }
+
+    // switch crossbar model, an ideal fabric by default
+    if (network_config["switch_queueing"]) {
+        switch_queueing = parse_switch_queueing_name(network_config["switch_queueing"].as<std::string>());
+    }
+    if (network_config["switch_arbitration"]) {
+        switch_arbitration = parse_switch_arbitration_name(network_config["switch_arbitration"].as<std::string>());
+    }
+    if (network_config["crossbar_speedup"]) {
+        crossbar_speedup = network_config["crossbar_speedup"].as<double>();
+    }
+
+    // NPU network interfaces, unlimited by default
+    if (network_config["nic_injection_bandwidth"]) {
+        nic_injection_bandwidth = network_config["nic_injection_bandwidth"].as<Bandwidth>();
+    }
+    if (network_config["nic_ejection_bandwidth"]) {
+        nic_ejection_bandwidth = network_config["nic_ejection_bandwidth"].as<Bandwidth>();
+    }
+    if (network_config["nic_dma_engines"]) {
+        nic_dma_engines = network_config["nic_dma_engines"].as<int>();
+    }
+    if (network_config["nic_scheduling"]) {
+        nic_scheduling = parse_nic_scheduling_name(network_config["nic_scheduling"].as<std::string>());
+    }
+
+    // stochastic link errors, error-free by default
+    if (network_config["bit_error_rate"]) {
+        bit_error_rate = network_config["bit_error_rate"].as<double>();
+    }
+    if (network_config["packet_error_rate"]) {
+        packet_error_rate = network_config["packet_error_rate"].as<double>();
+    }
+    if (network_config["link_error_rates"]) {
+        for (const auto& link_node : network_config["link_error_rates"]) {
+            if (!link_node.IsSequence() || link_node.size() != 3) {
+                std::cerr << "[Error] (network/analytical) "
+                          << "Invalid link_error_rates format. Expected [src, dst, packet_error_rate]." << std::endl;
+                std::exit(-1);
+            }
+            link_error_rates.emplace_back(link_node[0].as<int>(), link_node[1].as<int>(), link_node[2].as<double>());
+        }
+    }
+    if (network_config["retransmission"]) {
+        retransmission = parse_retransmission_name(network_config["retransmission"].as<std::string>());
+    }
+    if (network_config["retransmission_window"]) {
+        retransmission_window = network_config["retransmission_window"].as<int>();
+    }
+    if (network_config["error_seed"]) {
+        error_seed = network_config["error_seed"].as<uint64_t>();
+    }
+
+    // parallel topology construction, using all hardware threads by default
+    if (network_config["construction_threads"]) {
+        construction_threads = network_config["construction_threads"].as<int>();
+    }
+
+    // lazy link materialization, disabled by default
+    if (network_config["lazy_links"]) {
+        lazy_links = network_config["lazy_links"].as<bool>();
+    }
+
+    // implicit topology, materializing devices and links once used, disabled by default
+    if (network_config["implicit_topology"]) {
+        implicit_topology = network_config["implicit_topology"].as<bool>();
+    }
+
+    // load-adaptive dimension order, disabled by default
+    if (network_config["adaptive_routing"]) {
+        adaptive_routing = network_config["adaptive_routing"].as<bool>();
+    }
+
+    // multipath striping of the chunks, disabled by default
+    if (network_config["striping"]) {
+        striping = parse_striping_name(network_config["striping"].as<std::string>());
+    }
+
+    // directory of the compiled topologies, disabled by default
+    // relative paths are resolved against the directory of the network config file
+    if (network_config["topology_cache"]) {
+        auto cache_path = std::filesystem::path(network_config["topology_cache"].as<std::string>());
+        if (cache_path.is_relative()) {
+            cache_path = std::filesystem::path(config_path).parent_path() / cache_path;
+        }
+        topology_cache = cache_path.string();
+    }
+
+    // in-network reduction at switches, disabled by default
+    if (network_config["in_network_reduction"]) {
+        in_network_reduction_per_dim = parse_vector<int>(network_config["in_network_reduction"]);
+    }
+    if (network_config["reduction_throughput"]) {
+        reduction_throughput_per_dim = parse_vector<Bandwidth>(network_config["reduction_throughput"]);
+    }
     // Parse non_recursive_topo with format priority
     if (network_config["non_recursive_from"]) {
         // NEW FORMAT: crossover index - dimensions >= crossover are non-recursive
@@ -108,6 +439,15 @@ void NetworkParser::parse_network_config_yml(const YAML::Node& network_config) n
         non_recursive_topo.resize(dims_count, 0);
     }
 
+    // agents per cluster, a single one by default
+    if (network_config["cluster_agents"]) {
+        cluster_agents = network_config["cluster_agents"].as<int>();
+    }
+    if (network_config["cluster_agent_selection"]) {
+        cluster_agent_selection =
+            parse_cluster_agent_selection_name(network_config["cluster_agent_selection"].as<std::string>());
+    }
+
     // check the validity of the parsed network config
     check_validity();
 
@@ -125,6 +465,75 @@ void NetworkParser::parse_network_config_yml(const YAML::Node& network_config) n
             }
         }
     }
+
+    // time-varying bandwidth support
+    if (network_config["bandwidth_schedule"]) {
+        parse_bandwidth_schedule(network_config["bandwidth_schedule"]);
+    }
+    if (network_config["bandwidth_schedule_file"]) {
+        // relative paths are resolved against the directory of the network config file
+        auto schedule_path = std::filesystem::path(network_config["bandwidth_schedule_file"].as<std::string>());
+        if (schedule_path.is_relative()) {
+            schedule_path = std::filesystem::path(config_path).parent_path() / schedule_path;
+        }
+
+        try {
+            const auto schedule_config = YAML::LoadFile(schedule_path.string());
+            parse_bandwidth_schedule(schedule_config["bandwidth_schedule"]);
+        } catch (const YAML::BadFile& e) {
+            // loading bandwidth schedule file failed
+            std::cerr << "[Error] (network/analytical) " << e.what() << ": " << schedule_path << std::endl;
+            std::exit(-1);
+        }
+    }
+
+    // link failures, restorations, and derates at runtime
+    if (network_config["link_health_schedule"]) {
+        for (const auto& change_node : network_config["link_health_schedule"]) {
+            if (!change_node.IsSequence() || change_node.size() != 4) {
+                std::cerr << "[Error] (network/analytical) "
+                          << "Invalid link_health_schedule format. Expected [src, dst, time, health]." << std::endl;
+                std::exit(-1);
+            }
+
+            const auto src = change_node[0].as<int>();
+            const auto dst = change_node[1].as<int>();
+            const auto time = change_node[2].as<EventTime>();
+            const auto health = change_node[3].as<double>();
+
+            if (health < 0 || health > 1) {
+                std::cerr << "[Error] (network/analytical) " << "link_health_schedule health (" << health
+                          << ") should be between 0 and 1" << std::endl;
+                std::exit(-1);
+            }
+
+            link_health_schedule.emplace_back(src, dst, time, health);
+        }
+    }
+}
+
+void NetworkParser::parse_bandwidth_schedule(const YAML::Node& schedule_node) noexcept {
+    for (const auto& step_node : schedule_node) {
+        if (!step_node.IsSequence() || step_node.size() != 4) {
+            std::cerr << "[Error] (network/analytical) "
+                      << "Invalid bandwidth_schedule format. Expected [src, dst, time, scale]." << std::endl;
+            std::exit(-1);
+        }
+
+        const auto src = step_node[0].as<int>();
+        const auto dst = step_node[1].as<int>();
+        const auto time = step_node[2].as<EventTime>();
+        const auto scale = step_node[3].as<double>();
+
+        // a step cannot stop the link, use faulty_links for dead links
+        if (scale <= 0) {
+            std::cerr << "[Error] (network/analytical) " << "bandwidth_schedule scale (" << scale
+                      << ") should be larger than 0" << std::endl;
+            std::exit(-1);
+        }
+
+        bandwidth_schedule.emplace_back(src, dst, time, scale);
+    }
 }
 
 TopologyBuildingBlock NetworkParser::parse_topology_name(const std::string& topology_name) noexcept {
@@ -176,6 +585,153 @@ TopologyBuildingBlock NetworkParser::parse_topology_name(const std::string& topo
     std::exit(-1);
 }
 
+VirtualChannelArbitration NetworkParser::parse_vc_arbitration_name(const std::string& arbitration_name) noexcept {
+    assert(!arbitration_name.empty());
+
+    if (arbitration_name == "StrictPriority") {
+        return VirtualChannelArbitration::StrictPriority;
+    }
+
+    if (arbitration_name == "WeightedRoundRobin") {
+        return VirtualChannelArbitration::WeightedRoundRobin;
+    }
+
+    // shouldn't reach here
+    std::cerr << "[Error] (network/analytical) " << "vc_arbitration " << arbitration_name << " not supported"
+              << std::endl;
+    std::exit(-1);
+}
+
+BusArbitration NetworkParser::parse_bus_arbitration_name(const std::string& arbitration_name) noexcept {
+    assert(!arbitration_name.empty());
+
+    if (arbitration_name == "FIFO") {
+        return BusArbitration::FIFO;
+    }
+
+    if (arbitration_name == "RoundRobin") {
+        return BusArbitration::RoundRobin;
+    }
+
+    // shouldn't reach here
+    std::cerr << "[Error] (network/analytical) " << "bus_arbitration " << arbitration_name << " not supported"
+              << std::endl;
+    std::exit(-1);
+}
+
+SwitchQueueing NetworkParser::parse_switch_queueing_name(const std::string& queueing_name) noexcept {
+    assert(!queueing_name.empty());
+
+    if (queueing_name == "Ideal") {
+        return SwitchQueueing::Ideal;
+    }
+
+    if (queueing_name == "OutputQueued") {
+        return SwitchQueueing::OutputQueued;
+    }
+
+    if (queueing_name == "InputQueued") {
+        return SwitchQueueing::InputQueued;
+    }
+
+    // shouldn't reach here
+    std::cerr << "[Error] (network/analytical) " << "switch_queueing " << queueing_name << " not supported"
+              << std::endl;
+    std::exit(-1);
+}
+
+SwitchArbitration NetworkParser::parse_switch_arbitration_name(const std::string& arbitration_name) noexcept {
+    assert(!arbitration_name.empty());
+
+    if (arbitration_name == "RoundRobin") {
+        return SwitchArbitration::RoundRobin;
+    }
+
+    if (arbitration_name == "iSLIP") {
+        return SwitchArbitration::iSLIP;
+    }
+
+    // shouldn't reach here
+    std::cerr << "[Error] (network/analytical) " << "switch_arbitration " << arbitration_name << " not supported"
+              << std::endl;
+    std::exit(-1);
+}
+
+NicScheduling NetworkParser::parse_nic_scheduling_name(const std::string& scheduling_name) noexcept {
+    assert(!scheduling_name.empty());
+
+    if (scheduling_name == "FIFO") {
+        return NicScheduling::FIFO;
+    }
+
+    if (scheduling_name == "RoundRobin") {
+        return NicScheduling::RoundRobin;
+    }
+
+    // shouldn't reach here
+    std::cerr << "[Error] (network/analytical) " << "nic_scheduling " << scheduling_name << " not supported"
+              << std::endl;
+    std::exit(-1);
+}
+
+Retransmission NetworkParser::parse_retransmission_name(const std::string& retransmission_name) noexcept {
+    assert(!retransmission_name.empty());
+
+    if (retransmission_name == "GoBackN") {
+        return Retransmission::GoBackN;
+    }
+
+    if (retransmission_name == "SelectiveRepeat") {
+        return Retransmission::SelectiveRepeat;
+    }
+
+    // shouldn't reach here
+    std::cerr << "[Error] (network/analytical) " << "retransmission " << retransmission_name << " not supported"
+              << std::endl;
+    std::exit(-1);
+}
+
+StripingPolicy NetworkParser::parse_striping_name(const std::string& striping_name) noexcept {
+    assert(!striping_name.empty());
+
+    if (striping_name == "None") {
+        return StripingPolicy::None;
+    }
+
+    if (striping_name == "Hash") {
+        return StripingPolicy::Hash;
+    }
+
+    if (striping_name == "RoundRobin") {
+        return StripingPolicy::RoundRobin;
+    }
+
+    if (striping_name == "BandwidthWeighted") {
+        return StripingPolicy::BandwidthWeighted;
+    }
+
+    // shouldn't reach here
+    std::cerr << "[Error] (network/analytical) " << "striping " << striping_name << " not supported" << std::endl;
+    std::exit(-1);
+}
+
+ClusterAgentSelection NetworkParser::parse_cluster_agent_selection_name(const std::string& selection_name) noexcept {
+    assert(!selection_name.empty());
+
+    if (selection_name == "Hash") {
+        return ClusterAgentSelection::Hash;
+    }
+
+    if (selection_name == "LeastLoaded") {
+        return ClusterAgentSelection::LeastLoaded;
+    }
+
+    // shouldn't reach here
+    std::cerr << "[Error] (network/analytical) " << "cluster_agent_selection " << selection_name << " not supported"
+              << std::endl;
+    std::exit(-1);
+}
+
 void NetworkParser::check_validity() const noexcept {
     // dims_count should match
     if (dims_count != npus_count_per_dim.size()) {
@@ -184,6 +740,13 @@ void NetworkParser::check_validity() const noexcept {
         std::exit(-1);
     }
 
+    // multi-dimensional addresses have a fixed capacity
+    if (dims_count > MultiDimAddress::max_dims_count) {
+        std::cerr << "[Error] (network/analytical) " << "dims_count (" << dims_count << ") exceeds the maximum ("
+                  << MultiDimAddress::max_dims_count << ")" << std::endl;
+        std::exit(-1);
+    }
+
     if (dims_count != bandwidth_per_dim.size()) {
         std::cerr << "[Error] (network/analytical) " << "length of bandwidth (" << bandwidth_per_dim.size()
                   << ") doesn't match with dims_count (" << dims_count << ")" << std::endl;
@@ -223,6 +786,146 @@ void NetworkParser::check_validity() const noexcept {
         }
     }
 
+    // input buffer sizes are optional, but should match dims_count and be positive if given
+    if (!input_buffer_size_per_dim.empty()) {
+        if (dims_count != input_buffer_size_per_dim.size()) {
+            std::cerr << "[Error] (network/analytical) " << "length of input_buffer_size ("
+                      << input_buffer_size_per_dim.size() << ") doesn't match with dims_count (" << dims_count
+                      << ")" << std::endl;
+            std::exit(-1);
+        }
+
+        for (const auto& input_buffer_size : input_buffer_size_per_dim) {
+            if (input_buffer_size == 0) {
+                std::cerr << "[Error] (network/analytical) " << "input_buffer_size should be larger than 0"
+                          << std::endl;
+                std::exit(-1);
+            }
+        }
+    }
+
+    // virtual channels count should be positive, with one weight per each channel
+    if (virtual_channels_count <= 0) {
+        std::cerr << "[Error] (network/analytical) " << "virtual_channels (" << virtual_channels_count
+                  << ") should be larger than 0" << std::endl;
+        std::exit(-1);
+    }
+
+    if (virtual_channels_count != vc_weights.size()) {
+        std::cerr << "[Error] (network/analytical) " << "length of vc_weights (" << vc_weights.size()
+                  << ") doesn't match with virtual_channels (" << virtual_channels_count << ")" << std::endl;
+        std::exit(-1);
+    }
+
+    for (const auto& vc_weight : vc_weights) {
+        if (vc_weight <= 0) {
+            std::cerr << "[Error] (network/analytical) " << "vc_weight (" << vc_weight << ") should be larger than 0"
+                      << std::endl;
+            std::exit(-1);
+        }
+    }
+
+    // crossbar speedup should be positive
+    if (crossbar_speedup <= 0) {
+        std::cerr << "[Error] (network/analytical) " << "crossbar_speedup (" << crossbar_speedup
+                  << ") should be larger than 0" << std::endl;
+        std::exit(-1);
+    }
+
+    // network interface bandwidths should be non-negative, with at least one DMA engine
+    if (nic_injection_bandwidth < 0 || nic_ejection_bandwidth < 0) {
+        std::cerr << "[Error] (network/analytical) " << "nic_injection_bandwidth and nic_ejection_bandwidth "
+                  << "should be non-negative" << std::endl;
+        std::exit(-1);
+    }
+
+    if (nic_dma_engines <= 0) {
+        std::cerr << "[Error] (network/analytical) " << "nic_dma_engines (" << nic_dma_engines
+                  << ") should be larger than 0" << std::endl;
+        std::exit(-1);
+    }
+
+    // error rates should be probabilities below 1, so a chunk eventually goes through
+    if (bit_error_rate < 0 || bit_error_rate >= 1) {
+        std::cerr << "[Error] (network/analytical) " << "bit_error_rate (" << bit_error_rate
+                  << ") should be in [0, 1)" << std::endl;
+        std::exit(-1);
+    }
+
+    if (packet_error_rate < 0 || packet_error_rate >= 1) {
+        std::cerr << "[Error] (network/analytical) " << "packet_error_rate (" << packet_error_rate
+                  << ") should be in [0, 1)" << std::endl;
+        std::exit(-1);
+    }
+
+    for (const auto& [src, dst, link_packet_error_rate] : link_error_rates) {
+        if (link_packet_error_rate < 0 || link_packet_error_rate >= 1) {
+            std::cerr << "[Error] (network/analytical) " << "packet error rate (" << link_packet_error_rate
+                      << ") of link " << src << " - " << dst << " should be in [0, 1)" << std::endl;
+            std::exit(-1);
+        }
+    }
+
+    if (cluster_agents <= 0) {
+        std::cerr << "[Error] (network/analytical) " << "cluster_agents (" << cluster_agents
+                  << ") should be larger than 0" << std::endl;
+        std::exit(-1);
+    }
+
+    if (retransmission_window <= 0) {
+        std::cerr << "[Error] (network/analytical) " << "retransmission_window (" << retransmission_window
+                  << ") should be larger than 0" << std::endl;
+        std::exit(-1);
+    }
+
+    if (construction_threads < 0) {
+        std::cerr << "[Error] (network/analytical) " << "construction_threads (" << construction_threads
+                  << ") should be 0 or positive" << std::endl;
+        std::exit(-1);
+    }
+
+    // in-network reduction is given per each dimension, and only Switch dimensions can reduce chunks
+    if (!in_network_reduction_per_dim.empty()) {
+        if (dims_count != in_network_reduction_per_dim.size()) {
+            std::cerr << "[Error] (network/analytical) " << "length of in_network_reduction ("
+                      << in_network_reduction_per_dim.size() << ") doesn't match with dims_count (" << dims_count
+                      << ")" << std::endl;
+            std::exit(-1);
+        }
+
+        for (auto dim = 0; dim < dims_count; dim++) {
+            const auto enabled = in_network_reduction_per_dim[dim];
+            if (enabled != 0 && enabled != 1) {
+                std::cerr << "[Error] (network/analytical) " << "in_network_reduction values must be 0 or 1, got "
+                          << enabled << " at dimension " << dim << std::endl;
+                std::exit(-1);
+            }
+
+            if (enabled == 1 && topology_per_dim[dim] != TopologyBuildingBlock::Switch) {
+                std::cerr << "[Error] (network/analytical) " << "in_network_reduction requires a Switch, "
+                          << "but dimension " << dim << " isn't one" << std::endl;
+                std::exit(-1);
+            }
+        }
+    }
+
+    if (!reduction_throughput_per_dim.empty()) {
+        if (dims_count != reduction_throughput_per_dim.size()) {
+            std::cerr << "[Error] (network/analytical) " << "length of reduction_throughput ("
+                      << reduction_throughput_per_dim.size() << ") doesn't match with dims_count (" << dims_count
+                      << ")" << std::endl;
+            std::exit(-1);
+        }
+
+        for (const auto& reduction_throughput : reduction_throughput_per_dim) {
+            if (reduction_throughput < 0) {
+                std::cerr << "[Error] (network/analytical) " << "reduction_throughput (" << reduction_throughput
+                          << ") should be non-negative" << std::endl;
+                std::exit(-1);
+            }
+        }
+    }
+
     // Validate non_recursive_topo
     if (!non_recursive_topo.empty()) {
         // Size must match dims_count
@@ -8,10 +8,15 @@ LICENSE file in the root directory of this source tree.
 
 using namespace NetworkAnalyticalCongestionAware;
 
-Bus::Bus(const int npus_count, const Bandwidth bandwidth, const Latency latency) noexcept
-    : BasicTopology(npus_count, npus_count + 1, bandwidth, latency) {
+Bus::Bus(const int npus_count,
+         const Bandwidth bandwidth,
+         const Latency latency,
+         const BusArbitration arbitration,
+         const bool is_multi_dim) noexcept
+    : BasicTopology(npus_count, npus_count, bandwidth, latency, is_multi_dim),
+      arbitration(arbitration) {
     // e.g., if npus_count=8, then
-    // there are total 9 devices, where ordinary npus are 0-7, and switch is 8
+    // there are total 8 devices, all attached to the same bus
     assert(npus_count > 0);
     assert(bandwidth > 0);
     assert(latency >= 0);
@@ -19,26 +24,25 @@ Bus::Bus(const int npus_count, const Bandwidth bandwidth, const Latency latency)
     // set topology type
     basic_topology_type = TopologyBuildingBlock::Bus;
 
-    // set switch id
-    bus_id = npus_count;
-
-    // connect npus and switches, the link should be bidirectional
-    for (auto i = 0; i < npus_count; i++) {
-        connect(i, bus_id, bandwidth, latency, true);
+    // attach all npus to the shared medium
+    if (!is_multi_dim) {
+        auto device_ids = std::vector<DeviceId>();
+        for (auto i = 0; i < npus_count; i++) {
+            device_ids.push_back(i);
+        }
+        shared_medium_connect(device_ids, bandwidth, latency, arbitration);
     }
 }
 
-Route Bus::route(DeviceId src, DeviceId dest) const noexcept {
+Route Bus::route(const DeviceId src, const DeviceId dest) const noexcept {
     // assert npus are in valid range
     assert(0 <= src && src < npus_count);
     assert(0 <= dest && dest < npus_count);
 
     // construct route
-    // start at source, and go to switch, then go to destination
+    // the bus takes the chunk from the source directly to the destination
     auto route = Route();
-    
     route.push_back(devices[src]);
-    route.push_back(devices[bus_id]);
     route.push_back(devices[dest]);
 
     return route;
@@ -48,9 +52,16 @@ std::vector<ConnectionPolicy> Bus::get_connection_policies() const noexcept {
     std::vector<ConnectionPolicy> policies;
 
     for (auto i = 0; i < npus_count; i++) {
-        policies.emplace_back(ConnectionPolicy{i, bus_id});
-        policies.emplace_back(ConnectionPolicy{bus_id, i});
+        for (auto j = 0; j < npus_count; j++) {
+            if (i != j) {
+                policies.emplace_back(i, j);
+            }
+        }
     }
 
     return policies;
 }
+
+BusArbitration Bus::get_arbitration() const noexcept {
+    return arbitration;
+}
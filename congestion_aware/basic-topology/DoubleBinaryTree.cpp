@@ -90,6 +90,34 @@ Route DoubleBinaryTree::route(DeviceId src, DeviceId dest) const noexcept {
     return route;
 }
 
+std::vector<Route> DoubleBinaryTree::routes(DeviceId src, DeviceId dest) const noexcept {
+    // assert npus are in valid range
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+
+    const auto path_max_tree = get_path(m_root_max_tree_root, src, dest);
+    const auto path_min_tree = get_path(m_root_min_tree_root, src, dest);
+
+    // the path route() picks first, then the path through the other tree if it differs
+    const auto& first_path = path_max_tree.size() < path_min_tree.size() ? path_max_tree : path_min_tree;
+    const auto& second_path = (&first_path == &path_max_tree) ? path_min_tree : path_max_tree;
+
+    const auto to_route = [this](const std::vector<int>& path) {
+        auto route = Route();
+        for (const auto& id : path) {
+            route.push_back(devices[id]);
+        }
+        return route;
+    };
+
+    auto tree_routes = std::vector<Route>{to_route(first_path)};
+    if (second_path != first_path) {
+        tree_routes.push_back(to_route(second_path));
+    }
+
+    return tree_routes;
+}
+
 std::vector<ConnectionPolicy> DoubleBinaryTree::get_connection_policies() const noexcept {
     return m_policies;
 }
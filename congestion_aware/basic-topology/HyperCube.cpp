@@ -16,16 +16,17 @@ HyperCube::HyperCube(const int npus_count,
            const bool bidirectional,
            const bool is_multi_dim,
            const int non_recursive_topo,
-           const std::vector<std::tuple<int, int, double>>& faulty_links) noexcept
+           std::shared_ptr<const FaultMap> fault_map) noexcept
     : bidirectional(bidirectional),
       BasicTopology(npus_count, npus_count, bandwidth, latency, is_multi_dim),
-      non_recursive_topo(non_recursive_topo),
-      faulty_links(faulty_links) 
-{   // initialize faulty links
+      non_recursive_topo(non_recursive_topo) {
     assert(npus_count > 0);
     assert(bandwidth > 0);
     assert(latency >= 0);
 
+    // faulty links derate the links connected below
+    set_fault_map(std::move(fault_map));
+
     HyperCube::basic_topology_type = TopologyBuildingBlock::HyperCube;
 
     if (!is_multi_dim) {
@@ -95,6 +96,56 @@ Route HyperCube::route(DeviceId src, DeviceId dest) const noexcept {
     return route;
 }
 
+std::vector<Route> HyperCube::routes(const DeviceId src, const DeviceId dest) const noexcept {
+    // assert npus are in valid range
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+
+    // flipping the lowest differing bit first is route() itself
+    auto all_routes = std::vector<Route>{route(src, dest)};
+
+    const auto diff = static_cast<uint32_t>(src ^ dest);
+    if (diff == 0) {
+        return all_routes;
+    }
+    for (auto bit = __builtin_ctz(diff) + 1; bit < 32; bit++) {
+        if ((diff >> bit) & 1U) {
+            auto candidate_route = route_from_bit(src, dest, bit);
+            if (!candidate_route.empty()) {
+                all_routes.push_back(std::move(candidate_route));
+            }
+        }
+    }
+
+    return all_routes;
+}
+
+Route HyperCube::route_from_bit(const DeviceId src, const DeviceId dest, const int first_bit) const noexcept {
+    const auto diff = static_cast<uint32_t>(src ^ dest);
+    assert((diff >> first_bit) & 1U);
+
+    Route route;
+    DeviceId current = src;
+    route.push_back(devices.at(current));
+
+    // flip the bits from first_bit upwards, then the ones below it
+    for (auto i = 0; i < 32; i++) {
+        const auto bit = (first_bit + i) % 32;
+        if (((diff >> bit) & 1U) == 0) {
+            continue;
+        }
+
+        const DeviceId next = current ^ (1 << bit);
+        if (next >= npus_count) {
+            return {};
+        }
+        route.push_back(devices.at(next));
+        current = next;
+    }
+    assert(current == dest);
+
+    return route;
+}
 
 std::vector<ConnectionPolicy> HyperCube::get_connection_policies() const noexcept {
     std::vector<ConnectionPolicy> policies;
@@ -116,18 +167,3 @@ std::vector<ConnectionPolicy> HyperCube::get_connection_policies() const noexcep
 
     return policies;
 }
-
-
-double HyperCube::fault_derate(int src, int dst) const {
-    for (const auto& link : faulty_links) {
-        int a = std::get<0>(link);
-        int b = std::get<1>(link);
-        double health = std::get<2>(link);
-
-        if ((a == src && b == dst) || (a == dst && b == src)) {
-            return health;
-        }
-    }
-    return 1.0;  // ✅ default: healthy link
-}
-
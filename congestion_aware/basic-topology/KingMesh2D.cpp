@@ -15,13 +15,16 @@ KingMesh2D::KingMesh2D(const int npus_count,
                  const Latency latency,
                  const bool bidirectional,
                  const bool is_multi_dim,
-                 const std::vector<std::tuple<int, int, double>>& faulty_links) noexcept
+                 std::shared_ptr<const FaultMap> fault_map) noexcept
     : bidirectional(bidirectional),
-      BasicTopology(npus_count, npus_count, bandwidth, latency, is_multi_dim), faulty_links(faulty_links) {
+      BasicTopology(npus_count, npus_count, bandwidth, latency, is_multi_dim) {
     assert(npus_count > 0);
     assert(bandwidth > 0);
     assert(latency >= 0);
 
+    // faulty links derate the links connected below
+    set_fault_map(std::move(fault_map));
+
 
     KingMesh2D::basic_topology_type = TopologyBuildingBlock::KingMesh2D;
 
@@ -230,18 +233,3 @@ std::vector<ConnectionPolicy> KingMesh2D::get_connection_policies() const noexce
 
     return policies;
 }
-
-double KingMesh2D::fault_derate(int src, int dst) const{
-    for (const auto& link : faulty_links) {
-        int a = std::get<0>(link);
-        int b = std::get<1>(link);
-        double health = std::get<2>(link);
-
-        // If this link exists and health != 0.0 → it's soft fault
-        if ((a == src && b == dst) || (a == dst && b == src)) {
-            return health;
-        }
-    }
-    return 1.0;
-}
-
@@ -14,16 +14,17 @@ Ring::Ring(const int npus_count,
            const bool bidirectional,
            const bool is_multi_dim,
            const int non_recursive_topo,
-           const std::vector<std::tuple<int, int, double>>& faulty_links) noexcept
+           std::shared_ptr<const FaultMap> fault_map) noexcept
     : bidirectional(bidirectional),
       BasicTopology(npus_count, npus_count, bandwidth, latency, is_multi_dim),
-      non_recursive_topo(non_recursive_topo),
-      faulty_links(faulty_links) 
-{   // initialize faulty links
+      non_recursive_topo(non_recursive_topo) {
     assert(npus_count > 0);
     assert(bandwidth > 0);
     assert(latency >= 0);
 
+    // faulty links derate the links connected below
+    set_fault_map(std::move(fault_map));
+
     Ring::basic_topology_type = TopologyBuildingBlock::Ring;
 
     if (!is_multi_dim) {
@@ -55,9 +56,6 @@ Route Ring::route(DeviceId src, DeviceId dest) const noexcept {
     assert(0 <= src && src < npus_count);
     assert(0 <= dest && dest < npus_count);
 
-    // construct empty route
-    auto route = Route();
-
     auto step = 1;  // default direction: clockwise
     if (bidirectional) {
         // check whether going anticlockwise is shorter
@@ -73,6 +71,33 @@ Route Ring::route(DeviceId src, DeviceId dest) const noexcept {
         }
     }
 
+    return route_in_direction(src, dest, step);
+}
+
+std::vector<Route> Ring::routes(const DeviceId src, const DeviceId dest) const noexcept {
+    // assert npus are in valid range
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+
+    auto clockwise_dist = dest - src;
+    if (clockwise_dist < 0) {
+        clockwise_dist += npus_count;
+    }
+
+    // both directions are equally short halfway around a bidirectional ring
+    if (bidirectional && clockwise_dist != 0 && 2 * clockwise_dist == npus_count) {
+        return {route_in_direction(src, dest, 1), route_in_direction(src, dest, -1)};
+    }
+
+    return {route(src, dest)};
+}
+
+Route Ring::route_in_direction(const DeviceId src, const DeviceId dest, const int step) const noexcept {
+    assert(step == 1 || step == -1);
+
+    // construct empty route
+    auto route = Route();
+
     // construct the route
     auto current = src;
     while (current != dest) {
@@ -110,17 +135,3 @@ std::vector<ConnectionPolicy> Ring::get_connection_policies() const noexcept {
 
     return policies;
 }
-
-double Ring::fault_derate(int src, int dst) const {
-    for (const auto& link : faulty_links) {
-        int a = std::get<0>(link);
-        int b = std::get<1>(link);
-        double health = std::get<2>(link);
-
-        if ((a == src && b == dst) || (a == dst && b == src)) {
-            return health;
-        }
-    }
-    return 1.0;  // ✅ default: healthy link
-}
-
@@ -13,14 +13,16 @@ Switch::Switch(const int npus_count,
            const Latency latency,
            const bool bidirectional,
            const bool is_multi_dim,
-           const std::vector<std::tuple<int, int, double>>& faulty_links) noexcept
+           std::shared_ptr<const FaultMap> fault_map) noexcept
     : bidirectional(bidirectional),
-      BasicTopology(npus_count, npus_count, bandwidth, latency, is_multi_dim),
-      faulty_links(faulty_links) {   // initialize faulty links
+      BasicTopology(npus_count, npus_count + 1, bandwidth, latency, is_multi_dim) {
     assert(npus_count > 0);
     assert(bandwidth > 0);
     assert(latency >= 0);
 
+    // faulty links derate the links connected below
+    set_fault_map(std::move(fault_map));
+
     Switch::basic_topology_type = TopologyBuildingBlock::Switch;
 
     // set switch id
@@ -29,10 +31,10 @@ Switch::Switch(const int npus_count,
     // connect npus and switches, the link should be bidirectional
     if (!is_multi_dim) {
         for (auto i = 0; i < npus_count; i++) {
-            if(fault_derate(i, i+1) != 0)
-                connect(i, i+1, bandwidth * fault_derate(i, i+1), latency, bidirectional);
+            if(fault_derate(i, switch_id) != 0)
+                connect(i, switch_id, bandwidth * fault_derate(i, switch_id), latency, bidirectional);
             else
-                connect(i, i+1, bandwidth, latency, bidirectional);  //might be removable
+                connect(i, switch_id, bandwidth, latency, bidirectional);  //might be removable
         }
     }
 }
@@ -62,18 +64,3 @@ std::vector<ConnectionPolicy> Switch::get_connection_policies() const noexcept {
 
     return policies;
 }
-
-double Switch::fault_derate(int src, int dst) const{
-    for (const auto& link : faulty_links) {
-        int a = std::get<0>(link);
-        int b = std::get<1>(link);
-        double health = std::get<2>(link);
-
-        // If this link exists and health != 0.0 → it's soft fault
-        if ((a == src && b == dst) || (a == dst && b == src)) {
-            return health;
-        }
-    }
-    return 1.0;
-}
-
@@ -15,17 +15,18 @@ Torus2D::Torus2D(const int npus_count,
                  const Latency latency,
                  const bool bidirectional,
                  const bool is_multi_dim,
-                 const std::vector<std::tuple<int, int, double>>& faulty_links) noexcept
+                 std::shared_ptr<const FaultMap> fault_map) noexcept
     : bidirectional(bidirectional),
-      BasicTopology(npus_count, npus_count, bandwidth, latency, is_multi_dim), faulty_links(faulty_links) {
+      BasicTopology(npus_count, npus_count, bandwidth, latency, is_multi_dim) {
     assert(npus_count > 0);
     assert(bandwidth > 0);
     assert(latency >= 0);
 
+    // faulty links derate the links connected below
+    set_fault_map(std::move(fault_map));
 
     Torus2D::basic_topology_type = TopologyBuildingBlock::Torus2D;
 
-    //this->faulty_links = {};
 
     if (!is_multi_dim) {
         // Assume npus_count forms a perfect square
@@ -174,6 +175,22 @@ Route Torus2D::route(DeviceId src, DeviceId dest) const noexcept {
 
 
 Route Torus2D::route(DeviceId src, DeviceId dest) const noexcept {
+    return dimension_order_route(src, dest, /* x_first = */ true);
+}
+
+std::vector<Route> Torus2D::routes(const DeviceId src, const DeviceId dest) const noexcept {
+    const int dim = static_cast<int>(std::sqrt(npus_count));
+
+    // the XY and YX routes only differ if src and dest differ in both X and Y
+    if (src % dim == dest % dim || src / dim == dest / dim) {
+        return {route(src, dest)};
+    }
+
+    return {dimension_order_route(src, dest, /* x_first = */ true),
+            dimension_order_route(src, dest, /* x_first = */ false)};
+}
+
+Route Torus2D::dimension_order_route(const DeviceId src, const DeviceId dest, const bool x_first) const noexcept {
     Route route;
     const int dim = static_cast<int>(std::sqrt(npus_count));
     int sx = src % dim, sy = src / dim;
@@ -185,9 +202,9 @@ Route Torus2D::route(DeviceId src, DeviceId dest) const noexcept {
     while (cur != dest) {
         int cx = cur % dim, cy = cur / dim;
 
-        // Try X direction first
+        // Try X direction first, unless Y goes first and is left to traverse
         int step_x = 0, step_y = 0;
-        if (cx != dx) {
+        if (cx != dx && (x_first || cy == dy)) {
             int diff_x = (dx - cx + dim) % dim;
             step_x = (diff_x > dim / 2) ? -1 : +1;
         } else if (cy != dy) {
@@ -281,22 +298,3 @@ bool Torus2D::is_down(int src, int dst) const {
     return false;
 }
 */
-
-double Torus2D::fault_derate(int src, int dst) const{
-    for (const auto& link : faulty_links) {
-        int a = std::get<0>(link);
-        int b = std::get<1>(link);
-        double health = std::get<2>(link);
-
-        // If this link exists and health != 0.0 → it's soft fault
-        if ((a == src && b == dst) || (a == dst && b == src)) {
-            return health;
-        }
-    }
-    return 1.0;
-}
-
-
-
-    
-
@@ -4,20 +4,29 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "congestion_aware/MultiDimTopology.h"
+#include "congestion_aware/Bus.h"
+#include "congestion_aware/FaultMap.h"
 #include "congestion_aware/Helper.h"
+#include "congestion_aware/Link.h"
+#include "congestion_aware/LinkTable.h"
 
 #include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <functional>
 #include <iostream>
+#include <limits>
 #include <numeric>
+#include <thread>
+#include <tuple>
 #include <utility>
 
 namespace NetworkAnalyticalCongestionAware {
 
-MultiDimTopology::MultiDimTopology(const std::vector<std::tuple<int, int, double>> faulty_links, const std::vector<int> non_recursive_topo) noexcept 
-: Topology() , faulty_links{faulty_links}, m_non_recursive_topo{non_recursive_topo}{
+MultiDimTopology::MultiDimTopology(std::shared_ptr<const FaultMap> fault_map, const std::vector<int> non_recursive_topo) noexcept
+    : Topology(), m_non_recursive_topo{non_recursive_topo} {
+    set_fault_map(std::move(fault_map));
+
     // initialize values
     m_topology_per_dim.clear();
     npus_count_per_dim = {};
@@ -53,7 +62,113 @@ Route MultiDimTopology::route(DeviceId src, DeviceId dest) const noexcept {
     }
 }
 
+std::vector<Route> MultiDimTopology::routes(const DeviceId src, const DeviceId dest) const noexcept {
+    // assert npus are in valid range
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+
+    auto all_routes = std::vector<Route>{route(src, dest)};
+    if (src == dest) {
+        return all_routes;
+    }
+
+    // a candidate is only kept if no route taken so far crosses the same devices
+    const auto add_route = [&all_routes](Route candidate_route) {
+        if (candidate_route.empty()) {
+            return;
+        }
+        for (const auto& taken_route : all_routes) {
+            if (std::equal(taken_route.begin(), taken_route.end(), candidate_route.begin(), candidate_route.end(),
+                           [](const auto& lhs, const auto& rhs) { return lhs->get_id() == rhs->get_id(); })) {
+                return;
+            }
+        }
+        all_routes.push_back(std::move(candidate_route));
+    };
+
+    // one route per each agent of the clusters
+    if (m_cluster) {
+        for (auto agent = 0; agent < m_cluster_agents_count; agent++) {
+            add_route(routeClusterThroughAgent(src, dest, agent));
+        }
+        return all_routes;
+    }
+
+    // most alternatives offered by a dimension src and dest differ in
+    const auto src_address = translate_address(src);
+    const auto dest_address = translate_address(dest);
+    auto alternatives_count = size_t{1};
+    for (auto dim = 0; dim < dims_count; dim++) {
+        if (src_address.at(dim) != dest_address.at(dim)) {
+            const auto dim_routes = m_topology_per_dim.at(dim)->routes(src_address.at(dim), dest_address.at(dim));
+            alternatives_count = std::max(alternatives_count, dim_routes.size());
+        }
+    }
+
+    // traverse each dimension src and dest differ in first, then the others from the highest to the lowest,
+    // taking every alternative route of the dimensions in turn
+    std::vector<int> routing_dimensions;
+    for (int dim_to_transfer = dims_count - 1; dim_to_transfer >= 0; dim_to_transfer--) {
+        routing_dimensions.push_back(dim_to_transfer);
+    }
+    for (auto i = size_t{0}; i < routing_dimensions.size(); i++) {
+        const auto first_dim = routing_dimensions[i];
+        if (src_address.at(first_dim) == dest_address.at(first_dim)) {
+            continue;
+        }
+
+        auto candidate_dimensions = routing_dimensions;
+        std::rotate(candidate_dimensions.begin(), candidate_dimensions.begin() + i,
+                    candidate_dimensions.begin() + i + 1);
+        for (auto alternative = size_t{0}; alternative < alternatives_count; alternative++) {
+            add_route(routeHelper(src, dest, candidate_dimensions, alternative));
+        }
+    }
+
+    return all_routes;
+}
+
 Route MultiDimTopology::routeCluster(DeviceId src, DeviceId dest) const noexcept {
+    if (m_cluster_agents_count == 1) {
+        return routeClusterThroughAgent(src, dest, 0);
+    }
+
+    // spread the (src, dest) pairs over the agents, which also breaks the ties of LeastLoaded
+    const auto pair_key = (static_cast<uint64_t>(src) << 32) | static_cast<uint32_t>(dest);
+    const auto hashed_agent = static_cast<int>(scramble(pair_key) % m_cluster_agents_count);
+    if (m_cluster_agent_selection == ClusterAgentSelection::Hash) {
+        return routeClusterThroughAgent(src, dest, hashed_agent);
+    }
+
+    // otherwise, take the route with the least work queued on its links, in ns
+    auto best_route = Route();
+    auto best_load = std::numeric_limits<double>::infinity();
+    for (auto i = 0; i < m_cluster_agents_count; i++) {
+        auto candidate_route = routeClusterThroughAgent(src, dest, (hashed_agent + i) % m_cluster_agents_count);
+        auto load = 0.0;
+        for (auto current = candidate_route.begin(), next = std::next(candidate_route.begin());
+             next != candidate_route.end(); current++, next++) {
+            const auto link_id = (*current)->get_link_id((*next)->get_id());
+            load += static_cast<double>(link_table->get_occupancy(link_id)) / link_table->get_bandwidth_Bpns(link_id);
+        }
+
+        if (load < best_load) {
+            best_load = load;
+            best_route = std::move(candidate_route);
+
+            // an idle route can't be beaten
+            if (best_load == 0) {
+                break;
+            }
+        }
+    }
+
+    return best_route;
+}
+
+Route MultiDimTopology::routeClusterThroughAgent(DeviceId src, DeviceId dest, const int agent) const noexcept {
+    assert(0 <= agent && agent < m_cluster_agents_count);
+
     // build up dimension
     std::vector<int> normal_routing_dimensions; // right to left, top to bottom
     for (int dim_to_transfer = dims_count - 1; dim_to_transfer >= 0; dim_to_transfer--) {
@@ -66,60 +181,58 @@ Route MultiDimTopology::routeCluster(DeviceId src, DeviceId dest) const noexcept
     }
 
     MultiDimAddress src_addr = translate_address(src);
-    // address [0 ... 0 Q ... Z] when src is [A ... P Q ... Z]
+    // the agent of the first cluster, i.e., address [a ... p 0 ... 0]
+    const auto agent_addr = translate_address(agent);
+
+    // address [a ... p Q ... Z] when src is [A ... P Q ... Z]
     //std::vector<int> non_recursive_topo = {0, 0, 1};
     MultiDimAddress src_cluster_agent_addr{src_addr};
-    for (int dim = 0; dim < dims_count; dim++)
+    const auto first_non_recursive_dim = get_first_non_recursive_dim();
+    for (int dim = 0; dim < first_non_recursive_dim; dim++)
     {
-        if (m_non_recursive_topo.at(dim) == 0) {
-            src_cluster_agent_addr.at(dim) = 0;
-        }
-        else {
-            break;
-        }
+        src_cluster_agent_addr.at(dim) = agent_addr.at(dim);
     }
     DeviceId src_cluster_agent_id = translate_address_back(src_cluster_agent_addr);
 
-    // address [0 ... 0 Z] when src is [A ... P Q ... Z]
-    auto top_cluster_agent_addr = MultiDimAddress();
-    for (int dim = 0; dim < dims_count; dim++)
-    {
-        top_cluster_agent_addr.push_back(0);
-    }
+    // address [a ... p 0 ... 0 Z] when src is [A ... P Q ... Z]
+    auto top_cluster_agent_addr = agent_addr;
     assert(top_cluster_agent_addr.size() == dims_count);
     top_cluster_agent_addr.at(dims_count - 1) = src_addr.at(dims_count - 1);
     DeviceId top_cluster_agent_id = translate_address_back(top_cluster_agent_addr);
-   
 
-    // do two routing and connect them together
-    Route route_to_agent, cluster_route, agent_to_dest;
-    if (src != src_cluster_agent_id) {
-        route_to_agent = routeHelper(src, src_cluster_agent_id, normal_routing_dimensions);
-    }
-    if (src_cluster_agent_id != top_cluster_agent_id) {
-        cluster_route = routeHelper(src_cluster_agent_id, top_cluster_agent_id, reverse_routing_dimensions);
-    }
-    if (top_cluster_agent_id != dest) {
-        agent_to_dest = routeHelper(top_cluster_agent_id, dest, normal_routing_dimensions);
-    }
-
-    // concatenate route while removing duplicate
-    auto final_route = route_to_agent;
-    if (!cluster_route.empty())
+    // address [a ... p Q' ... Z'] when dest is [A' ... P' Q' ... Z']
+    MultiDimAddress dest_cluster_agent_addr = translate_address(dest);
+    for (int dim = 0; dim < first_non_recursive_dim; dim++)
     {
-        if (!final_route.empty())
-        {
-            cluster_route.pop_front();
-        }
-        final_route.splice(final_route.end(), cluster_route);
+        dest_cluster_agent_addr.at(dim) = agent_addr.at(dim);
     }
-    if (!agent_to_dest.empty())
-    {
+    DeviceId dest_cluster_agent_id = translate_address_back(dest_cluster_agent_addr);
+
+    // the dimensions linking the agents only link those of the blocks below them, so the agents are
+    // traversed in a fixed order, while the dimensions within a cluster may be reordered if adaptive
+    const auto legs = std::vector<std::tuple<DeviceId, DeviceId, bool>>{
+        {src, src_cluster_agent_id, true},
+        {src_cluster_agent_id, top_cluster_agent_id, false},
+        {top_cluster_agent_id, dest_cluster_agent_id, false},
+        {dest_cluster_agent_id, dest, true}};
+
+    // route each leg and connect them together while removing duplicates
+    auto final_route = Route();
+    for (auto i = size_t{0}; i < legs.size(); i++) {
+        const auto leg_src = std::get<0>(legs[i]);
+        const auto leg_dest = std::get<1>(legs[i]);
+        if (leg_src == leg_dest) {
+            continue;
+        }
+
+        const auto& routing_dimensions = (i == 1) ? reverse_routing_dimensions : normal_routing_dimensions;
+        auto leg_route = std::get<2>(legs[i]) ? routeInOrder(leg_src, leg_dest, routing_dimensions)
+                                              : routeHelper(leg_src, leg_dest, routing_dimensions);
         if (!final_route.empty())
         {
-            agent_to_dest.pop_front();
+            leg_route.pop_front();
         }
-        final_route.splice(final_route.end(), agent_to_dest);
+        final_route.splice(final_route.end(), leg_route);
     }
     return final_route;
 }
@@ -131,11 +244,139 @@ Route MultiDimTopology::routeNormal(DeviceId src, DeviceId dest) const noexcept
     }
 
     // call
+    return routeInOrder(src, dest, routing_dimensions);
+}
+
+Route MultiDimTopology::routeInOrder(DeviceId src,
+                                     DeviceId dest,
+                                     const std::vector<int>& routing_dimensions) const noexcept {
+    // pick the dimension to traverse first by the load of the links if adaptive
+    if (m_adaptive_routing) {
+        return routeAdaptive(src, dest, routing_dimensions);
+    }
+
     return routeHelper(src, dest, routing_dimensions);
 }
 
+Route MultiDimTopology::routeAdaptive(DeviceId src,
+                                      DeviceId dest,
+                                      const std::vector<int>& routing_dimensions) const noexcept {
+    const auto src_address = translate_address(src);
+    const auto dest_address = translate_address(dest);
+
+    auto best_route = Route();
+    auto best_load = std::numeric_limits<double>::infinity();
+    for (auto i = size_t{0}; i < routing_dimensions.size(); i++) {
+        const auto first_dim = routing_dimensions[i];
+        if (src_address.at(first_dim) == dest_address.at(first_dim)) {
+            continue;
+        }
+
+        // traverse the candidate dimension first, then the others in the static order
+        auto candidate_dimensions = routing_dimensions;
+        std::rotate(candidate_dimensions.begin(), candidate_dimensions.begin() + i,
+                    candidate_dimensions.begin() + i + 1);
+        auto candidate_route = routeHelper(src, dest, candidate_dimensions);
+
+        // work queued on the first link of the candidate, in ns
+        const auto first_link_id = device(src)->get_link_id((*std::next(candidate_route.begin()))->get_id());
+        const auto load = static_cast<double>(link_table->get_occupancy(first_link_id)) /
+                          link_table->get_bandwidth_Bpns(first_link_id);
+        if (load < best_load) {
+            best_load = load;
+            best_route = std::move(candidate_route);
+        }
+
+        // an idle first link can't be beaten
+        if (best_load == 0) {
+            break;
+        }
+    }
+
+    // src and dest are the same NPU
+    if (best_route.empty()) {
+        return routeHelper(src, dest, routing_dimensions);
+    }
+
+    return best_route;
+}
+
+void MultiDimTopology::set_adaptive_routing(const bool adaptive_routing) noexcept {
+    m_adaptive_routing = adaptive_routing;
+}
+
+void MultiDimTopology::set_cluster_agents(const int agents_count, const ClusterAgentSelection selection) noexcept {
+    assert(agents_count > 0);
+    assert(link_table->get_links_count() == 0);
+
+    m_cluster_agents_count = agents_count;
+    m_cluster_agent_selection = selection;
+
+    // agents are NPUs of the cluster
+    if (m_cluster) {
+        const auto npus_per_cluster = static_cast<int>(m_address_translator.get_stride(get_first_non_recursive_dim()));
+        if (agents_count > npus_per_cluster) {
+            std::cerr << "[Warning] (network/analytical/congestion_aware) "
+                      << "cluster_agents (" << agents_count << ") capped at the " << npus_per_cluster
+                      << " NPUs per cluster" << std::endl;
+            m_cluster_agents_count = npus_per_cluster;
+        }
+    } else if (agents_count > 1) {
+        std::cerr << "[Warning] (network/analytical/congestion_aware) "
+                  << "cluster_agents ignored, no dimension is non-recursive" << std::endl;
+    }
+}
+
+int MultiDimTopology::get_first_non_recursive_dim() const noexcept {
+    assert(m_cluster);
+
+    return static_cast<int>(std::find(m_non_recursive_topo.begin(), m_non_recursive_topo.end(), 1) -
+                            m_non_recursive_topo.begin());
+}
+
+void MultiDimTopology::dump_dim_load_csv(std::ostream& os, const EventTime elapsed_time) const noexcept {
+    assert(m_first_link_per_dim.size() == dims_count + 1);
+
+    // header
+    os << "dim,links,bytes_sent,chunks_sent,busy_time_ns,queueing_time_ns,avg_utilization,max_utilization"
+       << std::endl;
+
+    // one row per dimension
+    for (auto dim = 0; dim < dims_count; dim++) {
+        const auto first_link_id = m_first_link_per_dim[dim];
+        const auto end_link_id = m_first_link_per_dim[dim + 1];
+
+        auto dim_load = LinkStats();
+        auto max_busy_time = EventTime{0};
+        for (auto link_id = first_link_id; link_id < end_link_id; link_id++) {
+            const auto& link_stats = std::as_const(*link_table).get_link_stats(link_id);
+            dim_load.bytes_sent += link_stats.bytes_sent;
+            dim_load.chunks_sent += link_stats.chunks_sent;
+            dim_load.busy_time += link_stats.busy_time;
+            dim_load.queueing_time += link_stats.queueing_time;
+            max_busy_time = std::max(max_busy_time, link_stats.busy_time);
+        }
+
+        // utilization of the links, none if no time has elapsed yet
+        const auto links_count = end_link_id - first_link_id;
+        const auto avg_utilization = (elapsed_time == 0 || links_count == 0)
+                                         ? 0.0
+                                         : static_cast<double>(dim_load.busy_time) /
+                                               (static_cast<double>(elapsed_time) * links_count);
+        const auto max_utilization =
+            (elapsed_time == 0) ? 0.0 : static_cast<double>(max_busy_time) / static_cast<double>(elapsed_time);
+
+        os << dim << "," << links_count << "," << dim_load.bytes_sent << "," << dim_load.chunks_sent << ","
+           << dim_load.busy_time << "," << dim_load.queueing_time << "," << avg_utilization << ","
+           << max_utilization << std::endl;
+    }
+}
+
 
-Route MultiDimTopology::routeHelper(DeviceId src, DeviceId dest, const std::vector<int>& routing_dimensions) const noexcept {
+Route MultiDimTopology::routeHelper(DeviceId src,
+                                    DeviceId dest,
+                                    const std::vector<int>& routing_dimensions,
+                                    const size_t alternative) const noexcept {
     //std::cout << "[DEBUG] Beginning of the function - source and destination: " << src << dest << std::endl;
 
     // // assert npus are in valid range
@@ -150,7 +391,6 @@ Route MultiDimTopology::routeHelper(DeviceId src, DeviceId dest, const std::vect
     // // construct empty route
     auto route = Route();
     MultiDimAddress last_dest_address{src_address};
-    DeviceId last_dest{src};
 
     for (const auto dim_to_transfer : routing_dimensions) {
         // if index in the current dimension is the same, skip
@@ -162,9 +402,16 @@ Route MultiDimTopology::routeHelper(DeviceId src, DeviceId dest, const std::vect
 
             // create internal route from current dimension
             auto* const topology = m_topology_per_dim.at(dim_to_transfer).get();
-            auto internal_route =
-                topology->route(last_dest_address.at(dim_to_transfer),
-                                next_dim_dest_address.at(dim_to_transfer));  // route on that dimension
+            auto internal_route = Route();
+            if (alternative == 0) {
+                internal_route = topology->route(last_dest_address.at(dim_to_transfer),
+                                                 next_dim_dest_address.at(dim_to_transfer));  // route on that dimension
+            } else {
+                // the given alternative route on that dimension, or its last one if it has fewer
+                auto internal_routes = topology->routes(last_dest_address.at(dim_to_transfer),
+                                                        next_dim_dest_address.at(dim_to_transfer));
+                internal_route = std::move(internal_routes[std::min(alternative, internal_routes.size() - 1)]);
+            }
             auto route_in_dim = Route();
 
             // translate internal route device id to global device IDs and push to route in this dimension
@@ -192,106 +439,41 @@ Route MultiDimTopology::routeHelper(DeviceId src, DeviceId dest, const std::vect
                 assert(0 <= global_device_id && global_device_id < devices_count);
 
                 // push to route in this dimension
-                route_in_dim.push_back(devices.at(global_device_id));
-            }
-
-            // we have finished the route_in_dim
-            std::vector<DeviceId> route_id;
-            for (const auto device : route_in_dim) {
-                route_id.push_back(device->get_id());
-            }
-            //std::cout << "[DEBUG] Route in dimension before fault check: ";
-            //for (auto id : route_id) std::cout << id << " ";
-            //std::cout << std::endl;
-
-            bool meet_fault = false;
-            for (int i = 0; i < (int)route_id.size() - 1; i++) {
-                double derate = fault_derate(route_id.at(i), route_id.at(i + 1));
-                //std::cout << "[DEBUG] Checking link (" << route_id.at(i)
-                //        << " -> " << route_id.at(i + 1)
-                //        << "), derate = " << derate << std::endl;
-
-                if (derate == 0.0) {
-                    //std::cout << "[DEBUG] Fault detected between "
-                    //        << route_id.at(i) << " and " << route_id.at(i + 1) << std::endl;
-
-                    auto begin_itr = route_in_dim.begin();
-                    //auto end_itr = route_in_dim.begin();
-                    std::advance(begin_itr, i+1);
-                    //std::advance(end_itr, route_in_dim.size()-1);
-                    route_in_dim.erase(begin_itr, route_in_dim.end());
-                    route_id.erase(route_id.begin()+i+1, route_id.end());
-                    meet_fault = true;
-
-                    //std::cout << "[DEBUG] Truncated route_in_dim after fault at position " << i
-                    //        << ". Remaining: ";
-                    //for (auto d : route_in_dim)
-                    //    std::cout << d->get_id() << " ";
-                    //std::cout << std::endl;
-
-                    break;
-                }
+                route_in_dim.push_back(device(global_device_id));
             }
 
             // Remove duplicate at the junction of segments
             if (!route.empty() && !route_in_dim.empty()) {
-                //std::cout << "[DEBUG] Removing duplicate junction node "
-                //        << route_in_dim.front()->get_id() << std::endl;
                 route_in_dim.pop_front();
             }
 
             // Append to total routing
-            if (!route_in_dim.empty()) {
-                //std::cout << "[DEBUG] Appending route_in_dim to main route. route_in_dim size = "
-                //        << route_in_dim.size() << std::endl;
-            }
             route.splice(route.end(), route_in_dim);
 
-            if (meet_fault) {
-                int last_id = route_id.back(); // global id before fault
-                //std::cout << "[DEBUG] Fault met. last_id = " << last_id << std::endl;
-
-                const auto last_device_addr = translate_address(last_id);
-                //std::cout << "[DEBUG] last_device_addr: ";
-                //for (auto v : last_device_addr) std::cout << v << " ";
-                //std::cout << std::endl;
-
-                auto new_dest_addr{last_device_addr};
-                int next_dim = (dim_to_transfer + 1) % new_dest_addr.size();
-                new_dest_addr.at(next_dim) =
-                    (new_dest_addr.at(next_dim) + 1) % npus_count_per_dim.at(next_dim);
-
-                //std::cout << "[DEBUG] Adjusted new_dest_addr after fault: ";
-                //for (auto v : new_dest_addr) std::cout << v << " ";
-                //std::cout << std::endl;
-                
-                //std::cout << "[DEBUG] destination value: " << dest << std::endl;
-                auto new_dest = translate_address_back(new_dest_addr);
-                //std::cout << "[DEBUG] New destination after fault reroute: " << new_dest << std::endl;
-
-                // use reverse order
-                std::vector<int> new_routing_dimension{routing_dimensions};
-                int swapped_dim = (dim_to_transfer == 0) ? new_routing_dimension.size() - 1 : dim_to_transfer - 1;
-                std::swap(new_routing_dimension.at(dim_to_transfer), new_routing_dimension.at(swapped_dim));
-
-                // find new route
-                auto new_route = this->routeHelper(new_dest, dest, new_routing_dimension);
-                //std::cout << "[DEBUG] Reroute path after fault: ";
-                //for (auto d : new_route)
-                //    std::cout << d->get_id() << " ";
-                //std::cout << std::endl;
-
-                route.splice(route.end(), new_route); // apppend new path
-                return route;
-            }
-
             // update last dest
             last_dest_address = next_dim_dest_address;
-            last_dest = translate_address_back(last_dest_address);
         }
     }
 
     assert(route.front()->get_id() == src && route.back()->get_id() == dest);
+
+    // healthy links, nothing to check
+    if (!has_faults()) {
+        return route;
+    }
+
+    // a route crossing a faulty link is replaced by the fastest one around the faults, if any is left,
+    // as long as it's faster: always around a dead link, and only if derating makes the route slower otherwise
+    for (auto it = route.begin(); std::next(it) != route.end(); it++) {
+        if (fault_derate((*it)->get_id(), (*std::next(it))->get_id()) < 1) {
+            auto fault_aware_route = reroute(src, dest);
+            if (!fault_aware_route.empty() && route_time_per_byte(fault_aware_route) < route_time_per_byte(route)) {
+                return fault_aware_route;
+            }
+            break;
+        }
+    }
+
     return route;
 }
 
@@ -314,6 +496,13 @@ void MultiDimTopology::append_dimension(std::unique_ptr<BasicTopology> topology)
     assert(topology->get_basic_topology_type() != TopologyBuildingBlock::Undefined);
     m_topology_per_dim.push_back(std::move(topology));
     this->npus_count_per_dim.push_back(topology_size);
+    m_address_translator.append_dimension(topology_size);
+}
+
+void MultiDimTopology::set_input_buffer_size_per_dim(std::vector<ChunkSize> input_buffer_size_per_dim) noexcept {
+    assert(input_buffer_size_per_dim.empty() || input_buffer_size_per_dim.size() == dims_count);
+
+    m_input_buffer_size_per_dim = std::move(input_buffer_size_per_dim);
 }
 
 void MultiDimTopology::make_connections() noexcept {
@@ -323,87 +512,687 @@ void MultiDimTopology::make_connections() noexcept {
         std::exit(-1);
     }
 
+    // an implicit topology only numbers its links, each device attaching its ports once materialized
+    if (m_implicit) {
+        make_implicit_connections();
+        return;
+    }
+
+    m_first_link_per_dim.assign(dims_count + 1, 0);
     for (int dim = 0; dim < dims_count; dim++) {
         // intra-dim connections
         const auto topology = m_topology_per_dim.at(dim).get();
-        const auto policies = topology->get_connection_policies();
-        assert(policies.size() != 0);
-        bool non_recursive = false;
-        std::vector<std::pair<MultiDimAddress, MultiDimAddress>> address_pairs;
-
-        for (const auto& policy : policies) {
-            if (!non_recursive) {
-                address_pairs = generateAddressPairs(npus_count_per_dim, policy, dim);
+        m_first_link_per_dim[dim] = link_table->get_links_count();
+
+        // a Bus dimension shares one link per each group instead of connecting pairs
+        if (topology->get_basic_topology_type() == TopologyBuildingBlock::Bus) {
+            make_bus_connections(dim);
+            continue;
+        }
+
+        make_dim_connections(dim);
+    }
+    m_first_link_per_dim[dims_count] = link_table->get_links_count();
+}
+
+bool MultiDimTopology::load_connections(const TopologyCache& topology_cache) noexcept {
+    assert(!m_implicit);
+    assert(link_table->get_links_count() == 0);
+
+    // the compiled topology must have the same shape
+    const auto& compiled = topology_cache.get_compiled_topology();
+    if (compiled.dims_count != dims_count || compiled.devices_count != devices.size() ||
+        compiled.first_link_per_dim[dims_count] != compiled.links_count) {
+        return false;
+    }
+
+    // create the links, numbered as they were compiled
+    [[maybe_unused]] const auto first_link_id =
+        link_table->add_compiled_links(compiled.links_count, compiled.link_srcs, compiled.link_dests,
+                                       compiled.link_bandwidths_Bpns, compiled.link_latencies);
+    assert(first_link_id == 0);
+    m_first_link_per_dim.assign(compiled.first_link_per_dim, compiled.first_link_per_dim + dims_count + 1);
+    setup_links_per_dim();
+
+    // attach the links to their src devices, the ports of each device being compiled in order
+    parallel_for(compiled.devices_count, [&](const int64_t begin, const int64_t end, int) {
+        for (auto device_id = begin; device_id < end; device_id++) {
+            const auto first_port = compiled.port_offsets[device_id];
+            const auto end_port = compiled.port_offsets[device_id + 1];
+            auto& device = *devices[device_id];
+            device.reserve_ports(static_cast<int>(end_port - first_port));
+            for (auto port = first_port; port < end_port; port++) {
+                device.attach(compiled.port_dests[port], compiled.port_links[port]);
+            }
+        }
+    });
+
+    return true;
+}
+
+bool MultiDimTopology::save_connections(const std::string& path, const uint64_t topology_hash) const noexcept {
+    assert(!m_implicit);
+    assert(m_first_link_per_dim.size() == dims_count + 1);
+
+    // gather the links
+    const auto links_count = link_table->get_links_count();
+    auto link_srcs = std::vector<DeviceId>(links_count);
+    auto link_dests = std::vector<DeviceId>(links_count);
+    auto link_bandwidths_Bpns = std::vector<Bandwidth>(links_count);
+    auto link_latencies = std::vector<Latency>(links_count);
+    for (auto link_id = LinkId{0}; link_id < links_count; link_id++) {
+        std::tie(link_srcs[link_id], link_dests[link_id]) = link_table->get_endpoints(link_id);
+        link_bandwidths_Bpns[link_id] = link_table->get_bandwidth_Bpns(link_id);
+        link_latencies[link_id] = link_table->get_latency(link_id);
+    }
+
+    // gather the ports of each device, one device after the other
+    auto port_offsets = std::vector<int64_t>(devices.size() + 1, 0);
+    for (auto device_id = size_t{0}; device_id < devices.size(); device_id++) {
+        port_offsets[device_id + 1] = port_offsets[device_id] + devices[device_id]->get_ports_count();
+    }
+    auto port_dests = std::vector<DeviceId>();
+    auto port_links = std::vector<LinkId>();
+    port_dests.reserve(port_offsets.back());
+    port_links.reserve(port_offsets.back());
+    for (const auto& device : devices) {
+        port_dests.insert(port_dests.end(), device->get_port_dests().begin(), device->get_port_dests().end());
+        port_links.insert(port_links.end(), device->get_port_links().begin(), device->get_port_links().end());
+    }
+
+    auto compiled = TopologyCache::CompiledTopology();
+    compiled.dims_count = dims_count;
+    compiled.devices_count = static_cast<int>(devices.size());
+    compiled.links_count = links_count;
+    compiled.ports_count = port_offsets.back();
+    compiled.first_link_per_dim = m_first_link_per_dim.data();
+    compiled.link_srcs = link_srcs.data();
+    compiled.link_dests = link_dests.data();
+    compiled.link_bandwidths_Bpns = link_bandwidths_Bpns.data();
+    compiled.link_latencies = link_latencies.data();
+    compiled.port_offsets = port_offsets.data();
+    compiled.port_dests = port_dests.data();
+    compiled.port_links = port_links.data();
+
+    return TopologyCache::save(path, topology_hash, compiled);
+}
+
+bool MultiDimTopology::is_agents_only_dim(const int dim) const noexcept {
+    assert(0 <= dim && dim < dims_count);
+
+    return m_cluster && m_non_recursive_topo.at(dim) == 1;
+}
+
+int64_t MultiDimTopology::get_combinations_count(const int dim) const noexcept {
+    assert(0 <= dim && dim < dims_count);
+
+    // the combinations of the other dimensions,
+    // the lower ones only taking the agent offsets if only cluster agents are connected
+    auto combinations_count = static_cast<int64_t>(npus_count / npus_count_per_dim[dim]);
+    if (is_agents_only_dim(dim)) {
+        combinations_count = combinations_count / m_address_translator.get_stride(dim) * m_cluster_agents_count;
+    }
+
+    return combinations_count;
+}
+
+template <typename Visitor>
+void MultiDimTopology::for_each_connection(const int dim,
+                                           const ConnectionPolicy& policy,
+                                           Visitor&& visit) const noexcept {
+    assert(0 <= dim && dim < dims_count);
+
+    // NPU id stride of each dimension, and switch id stride of each dimension above dim
+    auto npu_strides = std::vector<DeviceId>(dims_count, 1);
+    auto switch_strides = std::vector<DeviceId>(dims_count, 0);
+    for (auto i = 1; i < dims_count; i++) {
+        npu_strides[i] = npu_strides[i - 1] * npus_count_per_dim[i - 1];
+    }
+    for (auto i = dim + 1; i < dims_count; i++) {
+        switch_strides[i] = (i == dim + 1) ? 1 : switch_strides[i - 1] * npus_count_per_dim[i - 1];
+    }
+
+    // an address equal to the npus_count of dim denotes the switch of the dimension
+    const auto npus_count_in_dim = npus_count_per_dim[dim];
+    const auto first_switch_id = (policy.src == npus_count_in_dim || policy.dst == npus_count_in_dim)
+                                     ? m_switch_translation_unit.value().get_first_switch_id(dim)
+                                     : -1;
+    const auto endpoint_id = [&](const DeviceId address_in_dim, const DeviceId npu_base, const DeviceId switch_offset) {
+        return (address_in_dim < npus_count_in_dim) ? npu_base + address_in_dim * npu_strides[dim]
+                                                    : first_switch_id + switch_offset;
+    };
+
+    // odometer over the addresses of the other dimensions, the last dimension changing fastest,
+    // the lower dimensions only taking the agent offsets, changing slowest, if only cluster agents are connected
+    const auto agents_only = is_agents_only_dim(dim);
+    const auto first_free_dim = agents_only ? dim + 1 : 0;
+    const auto agents_count = agents_only ? m_cluster_agents_count : 1;
+    auto agent = 0;
+    auto address = std::vector<int>(dims_count, 0);
+    auto npu_base = DeviceId{0};
+    auto switch_offset = DeviceId{0};
+    while (true) {
+        visit(endpoint_id(policy.src, npu_base, switch_offset), endpoint_id(policy.dst, npu_base, switch_offset));
+
+        // advance to the next address
+        auto i = dims_count - 1;
+        for (; i >= first_free_dim; i--) {
+            if (i == dim) {
+                continue;
             }
 
-            // --- RECURSIVE MODE: only first nodes of lower dimensions ---
-            else {
-                address_pairs = generateAddressPairs_only_first_nodes(npus_count_per_dim, policy, dim);
+            if (address[i] + 1 < npus_count_per_dim[i]) {
+                address[i]++;
+                npu_base += npu_strides[i];
+                switch_offset += switch_strides[i];
+                break;
             }
-            //std::vector<std::pair<MultiDimAddress, MultiDimAddress>> address_pairs =
-            //    generateAddressPairs(npus_count_per_dim, policy, dim);
-            for (const auto& address_pair : address_pairs) {
-                // translate to device ID, depending on switch or not
-
-                const auto src = is_switch(address_pair.first)
-                                     ? m_switch_translation_unit.value().translate_address_to_id(address_pair.first)
-                                     : translate_address_back(address_pair.first);
-                const auto dest = is_switch(address_pair.second)
-                                      ? m_switch_translation_unit.value().translate_address_to_id(address_pair.second)
-                                      : translate_address_back(address_pair.second);
-                assert(0 <= src && src < devices_count);
-                assert(0 <= dest && dest < devices_count);
-                
-
-                // make connection
-                const auto bandwidth = bandwidth_per_dim.at(dim);
-                const auto latency = topology->get_link_latency();
-                if(fault_derate(src, dest) != 0)
-                    connect(src, dest, bandwidth * fault_derate(src, dest), latency, false);
-                else
-                    connect(src, dest, bandwidth, latency, false);  //might be removable
+
+            // wrap around, and carry to the next dimension
+            npu_base -= address[i] * npu_strides[i];
+            switch_offset -= address[i] * switch_strides[i];
+            address[i] = 0;
+        }
+
+        // every address visited, for each agent
+        if (i < first_free_dim) {
+            if (++agent == agents_count) {
+                return;
             }
+            npu_base++;
         }
     }
 }
 
-void MultiDimTopology::initialize_all_devices() noexcept {
-    // instantiate all devices
-    const auto total_num_devices = get_total_num_devices();
+template <typename Task>
+void MultiDimTopology::parallel_for(const int64_t count, Task&& task) const noexcept {
+    assert(count >= 0);
 
-    for (auto i = 0; i < total_num_devices; i++) {
-        devices.push_back(std::make_shared<Device>(i));
+    // small workloads are not worth spawning threads
+    const auto threads_count = static_cast<int>(std::min<int64_t>(m_construction_threads, count));
+    if (threads_count <= 1) {
+        task(int64_t{0}, count, 0);
+        return;
+    }
+
+    auto threads = std::vector<std::thread>();
+    threads.reserve(threads_count);
+    for (auto t = 0; t < threads_count; t++) {
+        const auto begin = count * t / threads_count;
+        const auto end = count * (t + 1) / threads_count;
+        threads.emplace_back([&task, begin, end, t]() { task(begin, end, t); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
     }
 }
 
-MultiDimAddress MultiDimTopology::translate_address(const DeviceId npu_id) const noexcept {
-    // If units-count if [2, 8, 4], and the given id is 47, then the id should be
-    // 47 // 16 = 2, leftover = 47 % 16 = 15
-    // 15 // 2 = 7, leftover = 15 % 2 = 1
-    // 1 // 1 = 1, leftover = 0
-    // therefore the address is [1, 7, 2]
-
-    // create empty address
-    auto multi_dim_address = MultiDimAddress();
-    for (int i = 0; i < dims_count; i++) {
-        multi_dim_address.push_back(-1);
+void MultiDimTopology::make_dim_connections(const int dim) noexcept {
+    const auto* const topology = m_topology_per_dim.at(dim).get();
+    const auto policies = topology->get_connection_policies();
+    assert(!policies.empty());
+
+    const auto bandwidth = bandwidth_per_dim.at(dim);
+    const auto latency = topology->get_link_latency();
+    const auto total_devices_count = static_cast<int64_t>(devices.size());
+
+    // each policy yields one pair per each combination of the addresses in the other dimensions,
+    // so the pairs of a policy fill their own block, in enumeration order
+    const auto pairs_per_policy = get_combinations_count(dim);
+    const auto pairs_count = static_cast<int64_t>(policies.size()) * pairs_per_policy;
+    auto srcs = std::vector<DeviceId>(pairs_count);
+    auto dests = std::vector<DeviceId>(pairs_count);
+    parallel_for(static_cast<int64_t>(policies.size()), [&](const int64_t begin, const int64_t end, int) {
+        for (auto p = begin; p < end; p++) {
+            auto pair = p * pairs_per_policy;
+            for_each_connection(dim, policies[p], [&](const DeviceId src, const DeviceId dest) {
+                srcs[pair] = src;
+                dests[pair] = dest;
+                pair++;
+            });
+            assert(pair == (p + 1) * pairs_per_policy);
+        }
+    });
+
+    // bucket the pairs by src device, keeping the enumeration order within each bucket:
+    // each thread counts the pairs of its range per src, then places them after those of the previous ranges
+    const auto threads_count = static_cast<int>(std::max<int64_t>(1, std::min<int64_t>(m_construction_threads, pairs_count)));
+    auto counts = std::vector<std::vector<int64_t>>(threads_count, std::vector<int64_t>(total_devices_count + 1, 0));
+    parallel_for(pairs_count, [&](const int64_t begin, const int64_t end, const int t) {
+        for (auto pair = begin; pair < end; pair++) {
+            counts[t][srcs[pair]]++;
+        }
+    });
+    auto bucket_begin = std::vector<int64_t>(total_devices_count + 1, 0);
+    auto next_slot = int64_t{0};
+    for (auto device = int64_t{0}; device < total_devices_count; device++) {
+        bucket_begin[device] = next_slot;
+        for (auto t = 0; t < threads_count; t++) {
+            const auto pairs_in_range = counts[t][device];
+            counts[t][device] = next_slot;
+            next_slot += pairs_in_range;
+        }
+    }
+    bucket_begin[total_devices_count] = next_slot;
+    auto bucket = std::vector<int64_t>(pairs_count);
+    parallel_for(pairs_count, [&](const int64_t begin, const int64_t end, const int t) {
+        for (auto pair = begin; pair < end; pair++) {
+            bucket[counts[t][srcs[pair]]++] = pair;
+        }
+    });
+
+    // a pair is skipped if its src is already connected to its dest, by an earlier dimension or pair
+    auto skipped = std::vector<uint8_t>(pairs_count, 0);
+    parallel_for(total_devices_count, [&](const int64_t begin, const int64_t end, int) {
+        auto sorted_dests = std::vector<std::pair<DeviceId, int64_t>>();
+        for (auto device = begin; device < end; device++) {
+            sorted_dests.clear();
+            for (auto slot = bucket_begin[device]; slot < bucket_begin[device + 1]; slot++) {
+                const auto pair = bucket[slot];
+                if (devices[device]->connected(dests[pair])) {
+                    skipped[pair] = 1;
+                } else {
+                    sorted_dests.emplace_back(dests[pair], pair);
+                }
+            }
+            std::sort(sorted_dests.begin(), sorted_dests.end());
+            for (auto i = size_t{1}; i < sorted_dests.size(); i++) {
+                if (sorted_dests[i].first == sorted_dests[i - 1].first) {
+                    skipped[sorted_dests[i].second] = 1;
+                }
+            }
+        }
+    });
+
+    // number the links of the connected pairs in enumeration order
+    auto link_ids = std::vector<LinkId>(pairs_count);
+    auto links_count = int64_t{0};
+    for (auto pair = int64_t{0}; pair < pairs_count; pair++) {
+        if (skipped[pair]) {
+            std::cout << "Device " << srcs[pair] << " already connected to Device " << dests[pair] << "." << std::endl;
+            continue;
+        }
+        link_ids[pair] = static_cast<LinkId>(links_count++);
+    }
+    const auto first_link_id = link_table->add_links(static_cast<int>(links_count));
+
+    // set up the links, applying link faults
+    parallel_for(pairs_count, [&](const int64_t begin, const int64_t end, int) {
+        for (auto pair = begin; pair < end; pair++) {
+            if (skipped[pair]) {
+                continue;
+            }
+
+            const auto src = srcs[pair];
+            const auto dest = dests[pair];
+            assert(0 <= src && src < devices_count);
+            assert(0 <= dest && dest < devices_count);
+
+            const auto link_id = first_link_id + link_ids[pair];
+            const auto derate = fault_derate(src, dest);
+            if (derate != 0) {
+                link_table->init_link(link_id, src, dest, bandwidth * derate, latency);
+            } else {
+                link_table->init_link(link_id, src, dest, bandwidth, latency);  // might be removable
+            }
+        }
+    });
+
+    // bound the input buffers fed by the links of the dimension
+    if (!m_input_buffer_size_per_dim.empty()) {
+        const auto buffer_size = m_input_buffer_size_per_dim.at(dim);
+        link_table->setup_links(first_link_id, static_cast<int>(links_count),
+                                [buffer_size](Link& link) { link.set_input_buffer_size(buffer_size); });
+    }
+
+    // attach the links to their src devices, pre-sizing the ports of each device
+    parallel_for(total_devices_count, [&](const int64_t begin, const int64_t end, int) {
+        for (auto device = begin; device < end; device++) {
+            auto new_ports_count = 0;
+            for (auto slot = bucket_begin[device]; slot < bucket_begin[device + 1]; slot++) {
+                new_ports_count += skipped[bucket[slot]] ? 0 : 1;
+            }
+            if (new_ports_count == 0) {
+                continue;
+            }
+
+            auto& src_device = *devices[device];
+            src_device.reserve_ports(src_device.get_ports_count() + new_ports_count);
+            for (auto slot = bucket_begin[device]; slot < bucket_begin[device + 1]; slot++) {
+                const auto pair = bucket[slot];
+                if (!skipped[pair]) {
+                    src_device.attach(dests[pair], first_link_id + link_ids[pair]);
+                }
+            }
+        }
+    });
+}
+
+void MultiDimTopology::make_bus_connections(const int dim) noexcept {
+    const auto* const bus = static_cast<const Bus*>(m_topology_per_dim.at(dim).get());
+    const auto bandwidth = bandwidth_per_dim.at(dim);
+    const auto latency = bus->get_link_latency();
+    const auto arbitration = bus->get_arbitration();
+
+    const auto agents_only = is_agents_only_dim(dim);
+    const auto stride = m_address_translator.get_stride(dim);
+    for (auto npu_id = 0; npu_id < npus_count; npu_id++) {
+        // visit each group once, through its member at index 0 of the dim
+        auto address = translate_address(npu_id);
+        if (address.at(dim) != 0) {
+            continue;
+        }
+
+        // only the groups of cluster agents get a medium
+        if (agents_only && npu_id % stride >= m_cluster_agents_count) {
+            continue;
+        }
+
+        // collect the members of the group
+        auto device_ids = std::vector<DeviceId>();
+        for (auto i = 0; i < npus_count_per_dim.at(dim); i++) {
+            address.at(dim) = i;
+            device_ids.push_back(translate_address_back(address));
+        }
+
+        // attach the group to its own shared medium
+        shared_medium_connect(device_ids, bandwidth, latency, arbitration);
+
+        // bound the input buffer fed by the medium
+        if (!m_input_buffer_size_per_dim.empty()) {
+            const auto buffer_size = m_input_buffer_size_per_dim.at(dim);
+            link_table->setup_link(devices.at(device_ids.at(0))->get_link_id(device_ids.at(1)),
+                                   [buffer_size](Link& link) { link.set_input_buffer_size(buffer_size); });
+        }
+    }
+}
+
+void MultiDimTopology::make_implicit_connections() noexcept {
+    assert(link_table->get_links_count() == 0);
+
+    link_table->set_implicit([this](const LinkId link_id) { return describe_implicit_link(link_id); });
+
+    // number the links of each dimension after those of the previous one
+    m_first_link_per_dim.assign(dims_count + 1, 0);
+    m_policies_per_dim.assign(dims_count, {});
+    m_policy_index_per_dim.assign(dims_count, {});
+    auto links_count = int64_t{0};
+    for (auto dim = 0; dim < dims_count; dim++) {
+        m_first_link_per_dim[dim] = static_cast<LinkId>(links_count);
+
+        // each policy yields one link per each combination of the addresses in the other dimensions,
+        // while a Bus dimension has one link per each group
+        const auto* const topology = m_topology_per_dim[dim].get();
+        const auto combinations_count = get_combinations_count(dim);
+        if (topology->get_basic_topology_type() == TopologyBuildingBlock::Bus) {
+            links_count += combinations_count;
+            continue;
+        }
+
+        // a policy connecting an already connected pair yields no link
+        const auto addresses_count = npus_count_per_dim[dim] + 1;
+        auto& policy_index = m_policy_index_per_dim[dim];
+        auto& policies = m_policies_per_dim[dim];
+        policy_index.assign(addresses_count * addresses_count, -1);
+        for (const auto& policy : topology->get_connection_policies()) {
+            auto& index = policy_index[policy.src * addresses_count + policy.dst];
+            if (index == -1) {
+                index = static_cast<int>(policies.size());
+                policies.push_back(policy);
+            }
+        }
+        links_count += static_cast<int64_t>(policies.size()) * combinations_count;
+    }
+    m_first_link_per_dim[dims_count] = static_cast<LinkId>(links_count);
+    [[maybe_unused]] const auto first_link_id = link_table->add_links(static_cast<int>(links_count));
+    assert(first_link_id == 0);
+
+    setup_links_per_dim();
+}
+
+void MultiDimTopology::setup_links_per_dim() noexcept {
+    assert(m_first_link_per_dim.size() == dims_count + 1);
+
+    for (auto dim = 0; dim < dims_count; dim++) {
+        const auto first_link_id = m_first_link_per_dim[dim];
+        const auto dim_links_count = static_cast<int>(m_first_link_per_dim[dim + 1] - first_link_id);
+
+        // arbitrate the shared media of a Bus dimension among the members of their group
+        const auto* const topology = m_topology_per_dim[dim].get();
+        if (topology->get_basic_topology_type() == TopologyBuildingBlock::Bus &&
+            static_cast<const Bus*>(topology)->get_arbitration() == BusArbitration::RoundRobin) {
+            link_table->setup_links(first_link_id, dim_links_count, [this, dim, first_link_id](Link& link) {
+                link.set_round_robin_ports(get_bus_group(dim, link.get_id() - first_link_id));
+            });
+        }
+
+        // bound the input buffers fed by the links of the dimension
+        if (!m_input_buffer_size_per_dim.empty()) {
+            const auto buffer_size = m_input_buffer_size_per_dim.at(dim);
+            link_table->setup_links(first_link_id, dim_links_count,
+                                    [buffer_size](Link& link) { link.set_input_buffer_size(buffer_size); });
+        }
+    }
+}
+
+LinkTable::LinkDescription MultiDimTopology::describe_implicit_link(const LinkId link_id) const noexcept {
+    assert(link_id < m_first_link_per_dim.back());
+
+    // find the dimension of the link
+    const auto dim = static_cast<int>(
+        std::upper_bound(m_first_link_per_dim.begin(), m_first_link_per_dim.end(), link_id) -
+        m_first_link_per_dim.begin() - 1);
+    const auto* const topology = m_topology_per_dim[dim].get();
+    const auto bandwidth = bandwidth_per_dim[dim];
+    const auto latency = topology->get_link_latency();
+
+    // the shared medium of a Bus group has no single pair of endpoints
+    if (topology->get_basic_topology_type() == TopologyBuildingBlock::Bus) {
+        return {-1, -1, bandwidth, latency};
+    }
+
+    // decode the policy and the combination of the addresses in the other dimensions
+    const auto index = static_cast<int64_t>(link_id - m_first_link_per_dim[dim]);
+    const auto combinations_count = get_combinations_count(dim);
+    const auto& policy = m_policies_per_dim[dim][index / combinations_count];
+    auto combination = index % combinations_count;
+    auto address = MultiDimAddress(dims_count, 0);
+    const auto agents_only = is_agents_only_dim(dim);
+    for (auto i = dims_count - 1; i >= (agents_only ? dim + 1 : 0); i--) {
+        if (i != dim) {
+            address[i] = static_cast<DeviceId>(combination % npus_count_per_dim[i]);
+            combination /= npus_count_per_dim[i];
+        }
+    }
+
+    // the remaining combination is the agent offset, giving the lower-dimension addresses of the agent
+    if (agents_only) {
+        const auto agent_address = translate_address(static_cast<DeviceId>(combination));
+        std::copy_n(agent_address.begin(), dim, address.begin());
+    }
+
+    address[dim] = policy.src;
+    const auto src = get_device_id(address);
+    address[dim] = policy.dst;
+    const auto dest = get_device_id(address);
+
+    // apply link faults, as constructed, since health changes at runtime are applied to the Link objects
+    const auto derate = (fault_map != nullptr) ? fault_map->derate(src, dest) : 1.0;
+    return {src, dest, (derate != 0) ? bandwidth * derate : bandwidth, latency};
+}
+
+void MultiDimTopology::get_implicit_ports(const DeviceId device_id,
+                                          std::vector<std::pair<DeviceId, LinkId>>& ports) const noexcept {
+    ports.clear();
+
+    // attach the links of the policies leaving the device at the given address in a dimension
+    const auto add_policy_ports = [&](MultiDimAddress address, const int dim) {
+        const auto addresses_count = npus_count_per_dim[dim] + 1;
+        const auto* const policy_index = m_policy_index_per_dim[dim].data() + address[dim] * addresses_count;
+        const auto combinations_count = get_combinations_count(dim);
+        const auto first_link_id = m_first_link_per_dim[dim] + get_combination_index(address, dim);
+        for (auto dest = 0; dest < addresses_count; dest++) {
+            if (policy_index[dest] != -1) {
+                address[dim] = dest;
+                ports.emplace_back(get_device_id(address),
+                                   static_cast<LinkId>(first_link_id + policy_index[dest] * combinations_count));
+            }
+        }
+    };
+
+    if (device_id < npus_count) {
+        // an NPU leaves through each dimension
+        const auto address = translate_address(device_id);
+        for (auto dim = 0; dim < dims_count; dim++) {
+            // only cluster agents leave through a dimension connecting agents only
+            if (is_agents_only_dim(dim) && device_id % m_address_translator.get_stride(dim) >= m_cluster_agents_count) {
+                continue;
+            }
+
+            if (m_topology_per_dim[dim]->get_basic_topology_type() != TopologyBuildingBlock::Bus) {
+                add_policy_ports(address, dim);
+                continue;
+            }
+
+            // reach every other member of the group through its shared medium
+            const auto link_id = static_cast<LinkId>(m_first_link_per_dim[dim] + get_bus_group_index(dim, device_id));
+            const auto stride = m_address_translator.get_stride(dim);
+            const auto group_base = device_id - address[dim] * stride;
+            for (auto i = 0; i < npus_count_per_dim[dim]; i++) {
+                if (i != address[dim]) {
+                    ports.emplace_back(group_base + i * stride, link_id);
+                }
+            }
+        }
+    } else {
+        // a switch belongs to the last Switch dimension whose switches start at or before its id
+        auto dim = dims_count - 1;
+        while (m_topology_per_dim[dim]->get_basic_topology_type() != TopologyBuildingBlock::Switch ||
+               m_switch_translation_unit->get_first_switch_id(dim) > device_id) {
+            dim--;
+            assert(dim >= 0);
+        }
+
+        // the switch is identified by its higher-dimension addresses, the closest dimension being the least significant
+        auto address = MultiDimAddress(dims_count, 0);
+        auto offset = device_id - m_switch_translation_unit->get_first_switch_id(dim);
+        for (auto i = dim + 1; i < dims_count; i++) {
+            address[i] = offset % npus_count_per_dim[i];
+            offset /= npus_count_per_dim[i];
+        }
+        address[dim] = npus_count_per_dim[dim];
+
+        // and serves every combination of the lower-dimension addresses, only the agents' if connecting agents only
+        const auto lower_combinations_count =
+            is_agents_only_dim(dim) ? m_cluster_agents_count : m_address_translator.get_stride(dim);
+        for (auto lower_combination = 0; lower_combination < lower_combinations_count; lower_combination++) {
+            auto remainder = lower_combination;
+            for (auto i = 0; i < dim; i++) {
+                address[i] = remainder % npus_count_per_dim[i];
+                remainder /= npus_count_per_dim[i];
+            }
+            add_policy_ports(address, dim);
+        }
+    }
+
+    // in the order of the connected devices, so attaching appends each port
+    std::sort(ports.begin(), ports.end());
+}
+
+int64_t MultiDimTopology::get_combination_index(const MultiDimAddress& address, const int dim) const noexcept {
+    assert(address.size() == dims_count);
+
+    // the lower dimensions make up the agent offset if only cluster agents are connected
+    auto combination = int64_t{0};
+    auto first_dim = 0;
+    if (is_agents_only_dim(dim)) {
+        for (; first_dim < dim; first_dim++) {
+            combination += address[first_dim] * m_address_translator.get_stride(first_dim);
+        }
+        first_dim = dim + 1;
+    }
+    for (auto i = first_dim; i < dims_count; i++) {
+        if (i != dim) {
+            combination = combination * npus_count_per_dim[i] + address[i];
+        }
+    }
+
+    return combination;
+}
+
+DeviceId MultiDimTopology::get_device_id(const MultiDimAddress& address) const noexcept {
+    if (is_switch(address)) {
+        return m_switch_translation_unit->translate_address_to_id(address);
+    }
+
+    return translate_address_back(address);
+}
+
+std::vector<DeviceId> MultiDimTopology::get_bus_group(const int dim, const int64_t group) const noexcept {
+    // the members of a group only differ in the addresses of the dimension, i.e., by multiples of its stride
+    const auto stride = m_address_translator.get_stride(dim);
+    // groups only span the agent offsets of each block if only cluster agents are connected
+    const auto offsets_count = is_agents_only_dim(dim) ? m_cluster_agents_count : stride;
+    const auto group_base =
+        static_cast<DeviceId>(group % offsets_count + group / offsets_count * stride * npus_count_per_dim[dim]);
+
+    auto device_ids = std::vector<DeviceId>(npus_count_per_dim[dim]);
+    for (auto i = 0; i < npus_count_per_dim[dim]; i++) {
+        device_ids[i] = group_base + i * stride;
     }
 
-    auto leftover = npu_id;
-    auto denominator = npus_count;
+    return device_ids;
+}
+
+int64_t MultiDimTopology::get_bus_group_index(const int dim, const DeviceId npu_id) const noexcept {
+    assert(0 <= npu_id && npu_id < npus_count);
+
+    // rank of the group member at index 0 of the dimension among those of the other groups
+    const auto stride = m_address_translator.get_stride(dim);
+    const auto offsets_count = is_agents_only_dim(dim) ? m_cluster_agents_count : stride;
+    assert(npu_id % stride < offsets_count);
+
+    return npu_id % stride + npu_id / (stride * npus_count_per_dim[dim]) * offsets_count;
+}
+
+void MultiDimTopology::set_construction_threads(const int threads_count) noexcept {
+    assert(threads_count >= 0);
+
+    // use every hardware thread if not given
+    m_construction_threads =
+        (threads_count > 0) ? threads_count : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+void MultiDimTopology::set_implicit(const bool implicit) noexcept {
+    assert(devices.empty());
 
-    for (int dim = dims_count - 1; dim >= 0; dim--) {
-        // change denominator
-        denominator /= npus_count_per_dim.at(dim);
+    m_implicit = implicit;
+}
+
+void MultiDimTopology::initialize_all_devices() noexcept {
+    // instantiate all devices
+    const auto total_num_devices = get_total_num_devices();
 
-        // get and update address
-        const auto quotient = leftover / denominator;
-        leftover %= denominator;
+    devices.resize(total_num_devices);
 
-        // update address
-        multi_dim_address.at(dim) = quotient;
+    // an implicit topology creates each device once used
+    if (m_implicit) {
+        return;
     }
 
+    parallel_for(total_num_devices, [this](const int64_t begin, const int64_t end, int) {
+        for (auto i = begin; i < end; i++) {
+            devices[i] = std::make_shared<Device>(static_cast<DeviceId>(i), link_table);
+        }
+    });
+}
+
+MultiDimAddress MultiDimTopology::translate_address(const DeviceId npu_id) const noexcept {
+    assert(0 <= npu_id && npu_id < npus_count);
+
+    // e.g., if units-count if [2, 8, 4] and the given id is 47, the address is [1, 7, 2]
+    const auto multi_dim_address = m_address_translator.translate_address(npu_id);
+
     // check address translation
     for (int i = 0; i < dims_count; i++) {
         assert(0 <= multi_dim_address.at(i));
@@ -414,18 +1203,10 @@ MultiDimAddress MultiDimTopology::translate_address(const DeviceId npu_id) const
     return multi_dim_address;
 }
 
-DeviceId MultiDimTopology::translate_address_back(const MultiDimAddress multi_dim_address) const noexcept {
-    DeviceId device_id = 0;
+DeviceId MultiDimTopology::translate_address_back(const MultiDimAddress& multi_dim_address) const noexcept {
     assert(multi_dim_address.size() == dims_count);
-    for (int top_dim = dims_count - 1; top_dim >= 0; top_dim--) {
-        // product from beginning to the top_dim - 1
-        DeviceId total_npus_in_group = std::accumulate(npus_count_per_dim.begin(), npus_count_per_dim.begin() + top_dim,
-                                                       static_cast<DeviceId>(1), std::multiplies<DeviceId>());
 
-        // Add the contribution to the total device ID
-        device_id += total_npus_in_group * multi_dim_address.at(top_dim);
-    }
-    return device_id;
+    return m_address_translator.translate_address_back(multi_dim_address);
 }
 
 int MultiDimTopology::get_dim_to_transfer(const MultiDimAddress& src_address,
@@ -498,106 +1279,30 @@ void MultiDimTopology::build_switch_length_mapping() noexcept {
         m_switch_translation_unit.emplace(npus_count_per_dim, is_switch_dim);
     }
 }
-double MultiDimTopology::fault_derate(int src, int dst) const{
-    for (const auto& link : faulty_links) {
-        int a = std::get<0>(link);
-        int b = std::get<1>(link);
-        double health = std::get<2>(link);
-
-        // If this link exists and health != 0.0 → it's soft fault
-        if ((a == src && b == dst) || (a == dst && b == src)) {
-            return health;
+void MultiDimTopology::set_in_network_reduction_per_dim(const std::vector<bool>& enabled_per_dim,
+                                                        const std::vector<Bandwidth>& throughput_per_dim) noexcept {
+    assert(enabled_per_dim.size() == dims_count);
+    assert(throughput_per_dim.size() == dims_count);
+
+    // switches of each Switch dimension take consecutive device ids after the NPUs,
+    // one switch per each combination of the higher-dimension coordinates (see SwitchTranslationUnit)
+    auto switch_id = npus_count;
+    for (auto dim = 0; dim < dims_count; dim++) {
+        if (m_topology_per_dim.at(dim)->get_basic_topology_type() != TopologyBuildingBlock::Switch) {
+            continue;
         }
-        //else
-        //    return 1;
-    }
-    return 1;
-}
-
-
-// std::vector<std::pair<MultiDimAddress, MultiDimAddress>>
-// generateAddressPairs_only_first_nodes(const std::vector<int>& npus_count_per_dim,
-//                                       const ConnectionPolicy& policy,
-//                                       int dim)
-// {
-//     std::vector<std::pair<MultiDimAddress, MultiDimAddress>> result;
-
-//     MultiDimAddress addr(npus_count_per_dim.size());
-
-//     // Only vary dim, all other dims = 0
-//     for (int d = 0; d < (int)npus_count_per_dim[dim]; d++) {
-//         addr[dim] = d;
-//         MultiDimAddress src = addr;
-//         MultiDimAddress dst = addr;
-
-//         src[dim] = policy.src;
-//         dst[dim] = policy.dst;
-
-//         result.emplace_back(src, dst);
-//     }
-
-//     return result;
-// }
-
-
-void MultiDimTopology::make_non_recursive_connections() noexcept {
-    if (!m_switch_translation_unit.has_value()) {
-        std::cerr << "[Error] (network/analytical/congestion_aware/MultiDimTopology): "
-                  << "SwitchTranslationUnit is not initialized." << std::endl;
-        std::exit(-1);
-    }
-
-    for (int dim = 0; dim < dims_count; dim++) {
-    const auto topology = m_topology_per_dim.at(dim).get();
-    const auto policies = topology->get_connection_policies();
-    assert(!policies.empty());
-
-    bool recursive_dim = (m_non_recursive_topo.at(dim) == 1);
-
-        for (const auto& policy : policies) {
-
-            std::vector<std::pair<MultiDimAddress, MultiDimAddress>> address_pairs;
-
-            // --- NORMAL MODE ---
-            if (!recursive_dim) {
-                address_pairs =
-                    generateAddressPairs(npus_count_per_dim, policy, dim);
-            }
 
-            // --- RECURSIVE MODE: only first nodes of lower dimensions ---
-            else {
-                address_pairs =
-                    generateAddressPairs(npus_count_per_dim, policy, dim);
-            }
-
-            // Create links for all generated pairs
-            for (const auto& ap : address_pairs) {
-
-                const auto src = is_switch(ap.first)
-                                    ? m_switch_translation_unit.value().translate_address_to_id(ap.first)
-                                    : translate_address_back(ap.first);
-
-                const auto dest = is_switch(ap.second)
-                                    ? m_switch_translation_unit.value().translate_address_to_id(ap.second)
-                                    : translate_address_back(ap.second);
-
-                assert(0 <= src && src < devices_count);
-                assert(0 <= dest && dest < devices_count);
-
-                const auto bw = bandwidth_per_dim.at(dim);
-                const auto lat = topology->get_link_latency();
-
-                if (fault_derate(src, dest) != 0)
-                    connect(src, dest, bw * fault_derate(src, dest), lat, false);
-                else
-                    connect(src, dest, bw, lat, false);
-            }
+        const auto switches_count = std::accumulate(npus_count_per_dim.begin() + dim + 1, npus_count_per_dim.end(),
+                                                    1, std::multiplies<int>());
+        if (enabled_per_dim.at(dim)) {
+            const auto throughput = throughput_per_dim.at(dim);
+            setup_devices(switch_id, switches_count,
+                          [throughput](Device& device) { device.set_reduction_engine(throughput); });
         }
+        switch_id += switches_count;
     }
-
 }
 
 
-
 };  // namespace NetworkAnalyticalCongestionAware
 
@@ -18,56 +18,59 @@ SwitchTranslationUnit::SwitchTranslationUnit(std::vector<int> npus_count_per_dim
       m_is_switch_dim{is_switch_dim} {
     assert(npus_count_per_dim.size() == is_switch_dim.size());
 
-    // build switch length to starting offset mapping
+    // switches of each switch dimension take consecutive IDs after the NPUs,
+    // one per each combination of the higher-dimension addresses
+    const int dims_count = m_npus_count_per_dim.size();
+    m_first_switch_id_per_dim.assign(dims_count, -1);
+    m_switch_strides.assign(dims_count * dims_count, 0);
+
     int cumulative_offset = 0;
-    int dims_count = m_npus_count_per_dim.size();
     for (int dim = 0; dim < dims_count; dim++) {
-        if (m_is_switch_dim.at(dim)) {
-            // product of npus in all higher dimensions
-            int num_switches = std::accumulate(m_npus_count_per_dim.begin() + dim + 1, m_npus_count_per_dim.end(),
-                                               static_cast<int>(1), std::multiplies<int>());
+        if (!m_is_switch_dim.at(dim)) {
+            continue;
+        }
+        m_first_switch_id_per_dim.at(dim) = m_total_npus_count + cumulative_offset;
 
-            int address_length = dims_count - dim - 1;
-            assert(m_switch_length_number_mapping.find(address_length) == m_switch_length_number_mapping.end());
-            m_switch_length_number_mapping.insert({address_length, cumulative_offset});
-            cumulative_offset += num_switches;
+        // the higher-dimension addresses are laid out like NPU IDs, dimension dim + 1 being the least significant
+        int num_switches = 1;
+        for (int higher_dim = dim + 1; higher_dim < dims_count; higher_dim++) {
+            m_switch_strides.at(dim * dims_count + higher_dim) = num_switches;
+            num_switches *= m_npus_count_per_dim.at(higher_dim);
         }
+        cumulative_offset += num_switches;
     }
 }
 
 [[nodiscard]] DeviceId SwitchTranslationUnit::translate_address_to_id(const MultiDimAddress& address) const noexcept {
+    assert(address.size() == m_npus_count_per_dim.size());
+
     // find which dimension is the switch
+    const int dims_count = address.size();
     int switch_dim = -1;
-    for (int dim = 0; dim < address.size(); dim++) {
-        if (address.at(dim) == m_npus_count_per_dim.at(dim)) {
+    for (int dim = 0; dim < dims_count; dim++) {
+        if (address[dim] == m_npus_count_per_dim[dim]) {
             switch_dim = dim;
             break;
         }
     }
     assert(switch_dim != -1);
+    assert(m_is_switch_dim[switch_dim]);
 
-    // get the length of rest address
-    int left_length = address.size() - switch_dim - 1;
-    MultiDimAddress partial_addr(address.begin() + switch_dim + 1, address.end());
-    // get offset on that level
-    DeviceId offset = translate_partial_address_to_offset(
-        partial_addr, std::vector<int>(m_npus_count_per_dim.begin() + switch_dim + 1, m_npus_count_per_dim.end()));
+    // get offset on that level from the higher-dimension addresses
+    const auto* const strides = m_switch_strides.data() + switch_dim * dims_count;
+    DeviceId offset = 0;
+    for (int dim = switch_dim + 1; dim < dims_count; dim++) {
+        offset += strides[dim] * address[dim];
+    }
 
-    return m_total_npus_count + m_switch_length_number_mapping.at(left_length) + offset;
+    return m_first_switch_id_per_dim[switch_dim] + offset;
 }
 
-DeviceId SwitchTranslationUnit::translate_partial_address_to_offset(
-    const MultiDimAddress& partial_address, const std::vector<int>& partial_npus_count_per_dim) const noexcept {
-    // roughly duplicate of MultiDimTopology::translate_address_back
-    DeviceId device_id = 0;
-    for (int top_dim = partial_npus_count_per_dim.size() - 1; top_dim >= 0; top_dim--) {
-        DeviceId total_npus_in_group =
-            std::accumulate(partial_npus_count_per_dim.begin(), partial_npus_count_per_dim.begin() + top_dim,
-                            static_cast<DeviceId>(1), std::multiplies<DeviceId>());
+DeviceId SwitchTranslationUnit::get_first_switch_id(const int dim) const noexcept {
+    assert(0 <= dim && dim < m_npus_count_per_dim.size());
+    assert(m_is_switch_dim.at(dim));
 
-        device_id += total_npus_in_group * partial_address.at(top_dim);
-    }
-    return device_id;
+    return m_first_switch_id_per_dim.at(dim);
 }
 
 };  // namespace NetworkAnalyticalCongestionAware
@@ -20,9 +20,9 @@ void Chunk::chunk_arrived_next_device(void* const chunk_ptr) noexcept {
     chunk->mark_arrived_next_device();
 
     if (chunk->arrived_dest()) {
-        // chunk arrived dest, invoke callback
-        // as chunk is unique_ptr, will be destroyed automatically
-        chunk->invoke_callback();
+        // chunk arrived dest, let the dest receive it
+        const auto dest = chunk->current_device();
+        dest->receive(std::move(chunk));
     } else {
         // send this chunk to next dest
         const auto current_node = chunk->current_device();
@@ -30,12 +30,21 @@ void Chunk::chunk_arrived_next_device(void* const chunk_ptr) noexcept {
     }
 }
 
-Chunk::Chunk(const ChunkSize chunk_size, Route route, const Callback callback, const CallbackArg callback_arg) noexcept
+Chunk::Chunk(const ChunkSize chunk_size,
+             Route route,
+             const Callback callback,
+             const CallbackArg callback_arg,
+             const TrafficClass traffic_class) noexcept
     : chunk_size(chunk_size),
       route(std::move(route)),
       callback(callback),
-      callback_arg(callback_arg) {
+      callback_arg(callback_arg),
+      traffic_class(traffic_class),
+      ingress_link(nullptr),
+      reduction_group(-1),
+      contributions_count(1) {
     assert(chunk_size > 0);
+    assert(traffic_class >= 0);
     assert(!this->route.empty());
     assert(callback != nullptr);
 }
@@ -57,6 +66,14 @@ std::shared_ptr<Device> Chunk::next_device() const noexcept {
     return *next_dest;
 }
 
+std::shared_ptr<Device> Chunk::dest_device() const noexcept {
+    // assert the route is not empty
+    assert(!route.empty());
+
+    // return the last device in route
+    return route.back();
+}
+
 void Chunk::mark_arrived_next_device() noexcept {
     // if this method is being called,
     // it means the chunk hasn't arrived its final dest yet
@@ -67,6 +84,15 @@ void Chunk::mark_arrived_next_device() noexcept {
     route.pop_front();
 }
 
+void Chunk::set_route(Route new_route) noexcept {
+    // the new route leaves from the current device, heading to the same destination
+    assert(new_route.size() > 1);
+    assert(new_route.front() == current_device());
+    assert(new_route.back() == dest_device());
+
+    route = std::move(new_route);
+}
+
 bool Chunk::arrived_dest() const noexcept {
     // if a chunk arrived dest, route length should be 1
     // i.e., only containing the dest node
@@ -80,7 +106,67 @@ ChunkSize Chunk::get_size() const noexcept {
     return chunk_size;
 }
 
+TrafficClass Chunk::get_traffic_class() const noexcept {
+    return traffic_class;
+}
+
 void Chunk::invoke_callback() noexcept {
     // invoke callback
     (*callback)(callback_arg);
 }
+
+void Chunk::deliver() noexcept {
+    // chunk is consumed by the dest, free its slot in the input buffer
+    if (ingress_link != nullptr) {
+        ingress_link->return_credits(chunk_size, traffic_class);
+    }
+
+    // invoke callback, then the callbacks of the chunks reduced into this one
+    invoke_callback();
+    for (const auto& contribution : merged_contributions) {
+        contribution->invoke_callback();
+    }
+}
+
+void Chunk::set_reduction_group(const ReductionGroup reduction_group, const int contributions_count) noexcept {
+    assert(reduction_group >= 0);
+    assert(contributions_count > 0);
+
+    this->reduction_group = reduction_group;
+    this->contributions_count = contributions_count;
+}
+
+ReductionGroup Chunk::get_reduction_group() const noexcept {
+    return reduction_group;
+}
+
+int Chunk::get_contributions_count() const noexcept {
+    assert(contributions_count > 0);
+
+    return contributions_count;
+}
+
+void Chunk::clear_reduction_group() noexcept {
+    reduction_group = -1;
+    contributions_count = 1;
+}
+
+void Chunk::merge(std::unique_ptr<Chunk> contribution) noexcept {
+    assert(contribution != nullptr);
+    assert(contribution.get() != this);
+
+    // the contribution carries its own merged contributions along
+    for (auto& nested_contribution : contribution->merged_contributions) {
+        merged_contributions.push_back(std::move(nested_contribution));
+    }
+    contribution->merged_contributions.clear();
+    merged_contributions.push_back(std::move(contribution));
+}
+
+void Chunk::set_ingress_link(Link* const link) noexcept {
+    ingress_link = link;
+}
+
+Link* Chunk::get_ingress_link() const noexcept {
+    return ingress_link;
+}
@@ -0,0 +1,234 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/Crossbar.h"
+#include "congestion_aware/Chunk.h"
+#include "congestion_aware/Link.h"
+#include "congestion_aware/LinkTable.h"
+#include <algorithm>
+#include <cassert>
+
+using namespace NetworkAnalyticalCongestionAware;
+
+// declaring static event_queue
+std::shared_ptr<EventQueue> Crossbar::event_queue;
+
+void Crossbar::transfer_finished(void* const transfer_ptr) noexcept {
+    assert(transfer_ptr != nullptr);
+
+    // cast to unique_ptr<Transfer>
+    auto transfer = std::unique_ptr<Transfer>(static_cast<Transfer*>(transfer_ptr));
+    auto* const crossbar = transfer->crossbar;
+
+    // free the ports of the transfer
+    if (transfer->input >= 0) {
+        crossbar->input_busy[transfer->input] = false;
+    }
+    crossbar->output_busy[transfer->output] = false;
+
+    // hand the chunk over to its egress link
+    auto& egress_link = crossbar->link_table->at(crossbar->output_links[transfer->output]);
+    egress_link.send(std::move(transfer->chunk));
+
+    // the freed ports may serve waiting chunks
+    crossbar->arbitrate();
+}
+
+void Crossbar::set_event_queue(std::shared_ptr<EventQueue> event_queue_ptr) noexcept {
+    assert(event_queue_ptr != nullptr);
+
+    // set the event queue
+    Crossbar::event_queue = std::move(event_queue_ptr);
+}
+
+Crossbar::Crossbar(LinkTable* const link_table,
+                   std::vector<LinkId> output_links,
+                   const SwitchQueueing queueing,
+                   const SwitchArbitration arbitration,
+                   const double speedup) noexcept
+    : link_table(link_table),
+      output_links(std::move(output_links)),
+      queueing(queueing),
+      arbitration(arbitration),
+      speedup(speedup) {
+    assert(link_table != nullptr);
+    assert(!this->output_links.empty());
+    assert(queueing != SwitchQueueing::Ideal);
+    assert(speedup > 0);
+
+    const auto outputs_count = this->output_links.size();
+    output_busy.resize(outputs_count, false);
+    grant_pointer.resize(outputs_count, 0);
+
+    // output-queued chunks only contend for outputs, so keep them all under a single input
+    if (queueing == SwitchQueueing::OutputQueued) {
+        queues.resize(1);
+        queues[0].resize(outputs_count);
+    }
+}
+
+void Crossbar::send(std::unique_ptr<Chunk> chunk, const int output) noexcept {
+    assert(chunk != nullptr);
+    assert(0 <= output && output < output_links.size());
+
+    if (queueing == SwitchQueueing::OutputQueued) {
+        // enqueue at the output, and start crossing right away if the output is free
+        auto& queue = queues[0][output];
+        queue.push_back({std::move(chunk), output});
+        if (!output_busy[output]) {
+            start_transfer(-1, queue);
+        }
+        return;
+    }
+
+    // input-queued, enqueue at the input port the chunk arrived through
+    const auto input = input_of(*chunk);
+    const auto queue = (arbitration == SwitchArbitration::iSLIP) ? output : 0;
+    queues[input][queue].push_back({std::move(chunk), output});
+
+    // the new chunk may be matched immediately
+    if (!input_busy[input] && !output_busy[output]) {
+        arbitrate();
+    }
+}
+
+int Crossbar::input_of(const Chunk& chunk) noexcept {
+    assert(chunk.get_ingress_link() != nullptr);
+
+    const auto link_id = chunk.get_ingress_link()->get_id();
+    const auto it = input_of_link.find(link_id);
+    if (it != input_of_link.end()) {
+        return it->second;
+    }
+
+    // first chunk through this link, add a new input port
+    const auto input = static_cast<int>(queues.size());
+    input_of_link.emplace(link_id, input);
+    queues.emplace_back((arbitration == SwitchArbitration::iSLIP) ? output_links.size() : 1);
+    input_busy.push_back(false);
+    accept_pointer.push_back(0);
+    return input;
+}
+
+void Crossbar::arbitrate() noexcept {
+    switch (queueing) {
+    case SwitchQueueing::OutputQueued:
+        // every output serves its own queue
+        for (auto output = 0; output < output_links.size(); output++) {
+            if (!output_busy[output] && !queues[0][output].empty()) {
+                start_transfer(-1, queues[0][output]);
+            }
+        }
+        break;
+    case SwitchQueueing::InputQueued:
+        if (arbitration == SwitchArbitration::iSLIP) {
+            arbitrate_islip();
+        } else {
+            arbitrate_round_robin();
+        }
+        break;
+    default:
+        // shouldn't reach here
+        assert(false);
+    }
+}
+
+void Crossbar::arbitrate_round_robin() noexcept {
+    const auto inputs_count = static_cast<int>(queues.size());
+
+    for (auto output = 0; output < output_links.size(); output++) {
+        if (output_busy[output]) {
+            continue;
+        }
+
+        // grant the first free input, starting from the pointer, whose oldest chunk heads to this output
+        for (auto offset = 0; offset < inputs_count; offset++) {
+            const auto input = (grant_pointer[output] + offset) % inputs_count;
+            auto& queue = queues[input][0];
+            if (input_busy[input] || queue.empty() || queue.front().output != output) {
+                continue;
+            }
+
+            grant_pointer[output] = (input + 1) % inputs_count;
+            start_transfer(input, queue);
+            break;
+        }
+    }
+}
+
+void Crossbar::arbitrate_islip() noexcept {
+    const auto inputs_count = static_cast<int>(queues.size());
+    const auto outputs_count = static_cast<int>(output_links.size());
+    auto granted_input = std::vector<int>(outputs_count);
+
+    // iterate request-grant-accept rounds until no more ports get matched
+    for (auto iteration = 0;; iteration++) {
+        // grant: each free output grants the first requesting free input, starting from its pointer
+        auto granted = false;
+        for (auto output = 0; output < outputs_count; output++) {
+            granted_input[output] = -1;
+            if (output_busy[output]) {
+                continue;
+            }
+
+            for (auto offset = 0; offset < inputs_count; offset++) {
+                const auto input = (grant_pointer[output] + offset) % inputs_count;
+                if (!input_busy[input] && !queues[input][output].empty()) {
+                    granted_input[output] = input;
+                    granted = true;
+                    break;
+                }
+            }
+        }
+
+        if (!granted) {
+            break;
+        }
+
+        // accept: each input accepts the first granting output, starting from its pointer
+        for (auto input = 0; input < inputs_count; input++) {
+            for (auto offset = 0; offset < outputs_count; offset++) {
+                const auto output = (accept_pointer[input] + offset) % outputs_count;
+                if (granted_input[output] != input) {
+                    continue;
+                }
+
+                // pointers only move on the first iteration, which keeps iSLIP starvation-free
+                if (iteration == 0) {
+                    grant_pointer[output] = (input + 1) % inputs_count;
+                    accept_pointer[input] = (output + 1) % outputs_count;
+                }
+                start_transfer(input, queues[input][output]);
+                break;
+            }
+        }
+    }
+}
+
+void Crossbar::start_transfer(const int input, std::list<QueuedChunk>& queue) noexcept {
+    assert(!queue.empty());
+
+    auto chunk = std::move(queue.front().chunk);
+    const auto output = queue.front().output;
+    queue.pop_front();
+
+    // occupy the ports
+    assert(!output_busy[output]);
+    output_busy[output] = true;
+    if (input >= 0) {
+        assert(!input_busy[input]);
+        input_busy[input] = true;
+    }
+
+    // crossing takes at least 1 ns, so the transfer always finishes after it starts
+    const auto fabric_bandwidth = speedup * link_table->get_bandwidth_Bpns(output_links[output]);
+    const auto transfer_time =
+        std::max<EventTime>(1, static_cast<EventTime>(static_cast<Bandwidth>(chunk->get_size()) / fabric_bandwidth));
+
+    // schedule the end of the transfer
+    const auto finish_time = Crossbar::event_queue->get_current_time() + transfer_time;
+    auto* const transfer = new Transfer{this, input, output, std::move(chunk)};
+    Crossbar::event_queue->schedule_event(finish_time, transfer_finished, static_cast<void*>(transfer));
+}
@@ -5,14 +5,22 @@ LICENSE file in the root directory of this source tree.
 
 #include "congestion_aware/Device.h"
 #include "congestion_aware/Chunk.h"
+#include "congestion_aware/Crossbar.h"
 #include "congestion_aware/Link.h"
+#include "congestion_aware/LinkTable.h"
+#include "congestion_aware/NetworkInterface.h"
+#include "congestion_aware/ReductionEngine.h"
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 
 using namespace NetworkAnalyticalCongestionAware;
 
-Device::Device(const DeviceId id) noexcept : device_id(id) {
+Device::Device(const DeviceId id, std::shared_ptr<LinkTable> link_table) noexcept
+    : device_id(id),
+      link_table(std::move(link_table)) {
     assert(id >= 0);
+    assert(this->link_table != nullptr);
 }
 
 DeviceId Device::get_id() const noexcept {
@@ -31,16 +39,58 @@ void Device::send(std::unique_ptr<Chunk> chunk) noexcept {
     // assert the chunk hasn't arrived its final destination yet
     assert(!chunk->arrived_dest());
 
+    // a contribution to an in-network reduction waits for the other contributions here
+    if (reduction_engine != nullptr && chunk->get_reduction_group() >= 0) {
+        reduction_engine->reduce(std::move(chunk));
+        return;
+    }
+
     // get next dest
     const auto next_dest = chunk->next_device();
     const auto next_dest_id = next_dest->get_id();
     //std::cout<<"source:" << device_id <<"dest node:" << next_dest_id << std::endl;
-    // assert the next dest is connected to this node
-    assert(connected(next_dest_id));
+    // find the port to the next dest
+    auto port = find_port(next_dest_id);
+    assert(port >= 0);
+
+    // a chunk heading to a dead link is rerouted from this device, if any route is left
+    if (link_table->is_dead(port_links[port]) && link_table->reroute(*chunk)) {
+        port = find_port(chunk->next_device()->get_id());
+        assert(port >= 0);
+    }
+
+    // a chunk passing through a contended fabric crosses it first
+    if (crossbar != nullptr && chunk->get_ingress_link() != nullptr) {
+        crossbar->send(std::move(chunk), port);
+        return;
+    }
+
+    // a chunk originating from this device is injected by its network interface
+    if (network_interface != nullptr && chunk->get_ingress_link() == nullptr) {
+        network_interface->inject(std::move(chunk), port_links[port]);
+        return;
+    }
 
     // send the chunk to the next dest
     // delegate this task to the link
-    links[next_dest_id]->send(std::move(chunk));
+    link_table->at(port_links[port]).send(std::move(chunk));
+}
+
+void Device::receive(std::unique_ptr<Chunk> chunk) noexcept {
+    // assert the validity of the chunk
+    assert(chunk != nullptr);
+
+    // assert this node is the dest of the chunk
+    assert(chunk->arrived_dest());
+    assert(chunk->current_device()->get_id() == device_id);
+
+    // the network interface writes the chunk out first
+    if (network_interface != nullptr) {
+        network_interface->eject(std::move(chunk));
+        return;
+    }
+
+    chunk->deliver();
 }
 
 void Device::connect(const DeviceId id, const Bandwidth bandwidth, const Latency latency) noexcept {
@@ -56,12 +106,103 @@ void Device::connect(const DeviceId id, const Bandwidth bandwidth, const Latency
     }
 
     // create link
-    links[id] = std::make_shared<Link>(bandwidth, latency);
+    const auto link_id = link_table->add_link(device_id, id, bandwidth, latency);
+    add_port(id, link_id);
+}
+
+void Device::attach(const DeviceId id, const LinkId link_id) noexcept {
+    assert(id >= 0);
+    assert(link_id < link_table->get_links_count());
+
+    // assert there's no existing connection
+    assert(!connected(id));
+
+    add_port(id, link_id);
+}
+
+int Device::get_ports_count() const noexcept {
+    return static_cast<int>(port_dests.size());
+}
+
+void Device::reserve_ports(const int ports_count) noexcept {
+    assert(ports_count >= 0);
+
+    port_dests.reserve(ports_count);
+    port_links.reserve(ports_count);
+}
+
+const std::vector<DeviceId>& Device::get_port_dests() const noexcept {
+    return port_dests;
+}
+
+const std::vector<LinkId>& Device::get_port_links() const noexcept {
+    return port_links;
+}
+
+void Device::set_crossbar(const SwitchQueueing queueing,
+                          const SwitchArbitration arbitration,
+                          const double speedup) noexcept {
+    assert(speedup > 0);
+
+    // an ideal fabric, or a device without output ports, never contends
+    if (queueing == SwitchQueueing::Ideal || port_links.empty()) {
+        crossbar = nullptr;
+        return;
+    }
+
+    crossbar = std::make_shared<Crossbar>(link_table.get(), port_links, queueing, arbitration, speedup);
+}
+
+void Device::set_network_interface(const Bandwidth injection_bandwidth,
+                                   const Bandwidth ejection_bandwidth,
+                                   const int dma_engines,
+                                   const NicScheduling scheduling) noexcept {
+    assert(injection_bandwidth >= 0);
+    assert(ejection_bandwidth >= 0);
+    assert(dma_engines > 0);
+
+    network_interface = std::make_shared<NetworkInterface>(link_table.get(), injection_bandwidth,
+                                                           ejection_bandwidth, dma_engines, scheduling);
+}
+
+void Device::set_reduction_engine(const Bandwidth throughput) noexcept {
+    assert(throughput >= 0);
+
+    reduction_engine = std::make_shared<ReductionEngine>(this, throughput);
+}
+
+Link& Device::get_link(const DeviceId dest) const noexcept {
+    return link_table->at(get_link_id(dest));
+}
+
+LinkId Device::get_link_id(const DeviceId dest) const noexcept {
+    // assert the dest is connected to this node
+    assert(connected(dest));
+
+    return port_links[find_port(dest)];
 }
 
 bool Device::connected(const DeviceId dest) const noexcept {
     assert(dest >= 0);
 
     // check whether the connection exists
-    return links.find(dest) != links.end();
+    return find_port(dest) >= 0;
+}
+
+int Device::find_port(const DeviceId dest) const noexcept {
+    // binary search over the sorted port destinations
+    const auto it = std::lower_bound(port_dests.begin(), port_dests.end(), dest);
+    if (it == port_dests.end() || *it != dest) {
+        return -1;
+    }
+
+    return static_cast<int>(it - port_dests.begin());
+}
+
+void Device::add_port(const DeviceId dest, const LinkId link_id) noexcept {
+    // ports are mostly added in increasing dest order, making this an append
+    const auto it = std::upper_bound(port_dests.begin(), port_dests.end(), dest);
+    const auto index = it - port_dests.begin();
+    port_dests.insert(it, dest);
+    port_links.insert(port_links.begin() + index, link_id);
 }
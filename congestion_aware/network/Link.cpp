@@ -4,10 +4,13 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "congestion_aware/Link.h"
-#include "common/NetworkFunction.h"
 #include "congestion_aware/Chunk.h"
 #include "congestion_aware/Device.h"
+#include "congestion_aware/LinkTable.h"
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <limits>
 
 using namespace NetworkAnalytical;
 using namespace NetworkAnalyticalCongestionAware;
@@ -24,9 +27,22 @@ void Link::link_become_free(void* const link_ptr) noexcept {
     // set link free
     link->set_free();
 
+    // the serialized chunk left the upstream device, return its credits
+    auto* const ingress_link = link->serializing_chunk_ingress_link;
+    const auto serialized_chunk_size = link->serializing_chunk_size;
+    const auto serialized_chunk_traffic_class = link->serializing_chunk_traffic_class;
+    link->serializing_chunk_ingress_link = nullptr;
+
     // process pending chunks if one exist
-    if (link->pending_chunk_exists()) {
+    if (link->pending_chunk_sendable()) {
         link->process_pending_transmission();
+    } else if (!link->pending_chunk_exists()) {
+        // link becomes idle
+        link->stats().last_idle_time = Link::event_queue->get_current_time();
+    }
+
+    if (ingress_link != nullptr) {
+        ingress_link->return_credits(serialized_chunk_size, serialized_chunk_traffic_class);
     }
 }
 
@@ -37,26 +53,199 @@ void Link::set_event_queue(std::shared_ptr<EventQueue> event_queue_ptr) noexcept
     Link::event_queue = std::move(event_queue_ptr);
 }
 
-Link::Link(const Bandwidth bandwidth, const Latency latency) noexcept
-    : bandwidth(bandwidth),
-      latency(latency),
-      pending_chunks(),
-      busy(false) {
-    assert(bandwidth > 0);
-    assert(latency >= 0);
+Link::Link(LinkTable* const link_table, const LinkId link_id) noexcept
+    : health(1),
+      pending_chunks(1),
+      vcs_count(1),
+      ports_count(1),
+      pending_chunks_count(0),
+      vc_arbitration(VirtualChannelArbitration::StrictPriority),
+      wrr_current_vc(0),
+      wrr_remaining_quota(0),
+      link_table(link_table),
+      link_id(link_id),
+      input_buffer_size(0),
+      serializing_chunk_ingress_link(nullptr),
+      serializing_chunk_size(0),
+      serializing_chunk_traffic_class(0) {
+    assert(link_table != nullptr);
+}
+
+LinkId Link::get_id() const noexcept {
+    return link_id;
+}
+
+void Link::set_health(const double health) noexcept {
+    assert(health >= 0);
+
+    const auto restored = is_dead() && health > 0;
+    this->health = health;
+
+    // the chunks parked on a dead link resume once restored
+    if (restored && pending_chunk_sendable()) {
+        process_pending_transmission();
+    }
+}
+
+double Link::get_health() const noexcept {
+    return health;
+}
+
+bool Link::is_dead() const noexcept {
+    return health == 0;
+}
+
+std::vector<std::unique_ptr<Chunk>> Link::take_pending_chunks() noexcept {
+    auto chunks = std::vector<std::unique_ptr<Chunk>>();
+    chunks.reserve(pending_chunks_count);
 
-    // convert bandwidth from GB/s to B/ns
-    bandwidth_Bpns = bw_GBps_to_Bpns(bandwidth);
+    // account the time each chunk waited in the queue
+    const auto current_time = Link::event_queue->get_current_time();
+    for (auto& queue : pending_chunks) {
+        for (auto& pending_chunk : queue) {
+            stats().queueing_time += current_time - pending_chunk.enqueue_time;
+            chunks.push_back(std::move(pending_chunk.chunk));
+        }
+        queue.clear();
+    }
+    if (input_buffer_size > 0) {
+        link_table->update_credit_waiting_chunks(-static_cast<int64_t>(pending_chunks_count));
+    }
+    pending_chunks_count = 0;
+
+    return chunks;
+}
+
+void Link::set_input_buffer_size(const ChunkSize buffer_size) noexcept {
+    // buffer size can only be set before any traffic
+    assert(std::all_of(buffered_bytes.begin(), buffered_bytes.end(), [](const auto bytes) { return bytes == 0; }));
+
+    input_buffer_size = buffer_size;
+
+    // only bounded buffers track their occupancy
+    buffered_bytes = (input_buffer_size > 0) ? std::vector<ChunkSize>(vcs_count, 0) : std::vector<ChunkSize>();
+}
+
+void Link::set_virtual_channels(const int vcs_count,
+                                const VirtualChannelArbitration arbitration,
+                                std::vector<int> weights) noexcept {
+    assert(vcs_count > 0);
+    assert(weights.size() == vcs_count);
+    assert(std::all_of(weights.begin(), weights.end(), [](const auto weight) { return weight > 0; }));
+
+    // virtual channels can only be set before any traffic
+    assert(!is_busy());
+    assert(pending_chunks_count == 0);
+
+    this->vcs_count = vcs_count;
+    if (input_buffer_size > 0) {
+        buffered_bytes = std::vector<ChunkSize>(vcs_count, 0);
+    }
+    vc_arbitration = arbitration;
+    vc_weights = std::move(weights);
+    wrr_current_vc = 0;
+    wrr_remaining_quota = 0;
+    reset_pending_queues();
+}
+
+void Link::set_round_robin_ports(const std::vector<DeviceId>& device_ids) noexcept {
+    assert(!device_ids.empty());
+
+    // ports can only be set before any traffic
+    assert(!is_busy());
+    assert(pending_chunks_count == 0);
+
+    port_of_device.clear();
+    for (const auto device_id : device_ids) {
+        assert(port_of_device.find(device_id) == port_of_device.end());
+        port_of_device[device_id] = static_cast<int>(port_of_device.size());
+    }
+    ports_count = static_cast<int>(device_ids.size());
+    reset_pending_queues();
+}
+
+void Link::reset_pending_queues() noexcept {
+    pending_chunks = std::vector<std::list<PendingChunk>>(vcs_count * ports_count);
+    next_port = (ports_count > 1) ? std::vector<int>(vcs_count, 0) : std::vector<int>();
+}
+
+bool Link::is_busy() const noexcept {
+    return link_table->is_busy(link_id);
+}
+
+LinkStats& Link::stats() noexcept {
+    return link_table->update_link_stats(link_id);
+}
+
+void Link::set_error_model(const double bit_error_rate,
+                           const double packet_error_rate,
+                           const Retransmission retransmission,
+                           const int window,
+                           const uint64_t seed) noexcept {
+    assert(0 <= bit_error_rate && bit_error_rate < 1);
+    assert(0 <= packet_error_rate && packet_error_rate < 1);
+    assert(window > 0);
+
+    // an error-free link skips drawing random numbers
+    if (bit_error_rate == 0 && packet_error_rate == 0) {
+        error_model = nullptr;
+        return;
+    }
+
+    // derive a distinct stream per each link
+    const auto rng_state = seed ^ (0x9E3779B97F4A7C15ULL * (static_cast<uint64_t>(link_id) + 1));
+    error_model = std::make_unique<ErrorModel>(
+        ErrorModel{bit_error_rate, packet_error_rate, retransmission, window, rng_state});
+}
+
+void Link::return_credits(const ChunkSize chunk_size, const TrafficClass traffic_class) noexcept {
+    // unbounded buffer, nothing to track
+    if (input_buffer_size == 0) {
+        return;
+    }
+
+    const auto vc = virtual_channel_of(traffic_class);
+    assert(buffered_bytes[vc] >= chunk_size);
+    buffered_bytes[vc] -= chunk_size;
+
+    // a pending chunk may have been waiting for the credits
+    if (pending_chunk_sendable()) {
+        process_pending_transmission();
+    }
 }
 
 void Link::send(std::unique_ptr<Chunk> chunk) noexcept {
     assert(chunk != nullptr);
 
-    if (busy) {
-        // link is busy, add to pending chunks
-        pending_chunks.push_back(std::move(chunk));
+    // a chunk reaching a dead link, e.g., out of a crossbar, is rerouted from its current device
+    if (is_dead() && link_table->reroute(*chunk)) {
+        const auto current_device = chunk->current_device();
+        current_device->send(std::move(chunk));
+        return;
+    }
+
+    const auto vc = virtual_channel_of(chunk->get_traffic_class());
+    const auto port = port_of(*chunk);
+    const auto queue = queue_of(vc, port);
+
+    // other queues being blocked by flow control doesn't block this chunk
+    if (is_busy() || is_dead() || !pending_chunks[queue].empty() || !has_credits(chunk->get_size(), vc)) {
+        // link is busy, dead, or blocked by flow control, add to pending chunks
+        const auto current_time = Link::event_queue->get_current_time();
+        pending_chunks[queue].push_back({std::move(chunk), current_time});
+        pending_chunks_count++;
+        if (input_buffer_size > 0) {
+            link_table->update_credit_waiting_chunks(1);
+        }
+
+        // update pending depth
+        auto& link_stats = stats();
+        link_stats.max_pending_chunks = std::max(link_stats.max_pending_chunks, pending_chunks_count);
     } else {
-        // service this chunk immediately
+        // service this chunk immediately, passing the round-robin turn to the next port
+        if (ports_count > 1) {
+            next_port[vc] = (port + 1) % ports_count;
+        }
         schedule_chunk_transmission(std::move(chunk));
     }
 }
@@ -65,9 +254,38 @@ void Link::process_pending_transmission() noexcept {
     // pending chunk should exist
     assert(pending_chunk_exists());
 
+    // pick the virtual channel, then the input port to serve
+    const auto vc = select_virtual_channel();
+    assert(vc >= 0);
+    const auto port = select_port(vc);
+    assert(port >= 0);
+    if (ports_count > 1) {
+        next_port[vc] = (port + 1) % ports_count;
+    }
+    const auto queue = queue_of(vc, port);
+
+    // consume the WeightedRoundRobin quota, starting a new turn if the channel changed
+    if (vc_arbitration == VirtualChannelArbitration::WeightedRoundRobin) {
+        if (vc == wrr_current_vc && wrr_remaining_quota > 0) {
+            wrr_remaining_quota--;
+        } else {
+            wrr_current_vc = vc;
+            wrr_remaining_quota = vc_weights[vc] - 1;
+        }
+    }
+
     // get chunk to process
-    auto chunk = std::move(pending_chunks.front());
-    pending_chunks.pop_front();
+    auto chunk = std::move(pending_chunks[queue].front().chunk);
+    const auto enqueue_time = pending_chunks[queue].front().enqueue_time;
+    pending_chunks[queue].pop_front();
+    pending_chunks_count--;
+    if (input_buffer_size > 0) {
+        link_table->update_credit_waiting_chunks(-1);
+    }
+
+    // account the time the chunk waited in the queue
+    const auto current_time = Link::event_queue->get_current_time();
+    stats().queueing_time += current_time - enqueue_time;
 
     // service this chunk
     schedule_chunk_transmission(std::move(chunk));
@@ -75,44 +293,231 @@ void Link::process_pending_transmission() noexcept {
 
 bool Link::pending_chunk_exists() const noexcept {
     // check pending chunks is not empty
-    return !pending_chunks.empty();
+    return pending_chunks_count > 0;
+}
+
+uint64_t Link::get_pending_chunks_count() const noexcept {
+    return pending_chunks_count;
+}
+
+int Link::virtual_channel_of(const TrafficClass traffic_class) const noexcept {
+    assert(traffic_class >= 0);
+
+    // classes beyond the last virtual channel share it
+    return std::min(traffic_class, vcs_count - 1);
+}
+
+int Link::port_of(const Chunk& chunk) const noexcept {
+    // single-port link
+    if (ports_count == 1) {
+        return 0;
+    }
+
+    // the chunk enters through the port of the device currently holding it
+    const auto it = port_of_device.find(chunk.current_device()->get_id());
+    assert(it != port_of_device.end());
+    return it->second;
+}
+
+int Link::queue_of(const int vc, const int port) const noexcept {
+    assert(0 <= vc && vc < vcs_count);
+    assert(0 <= port && port < ports_count);
+
+    return vc * ports_count + port;
+}
+
+int Link::select_port(const int vc) const noexcept {
+    // check every port once, starting from the next one in round-robin order
+    const auto first_port = (ports_count > 1) ? next_port[vc] : 0;
+    for (auto i = 0; i < ports_count; i++) {
+        const auto port = (first_port + i) % ports_count;
+        const auto& queue = pending_chunks[queue_of(vc, port)];
+        if (!queue.empty() && has_credits(queue.front().chunk->get_size(), vc)) {
+            return port;
+        }
+    }
+    return -1;
+}
+
+bool Link::has_credits(const ChunkSize chunk_size, const int vc) const noexcept {
+    // unbounded buffer
+    if (input_buffer_size == 0) {
+        return true;
+    }
+
+    // an empty buffer accepts any chunk, even one larger than the buffer
+    return buffered_bytes[vc] == 0 || buffered_bytes[vc] + chunk_size <= input_buffer_size;
+}
+
+bool Link::vc_sendable(const int vc) const noexcept {
+    return select_port(vc) >= 0;
+}
+
+int Link::select_virtual_channel() const noexcept {
+    if (vc_arbitration == VirtualChannelArbitration::StrictPriority) {
+        // the highest sendable virtual channel wins
+        for (auto vc = vcs_count - 1; vc >= 0; vc--) {
+            if (vc_sendable(vc)) {
+                return vc;
+            }
+        }
+        return -1;
+    }
+
+    // WeightedRoundRobin: keep serving the current channel while its turn lasts
+    if (wrr_remaining_quota > 0 && vc_sendable(wrr_current_vc)) {
+        return wrr_current_vc;
+    }
+
+    // otherwise, hand the turn over to the next sendable channel
+    for (auto i = 1; i <= vcs_count; i++) {
+        const auto vc = (wrr_current_vc + i) % vcs_count;
+        if (vc_sendable(vc)) {
+            return vc;
+        }
+    }
+    return -1;
+}
+
+bool Link::pending_chunk_sendable() const noexcept {
+    return !is_busy() && !is_dead() && pending_chunk_exists() && select_virtual_channel() >= 0;
 }
 
 void Link::set_busy() noexcept {
     // set busy to true
-    busy = true;
+    link_table->set_busy(link_id, true);
 }
 
 void Link::set_free() noexcept {
     // set busy to false
-    busy = false;
+    link_table->set_busy(link_id, false);
+}
+
+void Link::add_bandwidth_step(const EventTime time, const double scale) noexcept {
+    assert(scale > 0);
+
+    // keep the schedule sorted by time
+    const auto step = std::make_pair(time, link_table->get_bandwidth_Bpns(link_id) * scale);
+    const auto it = std::upper_bound(bandwidth_schedule.begin(), bandwidth_schedule.end(), step,
+                                     [](const auto& a, const auto& b) { return a.first < b.first; });
+    bandwidth_schedule.insert(it, step);
+}
+
+void Link::add_health_step(const EventTime time, const double health) noexcept {
+    assert(health >= 0);
+
+    // keep the schedule sorted by time
+    const auto step = std::make_pair(time, health);
+    const auto it = std::upper_bound(health_schedule.begin(), health_schedule.end(), step,
+                                     [](const auto& a, const auto& b) { return a.first < b.first; });
+    health_schedule.insert(it, step);
+}
+
+double Link::exact_serialization_time(const ChunkSize chunk_size, const EventTime start_time) const noexcept {
+    assert(chunk_size > 0);
+
+    // constant bandwidth, derated by the health of the link
+    assert(!is_dead());
+    const auto bandwidth_Bpns = link_table->get_bandwidth_Bpns(link_id);
+    if (bandwidth_schedule.empty() && health_schedule.empty()) {
+        return static_cast<Bandwidth>(chunk_size) / (bandwidth_Bpns * health);
+    }
+
+    // find the first steps taking effect after start_time
+    const auto after = [](const EventTime time, const auto& step) { return time < step.first; };
+    auto next_step = std::upper_bound(bandwidth_schedule.begin(), bandwidth_schedule.end(), start_time, after);
+    auto next_health_step = std::upper_bound(health_schedule.begin(), health_schedule.end(), start_time, after);
+
+    // bandwidth and health in effect at start_time, the link dying only after the transmission
+    auto current_bandwidth = (next_step == bandwidth_schedule.begin()) ? bandwidth_Bpns : std::prev(next_step)->second;
+    auto current_health = health;
+    for (auto it = health_schedule.begin(); it != next_health_step; it++) {
+        current_health = (it->second > 0) ? it->second : current_health;
+    }
+
+    // serialize segment by segment until the whole chunk is sent
+    auto remaining_bytes = static_cast<double>(chunk_size);
+    auto current_time = static_cast<double>(start_time);
+    while (next_step != bandwidth_schedule.end() || next_health_step != health_schedule.end()) {
+        // bytes that can be sent before the next step takes effect
+        const auto next_time = std::min(
+            (next_step != bandwidth_schedule.end()) ? next_step->first : std::numeric_limits<EventTime>::max(),
+            (next_health_step != health_schedule.end()) ? next_health_step->first
+                                                        : std::numeric_limits<EventTime>::max());
+        const auto segment_bytes =
+            (static_cast<double>(next_time) - current_time) * current_bandwidth * current_health;
+        if (remaining_bytes <= segment_bytes) {
+            break;
+        }
+
+        // move on to the next steps
+        remaining_bytes -= segment_bytes;
+        current_time = static_cast<double>(next_time);
+        for (; next_step != bandwidth_schedule.end() && next_step->first == next_time; next_step++) {
+            current_bandwidth = next_step->second;
+        }
+        for (; next_health_step != health_schedule.end() && next_health_step->first == next_time;
+             next_health_step++) {
+            current_health = (next_health_step->second > 0) ? next_health_step->second : current_health;
+        }
+    }
+
+    // serialize the leftover bytes at the last bandwidth
+    current_time += remaining_bytes / (current_bandwidth * current_health);
+    return current_time - static_cast<double>(start_time);
 }
 
-EventTime Link::serialization_delay(const ChunkSize chunk_size) const noexcept {
+EventTime Link::serialization_delay(const ChunkSize chunk_size, const EventTime start_time) const noexcept {
     assert(chunk_size > 0);
 
     // calculate serialization delay
-    const auto delay = static_cast<Bandwidth>(chunk_size) / bandwidth_Bpns;
+    const auto delay = exact_serialization_time(chunk_size, start_time);
 
     // return serialization delay in EventTime type
     return static_cast<EventTime>(delay);
 }
 
-EventTime Link::communication_delay(const ChunkSize chunk_size) const noexcept {
+EventTime Link::communication_delay(const ChunkSize chunk_size, const EventTime start_time) const noexcept {
     assert(chunk_size > 0);
 
     // calculate communication delay
-    const auto delay = latency + (static_cast<Bandwidth>(chunk_size) / bandwidth_Bpns);
+    const auto delay = link_table->get_latency(link_id) + exact_serialization_time(chunk_size, start_time);
 
     // return communication delay in EventTime type
     return static_cast<EventTime>(delay);
 }
 
+uint64_t Link::draw_corrupted_transmissions(const ChunkSize chunk_size) noexcept {
+    assert(error_model != nullptr);
+
+    // probability that a transmission of the chunk gets corrupted
+    const auto bits = 8.0 * static_cast<double>(chunk_size);
+    const auto intact_probability =
+        (1 - error_model->packet_error_rate) * std::exp(bits * std::log1p(-error_model->bit_error_rate));
+    const auto error_probability = 1 - intact_probability;
+
+    // draw uniform numbers in [0, 1) from a splitmix64 stream until a transmission goes through
+    auto corrupted_transmissions = uint64_t{0};
+    while (true) {
+        error_model->rng_state += 0x9E3779B97F4A7C15ULL;
+        auto z = error_model->rng_state;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        z = z ^ (z >> 31);
+        const auto uniform = static_cast<double>(z >> 11) * 0x1.0p-53;
+
+        if (uniform >= error_probability) {
+            return corrupted_transmissions;
+        }
+        corrupted_transmissions++;
+    }
+}
+
 void Link::schedule_chunk_transmission(std::unique_ptr<Chunk> chunk) noexcept {
     assert(chunk != nullptr);
 
     // link should be free
-    assert(!busy);
+    assert(!is_busy());
 
     // set link busy
     set_busy();
@@ -121,15 +526,64 @@ void Link::schedule_chunk_transmission(std::unique_ptr<Chunk> chunk) noexcept {
     const auto chunk_size = chunk->get_size();
     const auto current_time = Link::event_queue->get_current_time();
 
+    // take credits from the downstream buffer,
+    // and remember where the chunk came from to return its credits once serialized
+    const auto traffic_class = chunk->get_traffic_class();
+    if (input_buffer_size > 0) {
+        const auto vc = virtual_channel_of(traffic_class);
+        assert(has_credits(chunk_size, vc));
+        buffered_bytes[vc] += chunk_size;
+    }
+    serializing_chunk_ingress_link = chunk->get_ingress_link();
+    serializing_chunk_size = chunk_size;
+    serializing_chunk_traffic_class = traffic_class;
+    chunk->set_ingress_link(this);
+
+    // forget the health changes already in effect
+    health_schedule.erase(health_schedule.begin(),
+                          std::lower_bound(health_schedule.begin(), health_schedule.end(), current_time,
+                                           [](const auto& step, const EventTime time) { return step.first < time; }));
+
+    // pay for the retransmissions of a corrupted chunk, each serialized at the bandwidth and health
+    // in effect once the previous transmission got serialized and its corruption detected a round trip later
+    const auto corrupted_transmissions = (error_model != nullptr) ? draw_corrupted_transmissions(chunk_size) : 0;
+    const auto round_trip_time = static_cast<EventTime>(2 * link_table->get_latency(link_id));
+    auto transmission_start_time = current_time;
+    auto serialization_time = EventTime{0};
+    for (auto i = uint64_t{0}; i < corrupted_transmissions; i++) {
+        const auto transmission_serialization_time = serialization_delay(chunk_size, transmission_start_time);
+
+        // go-back-n also discards the chunks sent in the meantime, up to the window
+        auto wasted_serializations = EventTime{1};
+        if (error_model->retransmission == Retransmission::GoBackN) {
+            const auto window = static_cast<EventTime>(error_model->window);
+            wasted_serializations +=
+                std::min(window - 1, round_trip_time / std::max<EventTime>(transmission_serialization_time, 1));
+        }
+
+        serialization_time += wasted_serializations * transmission_serialization_time;
+        transmission_start_time += transmission_serialization_time + round_trip_time;
+    }
+
+    // then the intact transmission goes through
+    const auto communication_time =
+        (transmission_start_time - current_time) + communication_delay(chunk_size, transmission_start_time);
+    serialization_time += serialization_delay(chunk_size, transmission_start_time);
+
     // schedule chunk arrival event
-    const auto communication_time = communication_delay(chunk_size);
     const auto chunk_arrival_time = current_time + communication_time;
     auto* const chunk_ptr = static_cast<void*>(chunk.release());
     Link::event_queue->schedule_event(chunk_arrival_time, Chunk::chunk_arrived_next_device, chunk_ptr);
 
     // schedule link free time
-    const auto serialization_time = serialization_delay(chunk_size);
     const auto link_free_time = current_time + serialization_time;
     auto* const link_ptr = static_cast<void*>(this);
     Link::event_queue->schedule_event(link_free_time, link_become_free, link_ptr);
+
+    // update traffic counters
+    auto& link_stats = stats();
+    link_stats.bytes_sent += (1 + corrupted_transmissions) * chunk_size;
+    link_stats.chunks_sent++;
+    link_stats.retransmissions += corrupted_transmissions;
+    link_stats.busy_time += serialization_time;
 }
@@ -0,0 +1,142 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/LinkStats.h"
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+
+using namespace NetworkAnalyticalCongestionAware;
+
+LinkStatsTable::LinkStatsTable() noexcept {
+    // create empty table
+    stats = {};
+    endpoints = {};
+    link_ids = {};
+}
+
+LinkId LinkStatsTable::register_links(const int links_count) noexcept {
+    assert(links_count >= 0);
+    assert(stats.size() == endpoints.size());
+    assert(link_ids.empty());
+
+    // allocate zero-initialized counters for the new links
+    const auto first_link_id = static_cast<LinkId>(stats.size());
+    stats.resize(stats.size() + links_count);
+    endpoints.resize(endpoints.size() + links_count, {-1, -1});
+
+    return first_link_id;
+}
+
+void LinkStatsTable::set_endpoints(const LinkId link_id, const DeviceId src, const DeviceId dest) noexcept {
+    assert(link_id < endpoints.size());
+    assert(src >= -1);
+    assert(dest >= -1);
+
+    endpoints[link_id] = {src, dest};
+}
+
+std::pair<DeviceId, DeviceId> LinkStatsTable::get_endpoints(const uint32_t slot) const noexcept {
+    assert(slot < endpoints.size());
+
+    return endpoints[slot];
+}
+
+uint32_t LinkStatsTable::register_sparse_link(const LinkId link_id, const DeviceId src, const DeviceId dest) noexcept {
+    assert(src >= -1);
+    assert(dest >= -1);
+    assert(link_ids.size() == stats.size());
+
+    // allocate zero-initialized counters in the next slot
+    const auto slot = static_cast<uint32_t>(stats.size());
+    stats.emplace_back();
+    endpoints.emplace_back(src, dest);
+    link_ids.push_back(link_id);
+
+    return slot;
+}
+
+LinkStats& LinkStatsTable::at(const uint32_t slot) noexcept {
+    assert(slot < stats.size());
+
+    return stats[slot];
+}
+
+const LinkStats& LinkStatsTable::at(const uint32_t slot) const noexcept {
+    assert(slot < stats.size());
+
+    return stats[slot];
+}
+
+int LinkStatsTable::get_links_count() const noexcept {
+    return static_cast<int>(stats.size());
+}
+
+void LinkStatsTable::dump_csv(std::ostream& os, const EventTime elapsed_time) const noexcept {
+    // header
+    os << "link_id,src,dest,bytes_sent,chunks_sent,retransmissions,busy_time_ns,queueing_time_ns,max_pending_chunks,"
+          "last_idle_time_ns,utilization"
+       << std::endl;
+
+    // one row per link
+    for (const auto slot : slots_by_link_id()) {
+        const auto link_id = link_ids.empty() ? slot : link_ids[slot];
+        const auto& link_stats = stats[slot];
+        const auto& [src, dest] = endpoints[slot];
+
+        os << link_id << "," << src << "," << dest << "," << link_stats.bytes_sent << "," << link_stats.chunks_sent
+           << "," << link_stats.retransmissions << "," << link_stats.busy_time << "," << link_stats.queueing_time << ","
+           << link_stats.max_pending_chunks << "," << link_stats.last_idle_time << ","
+           << utilization(slot, elapsed_time) << std::endl;
+    }
+}
+
+void LinkStatsTable::dump_json(std::ostream& os, const EventTime elapsed_time) const noexcept {
+    os << "{\"elapsed_time_ns\": " << elapsed_time << ", \"links\": [";
+
+    // one object per link
+    auto first = true;
+    for (const auto slot : slots_by_link_id()) {
+        const auto link_id = link_ids.empty() ? slot : link_ids[slot];
+        const auto& link_stats = stats[slot];
+        const auto& [src, dest] = endpoints[slot];
+
+        if (!first) {
+            os << ", ";
+        }
+        first = false;
+        os << "{\"link_id\": " << link_id << ", \"src\": " << src << ", \"dest\": " << dest
+           << ", \"bytes_sent\": " << link_stats.bytes_sent << ", \"chunks_sent\": " << link_stats.chunks_sent
+           << ", \"retransmissions\": " << link_stats.retransmissions << ", \"busy_time_ns\": " << link_stats.busy_time << ", \"queueing_time_ns\": " << link_stats.queueing_time
+           << ", \"max_pending_chunks\": " << link_stats.max_pending_chunks
+           << ", \"last_idle_time_ns\": " << link_stats.last_idle_time
+           << ", \"utilization\": " << utilization(slot, elapsed_time) << "}";
+    }
+
+    os << "]}" << std::endl;
+}
+
+std::vector<uint32_t> LinkStatsTable::slots_by_link_id() const noexcept {
+    auto slots = std::vector<uint32_t>(stats.size());
+    std::iota(slots.begin(), slots.end(), 0);
+
+    // sparse links are registered in the order they were first used
+    if (!link_ids.empty()) {
+        std::sort(slots.begin(), slots.end(), [this](const auto a, const auto b) { return link_ids[a] < link_ids[b]; });
+    }
+
+    return slots;
+}
+
+double LinkStatsTable::utilization(const uint32_t slot, const EventTime elapsed_time) const noexcept {
+    assert(slot < stats.size());
+
+    // no time has elapsed yet
+    if (elapsed_time == 0) {
+        return 0.0;
+    }
+
+    return static_cast<double>(stats[slot].busy_time) / static_cast<double>(elapsed_time);
+}
@@ -0,0 +1,447 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/LinkTable.h"
+#include "common/NetworkFunction.h"
+#include "congestion_aware/Chunk.h"
+#include "congestion_aware/Device.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+
+using namespace NetworkAnalyticalCongestionAware;
+
+// declaring static total_credit_waiting_chunks
+uint64_t LinkTable::total_credit_waiting_chunks = 0;
+
+LinkTable::LinkTable() noexcept
+    : lazy(false),
+      describer(nullptr),
+      rerouter(nullptr),
+      dead_links_count(0),
+      setups_count(0),
+      credit_waiting_chunks(0) {
+    // create empty table
+    slot_of_link = {};
+    busy = {};
+    bandwidth_Bpns = {};
+    latency = {};
+    link_objects = {};
+    range_setups = {};
+    link_setups = {};
+}
+
+LinkTable::~LinkTable() noexcept {
+    // the chunks of a discarded table aren't waiting anymore
+    assert(total_credit_waiting_chunks >= credit_waiting_chunks);
+    total_credit_waiting_chunks -= credit_waiting_chunks;
+}
+
+void LinkTable::check_deadlock(void* const arg) noexcept {
+    if (total_credit_waiting_chunks == 0) {
+        return;
+    }
+
+    // no event is left to free the input buffers, e.g., cyclic buffer dependencies around a ring
+    std::cerr << "[Error] (network/analytical/congestion_aware) "
+              << "credit deadlock, " << total_credit_waiting_chunks
+              << " chunks are blocked waiting for input buffer credits with no event left" << std::endl;
+    std::exit(-1);
+}
+
+void LinkTable::set_lazy(const bool lazy) noexcept {
+    // an implicit table is always lazy
+    assert(lazy || describer == nullptr);
+
+    const auto was_lazy = this->lazy;
+    this->lazy = lazy;
+
+    if (lazy) {
+        // health changes at runtime, after the table got lazy
+        assert(dead_links_count == 0);
+
+        // an eager table doesn't record its setups, so the links it already set up keep their Link object
+        if (!was_lazy && setups_count > 0) {
+            return;
+        }
+
+        // release every Link object, their setups being replayed once materialized again
+        for (auto slot = uint32_t{0}; slot < link_objects.size(); slot++) {
+            assert(busy[slot] == 0);
+            link_objects[slot] = nullptr;
+        }
+        links.clear();
+    } else {
+        for (auto link_id = LinkId{0}; link_id < link_objects.size(); link_id++) {
+            if (link_objects[link_id] == nullptr) {
+                materialize(link_id);
+            }
+        }
+
+        // every link got its setups, so they don't need to be kept anymore
+        range_setups.clear();
+        link_setups.clear();
+    }
+}
+
+void LinkTable::set_implicit(LinkDescriber describer) noexcept {
+    assert(describer != nullptr);
+    assert(get_links_count() == 0);
+
+    this->describer = std::move(describer);
+    lazy = true;
+}
+
+LinkId LinkTable::add_link(const DeviceId src,
+                           const DeviceId dest,
+                           const Bandwidth bandwidth,
+                           const Latency latency) noexcept {
+    const auto link_id = add_links(1);
+    init_link(link_id, src, dest, bandwidth, latency);
+
+    return link_id;
+}
+
+LinkId LinkTable::add_links(const int links_count) noexcept {
+    assert(links_count >= 0);
+
+    // an implicit table only reserves the ids, allocating the state of each link once materialized
+    if (describer != nullptr) {
+        const auto first_link_id = static_cast<LinkId>(slot_of_link.size());
+        slot_of_link.resize(slot_of_link.size() + links_count, no_slot);
+        return first_link_id;
+    }
+
+    // allocate the counters, which also assigns the ids of the links
+    const auto first_link_id = stats.register_links(links_count);
+    assert(first_link_id == link_objects.size());
+
+    // hot fields, filled by init_link
+    busy.resize(busy.size() + links_count, 0);
+    bandwidth_Bpns.resize(bandwidth_Bpns.size() + links_count, 0);
+    latency.resize(latency.size() + links_count, 0);
+
+    // cold fields, created right away unless lazy
+    link_objects.resize(link_objects.size() + links_count, nullptr);
+    if (!lazy) {
+        for (auto i = 0; i < links_count; i++) {
+            materialize(first_link_id + i);
+        }
+    }
+
+    return first_link_id;
+}
+
+void LinkTable::init_link(const LinkId link_id,
+                          const DeviceId src,
+                          const DeviceId dest,
+                          const Bandwidth bandwidth,
+                          const Latency latency) noexcept {
+    assert(describer == nullptr);
+    assert(link_id < link_objects.size());
+    assert(bandwidth > 0);
+    assert(latency >= 0);
+
+    // hot fields, with bandwidth converted from GB/s to B/ns
+    bandwidth_Bpns[link_id] = bw_GBps_to_Bpns(bandwidth);
+    this->latency[link_id] = latency;
+
+    stats.set_endpoints(link_id, src, dest);
+}
+
+LinkId LinkTable::add_compiled_links(const int links_count,
+                                     const DeviceId* const srcs,
+                                     const DeviceId* const dests,
+                                     const Bandwidth* const bandwidths_Bpns,
+                                     const Latency* const latencies) noexcept {
+    assert(describer == nullptr);
+
+    const auto first_link_id = add_links(links_count);
+
+    // hot fields, with bandwidth already converted to B/ns
+    std::copy_n(bandwidths_Bpns, links_count, bandwidth_Bpns.begin() + first_link_id);
+    std::copy_n(latencies, links_count, latency.begin() + first_link_id);
+
+    for (auto i = 0; i < links_count; i++) {
+        stats.set_endpoints(first_link_id + i, srcs[i], dests[i]);
+    }
+
+    return first_link_id;
+}
+
+std::pair<DeviceId, DeviceId> LinkTable::get_endpoints(const LinkId link_id) const noexcept {
+    assert(link_id < get_links_count());
+
+    const auto link_slot = slot(link_id);
+    if (link_slot == no_slot) {
+        const auto description = describer(link_id);
+        return {description.src, description.dest};
+    }
+
+    return stats.get_endpoints(link_slot);
+}
+
+void LinkTable::setup_link(const LinkId link_id, LinkSetup setup) noexcept {
+    assert(link_id < get_links_count());
+
+    const auto link_slot = slot(link_id);
+    if (link_slot != no_slot && link_objects[link_slot] != nullptr) {
+        setup(*link_objects[link_slot]);
+    }
+
+    // only links materialized later need the setup replayed, an eager table holding every link already
+    const auto order = setups_count++;
+    if (lazy) {
+        link_setups[link_id].push_back({order, std::move(setup)});
+    }
+}
+
+void LinkTable::setup_links(const LinkId first_link_id, const int links_count, const LinkSetup& setup) noexcept {
+    assert(links_count >= 0);
+    assert(first_link_id + links_count <= get_links_count());
+
+    const auto end_link_id = static_cast<LinkId>(first_link_id + links_count);
+
+    // the links of an implicit table materialized so far are the ones holding a Link object
+    if (describer != nullptr) {
+        for (auto& link : links) {
+            if (first_link_id <= link.get_id() && link.get_id() < end_link_id) {
+                setup(link);
+            }
+        }
+    } else {
+        for (auto link_id = first_link_id; link_id < end_link_id; link_id++) {
+            if (link_objects[link_id] != nullptr) {
+                setup(*link_objects[link_id]);
+            }
+        }
+    }
+
+    // only links materialized later need the setup replayed, an eager table holding every link already
+    const auto order = setups_count++;
+    if (lazy) {
+        range_setups.push_back({first_link_id, end_link_id, order, setup});
+    }
+}
+
+Link& LinkTable::at(const LinkId link_id) noexcept {
+    assert(link_id < get_links_count());
+
+    const auto link_slot = slot(link_id);
+    if (link_slot == no_slot || link_objects[link_slot] == nullptr) {
+        return materialize(link_id);
+    }
+
+    return *link_objects[link_slot];
+}
+
+const Link& LinkTable::at(const LinkId link_id) const noexcept {
+    assert(link_id < get_links_count());
+
+    const auto link_slot = slot(link_id);
+    assert(link_slot != no_slot && link_objects[link_slot] != nullptr);
+
+    return *link_objects[link_slot];
+}
+
+int LinkTable::get_links_count() const noexcept {
+    return static_cast<int>((describer != nullptr) ? slot_of_link.size() : link_objects.size());
+}
+
+int LinkTable::get_materialized_links_count() const noexcept {
+    return static_cast<int>(links.size());
+}
+
+const LinkStats& LinkTable::get_link_stats(const LinkId link_id) const noexcept {
+    assert(link_id < get_links_count());
+
+    // a link never materialized never sent anything
+    static const auto untouched_link_stats = LinkStats();
+
+    const auto link_slot = slot(link_id);
+    if (link_slot == no_slot) {
+        return untouched_link_stats;
+    }
+
+    return stats.at(link_slot);
+}
+
+LinkStats& LinkTable::update_link_stats(const LinkId link_id) noexcept {
+    assert(link_id < get_links_count());
+
+    return stats.at(materialized_slot(link_id));
+}
+
+bool LinkTable::is_busy(const LinkId link_id) const noexcept {
+    assert(link_id < get_links_count());
+
+    const auto link_slot = slot(link_id);
+    return link_slot != no_slot && busy[link_slot] != 0;
+}
+
+void LinkTable::set_busy(const LinkId link_id, const bool link_busy) noexcept {
+    assert(link_id < get_links_count());
+
+    busy[materialized_slot(link_id)] = link_busy ? 1 : 0;
+}
+
+uint64_t LinkTable::get_occupancy(const LinkId link_id) const noexcept {
+    assert(link_id < get_links_count());
+
+    const auto link_slot = slot(link_id);
+    if (link_slot == no_slot || link_objects[link_slot] == nullptr) {
+        return 0;
+    }
+
+    return link_objects[link_slot]->get_pending_chunks_count() + busy[link_slot];
+}
+
+Bandwidth LinkTable::get_bandwidth_Bpns(const LinkId link_id) const noexcept {
+    assert(link_id < get_links_count());
+
+    const auto link_slot = slot(link_id);
+    if (link_slot == no_slot) {
+        return bw_GBps_to_Bpns(describer(link_id).bandwidth);
+    }
+
+    return bandwidth_Bpns[link_slot];
+}
+
+Latency LinkTable::get_latency(const LinkId link_id) const noexcept {
+    assert(link_id < get_links_count());
+
+    const auto link_slot = slot(link_id);
+    if (link_slot == no_slot) {
+        return describer(link_id).latency;
+    }
+
+    return latency[link_slot];
+}
+
+void LinkTable::set_rerouter(Rerouter rerouter) noexcept {
+    this->rerouter = std::move(rerouter);
+}
+
+void LinkTable::set_health(const LinkId link_id, const double health) noexcept {
+    assert(link_id < get_links_count());
+    assert(health >= 0);
+
+    auto& link = at(link_id);
+    const auto was_dead = link.is_dead();
+    link.set_health(health);
+
+    // keep the count of dead links, so healthy tables skip the lookup
+    if (was_dead != link.is_dead()) {
+        dead_links_count += link.is_dead() ? 1 : -1;
+    }
+}
+
+double LinkTable::get_health(const LinkId link_id) const noexcept {
+    assert(link_id < get_links_count());
+
+    const auto link_slot = slot(link_id);
+    if (link_slot == no_slot || link_objects[link_slot] == nullptr) {
+        return 1.0;
+    }
+
+    return link_objects[link_slot]->get_health();
+}
+
+bool LinkTable::is_dead(const LinkId link_id) const noexcept {
+    assert(link_id < get_links_count());
+
+    if (dead_links_count == 0) {
+        return false;
+    }
+
+    // a dead link got materialized by set_health
+    const auto link_slot = slot(link_id);
+    return link_slot != no_slot && link_objects[link_slot] != nullptr && link_objects[link_slot]->is_dead();
+}
+
+bool LinkTable::reroute(Chunk& chunk) const noexcept {
+    if (rerouter == nullptr) {
+        return false;
+    }
+
+    auto route = rerouter(chunk.current_device()->get_id(), chunk.dest_device()->get_id());
+    if (route.empty()) {
+        return false;
+    }
+
+    chunk.set_route(std::move(route));
+    return true;
+}
+
+void LinkTable::update_credit_waiting_chunks(const int64_t delta) noexcept {
+    assert(delta >= 0 || credit_waiting_chunks >= static_cast<uint64_t>(-delta));
+
+    credit_waiting_chunks += delta;
+    total_credit_waiting_chunks += delta;
+}
+
+const LinkStatsTable& LinkTable::get_stats() const noexcept {
+    return stats;
+}
+
+uint32_t LinkTable::slot(const LinkId link_id) const noexcept {
+    // the slot of a link is its id, unless the table is implicit
+    if (describer == nullptr) {
+        return link_id;
+    }
+
+    return slot_of_link[link_id];
+}
+
+uint32_t LinkTable::materialized_slot(const LinkId link_id) noexcept {
+    const auto link_slot = slot(link_id);
+    if (link_slot != no_slot) {
+        return link_slot;
+    }
+
+    // allocate the state of the link in the next slot
+    const auto description = describer(link_id);
+    assert(description.bandwidth > 0);
+    assert(description.latency >= 0);
+
+    const auto new_slot = stats.register_sparse_link(link_id, description.src, description.dest);
+    busy.push_back(0);
+    bandwidth_Bpns.push_back(bw_GBps_to_Bpns(description.bandwidth));
+    latency.push_back(description.latency);
+    link_objects.push_back(nullptr);
+    assert(new_slot + 1 == link_objects.size());
+
+    slot_of_link[link_id] = new_slot;
+    return new_slot;
+}
+
+Link& LinkTable::materialize(const LinkId link_id) noexcept {
+    const auto link_slot = materialized_slot(link_id);
+    assert(link_objects[link_slot] == nullptr);
+
+    auto& link = links.emplace_back(this, link_id);
+    link_objects[link_slot] = &link;
+
+    // replay the setups covering the link, merging the range setups and its own ones in order
+    const auto own_setups_it = link_setups.find(link_id);
+    const auto* const own_setups = (own_setups_it != link_setups.end()) ? &own_setups_it->second : nullptr;
+    auto own_setup = size_t{0};
+    const auto replay_own_setups_before = [&](const uint64_t order) {
+        while (own_setups != nullptr && own_setup < own_setups->size() && (*own_setups)[own_setup].order < order) {
+            (*own_setups)[own_setup].setup(link);
+            own_setup++;
+        }
+    };
+    for (const auto& [first_link_id, end_link_id, order, setup] : range_setups) {
+        if (first_link_id <= link_id && link_id < end_link_id) {
+            replay_own_setups_before(order);
+            setup(link);
+        }
+    }
+    replay_own_setups_before(setups_count);
+
+    return link;
+}
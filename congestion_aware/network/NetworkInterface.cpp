@@ -0,0 +1,136 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/NetworkInterface.h"
+#include "common/NetworkFunction.h"
+#include "congestion_aware/Chunk.h"
+#include "congestion_aware/Device.h"
+#include "congestion_aware/Link.h"
+#include "congestion_aware/LinkTable.h"
+#include <algorithm>
+#include <cassert>
+
+using namespace NetworkAnalyticalCongestionAware;
+
+// declaring static event_queue
+std::shared_ptr<EventQueue> NetworkInterface::event_queue;
+
+void NetworkInterface::injection_finished(void* const injection_ptr) noexcept {
+    assert(injection_ptr != nullptr);
+
+    // cast to unique_ptr<Injection>
+    auto injection = std::unique_ptr<Injection>(static_cast<Injection*>(injection_ptr));
+    auto* const network_interface = injection->network_interface;
+
+    // hand the chunk over to its egress link
+    network_interface->link_table->at(injection->egress_link).send(std::move(injection->chunk));
+
+    // the engine reads the next waiting chunk
+    network_interface->idle_dma_engines++;
+    network_interface->start_next_injection();
+}
+
+void NetworkInterface::ejection_finished(void* const chunk_ptr) noexcept {
+    assert(chunk_ptr != nullptr);
+
+    // cast to unique_ptr<Chunk>, and hand it to the NPU
+    auto chunk = std::unique_ptr<Chunk>(static_cast<Chunk*>(chunk_ptr));
+    chunk->deliver();
+}
+
+void NetworkInterface::set_event_queue(std::shared_ptr<EventQueue> event_queue_ptr) noexcept {
+    assert(event_queue_ptr != nullptr);
+
+    // set the event queue
+    NetworkInterface::event_queue = std::move(event_queue_ptr);
+}
+
+NetworkInterface::NetworkInterface(LinkTable* const link_table,
+                                   const Bandwidth injection_bandwidth,
+                                   const Bandwidth ejection_bandwidth,
+                                   const int dma_engines,
+                                   const NicScheduling scheduling) noexcept
+    : link_table(link_table),
+      engine_bandwidth_Bpns(0),
+      ejection_bandwidth_Bpns(0),
+      idle_dma_engines(dma_engines),
+      scheduling(scheduling),
+      last_served_dest(-1),
+      ejection_free_time(0) {
+    assert(link_table != nullptr);
+    assert(injection_bandwidth >= 0);
+    assert(ejection_bandwidth >= 0);
+    assert(dma_engines > 0);
+
+    // the engines split the injection bandwidth evenly
+    if (injection_bandwidth > 0) {
+        engine_bandwidth_Bpns = bw_GBps_to_Bpns(injection_bandwidth) / dma_engines;
+    }
+    if (ejection_bandwidth > 0) {
+        ejection_bandwidth_Bpns = bw_GBps_to_Bpns(ejection_bandwidth);
+    }
+}
+
+void NetworkInterface::inject(std::unique_ptr<Chunk> chunk, const LinkId egress_link) noexcept {
+    assert(chunk != nullptr);
+
+    // unlimited injection, send the chunk right away
+    if (engine_bandwidth_Bpns == 0) {
+        link_table->at(egress_link).send(std::move(chunk));
+        return;
+    }
+
+    // wait for an engine, queued per each destination if scheduled round-robin
+    const auto dest = (scheduling == NicScheduling::RoundRobin) ? chunk->dest_device()->get_id() : -1;
+    waiting_injections[dest].push_back({this, std::move(chunk), egress_link});
+    start_next_injection();
+}
+
+void NetworkInterface::eject(std::unique_ptr<Chunk> chunk) noexcept {
+    assert(chunk != nullptr);
+
+    // unlimited ejection, deliver the chunk right away
+    if (ejection_bandwidth_Bpns == 0) {
+        chunk->deliver();
+        return;
+    }
+
+    // chunks are written out one after another, taking at least 1 ns each
+    const auto current_time = NetworkInterface::event_queue->get_current_time();
+    const auto ejection_time = std::max<EventTime>(
+        1, static_cast<EventTime>(static_cast<Bandwidth>(chunk->get_size()) / ejection_bandwidth_Bpns));
+    ejection_free_time = std::max(ejection_free_time, current_time) + ejection_time;
+
+    auto* const chunk_ptr = static_cast<void*>(chunk.release());
+    NetworkInterface::event_queue->schedule_event(ejection_free_time, ejection_finished, chunk_ptr);
+}
+
+void NetworkInterface::start_next_injection() noexcept {
+    if (idle_dma_engines == 0 || waiting_injections.empty()) {
+        return;
+    }
+
+    // pick the destination to serve, the one following the last served destination in round-robin order
+    auto it = waiting_injections.upper_bound(last_served_dest);
+    if (it == waiting_injections.end()) {
+        it = waiting_injections.begin();
+    }
+    last_served_dest = it->first;
+
+    // take its oldest waiting chunk
+    auto* const injection = new Injection(std::move(it->second.front()));
+    it->second.pop_front();
+    if (it->second.empty()) {
+        waiting_injections.erase(it);
+    }
+
+    // an engine reads the chunk, taking at least 1 ns
+    idle_dma_engines--;
+    const auto current_time = NetworkInterface::event_queue->get_current_time();
+    const auto injection_time = std::max<EventTime>(
+        1, static_cast<EventTime>(static_cast<Bandwidth>(injection->chunk->get_size()) / engine_bandwidth_Bpns));
+    NetworkInterface::event_queue->schedule_event(current_time + injection_time, injection_finished,
+                                                  static_cast<void*>(injection));
+}
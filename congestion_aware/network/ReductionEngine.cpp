@@ -0,0 +1,99 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/ReductionEngine.h"
+#include "common/NetworkFunction.h"
+#include "congestion_aware/Chunk.h"
+#include "congestion_aware/Device.h"
+#include "congestion_aware/Link.h"
+#include <algorithm>
+#include <cassert>
+
+using namespace NetworkAnalyticalCongestionAware;
+
+// declaring static event_queue
+std::shared_ptr<EventQueue> ReductionEngine::event_queue;
+
+void ReductionEngine::reduction_finished(void* const reduction_ptr) noexcept {
+    assert(reduction_ptr != nullptr);
+
+    // cast to unique_ptr<Reduction>
+    auto reduction = std::unique_ptr<Reduction>(static_cast<Reduction*>(reduction_ptr));
+    reduction->reduction_engine->forward(std::move(reduction->chunk));
+}
+
+void ReductionEngine::set_event_queue(std::shared_ptr<EventQueue> event_queue_ptr) noexcept {
+    assert(event_queue_ptr != nullptr);
+
+    // set the event queue
+    ReductionEngine::event_queue = std::move(event_queue_ptr);
+}
+
+ReductionEngine::ReductionEngine(Device* const device, const Bandwidth throughput) noexcept
+    : device(device),
+      throughput_Bpns(0),
+      free_time(0) {
+    assert(device != nullptr);
+    assert(throughput >= 0);
+
+    if (throughput > 0) {
+        throughput_Bpns = bw_GBps_to_Bpns(throughput);
+    }
+}
+
+void ReductionEngine::reduce(std::unique_ptr<Chunk> chunk) noexcept {
+    assert(chunk != nullptr);
+    assert(chunk->get_reduction_group() >= 0);
+
+    // collect the contribution
+    const auto contributions_count = chunk->get_contributions_count();
+    const auto key = std::make_pair(chunk->get_reduction_group(), chunk->dest_device()->get_id());
+    auto& arrived = contributions[key];
+    arrived.push_back(std::move(chunk));
+
+    // wait for the other contributions
+    if (arrived.size() < contributions_count) {
+        return;
+    }
+
+    // reduce every contribution into the first one
+    auto reduced_chunk = std::move(arrived.front());
+    const auto chunk_size = reduced_chunk->get_size();
+    for (auto i = 1; i < arrived.size(); i++) {
+        auto& contribution = arrived[i];
+
+        // the contribution leaves the input buffer of the switch
+        if (contribution->get_ingress_link() != nullptr) {
+            contribution->get_ingress_link()->return_credits(contribution->get_size(),
+                                                             contribution->get_traffic_class());
+            contribution->set_ingress_link(nullptr);
+        }
+        reduced_chunk->merge(std::move(contribution));
+    }
+    contributions.erase(key);
+    reduced_chunk->clear_reduction_group();
+
+    // reductions take no time
+    if (throughput_Bpns == 0) {
+        forward(std::move(reduced_chunk));
+        return;
+    }
+
+    // reductions are processed one after another, reading every contribution and taking at least 1 ns
+    const auto current_time = ReductionEngine::event_queue->get_current_time();
+    const auto read_bytes = static_cast<Bandwidth>(contributions_count * chunk_size);
+    const auto reduction_time = std::max<EventTime>(1, static_cast<EventTime>(read_bytes / throughput_Bpns));
+    free_time = std::max(free_time, current_time) + reduction_time;
+
+    auto* const reduction = new Reduction{this, std::move(reduced_chunk)};
+    ReductionEngine::event_queue->schedule_event(free_time, reduction_finished, static_cast<void*>(reduction));
+}
+
+void ReductionEngine::forward(std::unique_ptr<Chunk> chunk) noexcept {
+    assert(chunk != nullptr);
+
+    // the reduced chunk continues its route like any other chunk
+    device->send(std::move(chunk));
+}
@@ -0,0 +1,37 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/FaultMap.h"
+#include <algorithm>
+
+using namespace NetworkAnalyticalCongestionAware;
+
+FaultMap::FaultMap(const std::vector<std::tuple<int, int, double>>& faulty_links) noexcept {
+    health.reserve(faulty_links.size());
+
+    // emplace keeps the first entry of a link listed more than once
+    for (const auto& [src, dest, link_health] : faulty_links) {
+        health.emplace(key(src, dest), link_health);
+    }
+}
+
+double FaultMap::derate(const DeviceId src, const DeviceId dest) const noexcept {
+    if (health.empty()) {
+        return 1.0;
+    }
+
+    const auto it = health.find(key(src, dest));
+    return it == health.end() ? 1.0 : it->second;
+}
+
+int FaultMap::size() const noexcept {
+    return static_cast<int>(health.size());
+}
+
+uint64_t FaultMap::key(const DeviceId src, const DeviceId dest) noexcept {
+    const auto low = static_cast<uint32_t>(std::min(src, dest));
+    const auto high = static_cast<uint32_t>(std::max(src, dest));
+    return (static_cast<uint64_t>(low) << 32) | high;
+}
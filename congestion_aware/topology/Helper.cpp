@@ -5,11 +5,14 @@ LICENSE file in the root directory of this source tree.
 
 #include "congestion_aware/Helper.h"
 #include "congestion_aware/BinaryTree.h"
+#include "congestion_aware/Bus.h"
 #include "congestion_aware/DoubleBinaryTree.h"
+#include "congestion_aware/FaultMap.h"
 #include "congestion_aware/FullyConnected.h"
 #include "congestion_aware/Mesh.h"
 #include "congestion_aware/MultiDimTopology.h"
 #include "congestion_aware/Ring.h"
+#include "congestion_aware/TopologyCache.h"
 #include "congestion_aware/Torus2D.h"
 #include "congestion_aware/Mesh2D.h"
 #include "congestion_aware/KingMesh2D.h"
@@ -29,12 +32,43 @@ std::shared_ptr<Topology> NetworkAnalyticalCongestionAware::construct_topology(
     const auto npus_counts_per_dim = network_parser.get_npus_counts_per_dim();
     const auto bandwidths_per_dim = network_parser.get_bandwidths_per_dim();
     const auto latencies_per_dim = network_parser.get_latencies_per_dim();
-    const auto faulty_links = network_parser.get_faulty_links();
+    const auto fault_map = std::make_shared<const FaultMap>(network_parser.get_faulty_links());
     const auto non_recursive_topo = network_parser.get_non_recursive_topo();
+    const auto bandwidth_schedule = network_parser.get_bandwidth_schedule();
+    const auto link_health_schedule = network_parser.get_link_health_schedule();
+    const auto input_buffer_sizes_per_dim = network_parser.get_input_buffer_sizes_per_dim();
+    const auto virtual_channels_count = network_parser.get_virtual_channels_count();
+    const auto vc_arbitration = network_parser.get_vc_arbitration();
+    const auto vc_weights = network_parser.get_vc_weights();
+    const auto bus_arbitration = network_parser.get_bus_arbitration();
+    const auto switch_queueing = network_parser.get_switch_queueing();
+    const auto switch_arbitration = network_parser.get_switch_arbitration();
+    const auto crossbar_speedup = network_parser.get_crossbar_speedup();
+    const auto nic_injection_bandwidth = network_parser.get_nic_injection_bandwidth();
+    const auto nic_ejection_bandwidth = network_parser.get_nic_ejection_bandwidth();
+    const auto nic_dma_engines = network_parser.get_nic_dma_engines();
+    const auto nic_scheduling = network_parser.get_nic_scheduling();
+    const auto bit_error_rate = network_parser.get_bit_error_rate();
+    const auto packet_error_rate = network_parser.get_packet_error_rate();
+    const auto link_error_rates = network_parser.get_link_error_rates();
+    const auto retransmission = network_parser.get_retransmission();
+    const auto retransmission_window = network_parser.get_retransmission_window();
+    const auto error_seed = network_parser.get_error_seed();
+    const auto has_link_errors = bit_error_rate > 0 || packet_error_rate > 0 || !link_error_rates.empty();
+    const auto in_network_reduction_per_dim = network_parser.get_in_network_reduction_per_dim();
+    const auto reduction_throughputs_per_dim = network_parser.get_reduction_throughputs_per_dim();
+    const auto construction_threads = network_parser.get_construction_threads();
+    const auto lazy_links = network_parser.get_lazy_links();
+    const auto implicit_topology = network_parser.get_implicit_topology();
+    const auto topology_cache = network_parser.get_topology_cache();
+    const auto adaptive_routing = network_parser.get_adaptive_routing();
+    const auto striping = network_parser.get_striping();
+    const auto cluster_agents = network_parser.get_cluster_agents();
+    const auto cluster_agent_selection = network_parser.get_cluster_agent_selection();
     std::cout<< dims_count<< std::endl;
 
-    // if single dim, create basic-topology
-    if (dims_count == 1) {
+    // if single dim, create basic-topology, unless implicit, which only multi-dimensional topologies implement
+    if (dims_count == 1 && !implicit_topology) {
         // retrieve basic basic-topology info
         const auto topology_type = topologies_per_dim[0];
         const auto npus_count = npus_counts_per_dim[0];
@@ -42,36 +76,118 @@ std::shared_ptr<Topology> NetworkAnalyticalCongestionAware::construct_topology(
         const auto latency = latencies_per_dim[0];
         const auto non_recursive_topo_per_dim = non_recursive_topo[0];
 
+        // options only multi-dimensional topologies implement
+        if (construction_threads != 0) {
+            std::cerr << "[Warning] (network/analytical/congestion_aware) "
+                      << "construction_threads ignored, only multi-dimensional topologies are built in parallel"
+                      << std::endl;
+        }
+        if (!topology_cache.empty()) {
+            std::cerr << "[Warning] (network/analytical/congestion_aware) "
+                      << "topology_cache ignored, only multi-dimensional topologies are compiled" << std::endl;
+        }
+        if (adaptive_routing) {
+            std::cerr << "[Warning] (network/analytical/congestion_aware) "
+                      << "adaptive_routing ignored, a single dimension leaves no dimension order to pick"
+                      << std::endl;
+        }
+        if (cluster_agents > 1) {
+            std::cerr << "[Warning] (network/analytical/congestion_aware) "
+                      << "cluster_agents ignored, only multi-dimensional cluster topologies have agents" << std::endl;
+        }
+
+        std::shared_ptr<Topology> topology;
         switch (topology_type) {
         case TopologyBuildingBlock::Ring:
-            return std::make_shared<Ring>(npus_count, bandwidth, latency, faulty_links);
+            topology = std::make_shared<Ring>(npus_count, bandwidth, latency, fault_map);
+            break;
         case TopologyBuildingBlock::Switch:
-            return std::make_shared<Switch>(npus_count, bandwidth, latency, faulty_links);
+            topology = std::make_shared<Switch>(npus_count, bandwidth, latency, fault_map);
+            break;
         case TopologyBuildingBlock::FullyConnected:
-            return std::make_shared<FullyConnected>(npus_count, bandwidth, latency, faulty_links);
+            topology = std::make_shared<FullyConnected>(npus_count, bandwidth, latency, fault_map);
+            break;
+        case TopologyBuildingBlock::Bus:
+            topology = std::make_shared<Bus>(npus_count, bandwidth, latency, bus_arbitration);
+            break;
         case TopologyBuildingBlock::BinaryTree:
-            return std::make_shared<BinaryTree>(npus_count, bandwidth, latency);
+            topology = std::make_shared<BinaryTree>(npus_count, bandwidth, latency);
+            break;
         case TopologyBuildingBlock::DoubleBinaryTree:
-            return std::make_shared<DoubleBinaryTree>(npus_count, bandwidth, latency);
+            topology = std::make_shared<DoubleBinaryTree>(npus_count, bandwidth, latency);
+            break;
         case TopologyBuildingBlock::Mesh:
-            return std::make_shared<Mesh>(npus_count, bandwidth, latency, faulty_links);
+            topology = std::make_shared<Mesh>(npus_count, bandwidth, latency, fault_map);
+            break;
         case TopologyBuildingBlock::Torus2D:
-            return std::make_shared<Torus2D>(npus_count, bandwidth, latency, faulty_links);
+            topology = std::make_shared<Torus2D>(npus_count, bandwidth, latency, fault_map);
+            break;
         case TopologyBuildingBlock::Mesh2D:
-            return std::make_shared<Mesh2D>(npus_count, bandwidth, latency, faulty_links);
+            topology = std::make_shared<Mesh2D>(npus_count, bandwidth, latency, fault_map);
+            break;
         case TopologyBuildingBlock::KingMesh2D:
-            return std::make_shared<KingMesh2D>(npus_count, bandwidth, latency);
+            topology = std::make_shared<KingMesh2D>(npus_count, bandwidth, latency, fault_map);
+            break;
         case TopologyBuildingBlock::HyperCube:
-            return std::make_shared<HyperCube>(npus_count, bandwidth, latency, faulty_links);
+            topology = std::make_shared<HyperCube>(npus_count, bandwidth, latency, fault_map);
+            break;
         default:
             // shouldn't reaach here
             std::cerr << "[Error] (network/analytical/congestion_aware) "
                       << "not supported basic-topology" << std::endl;
             std::exit(-1);
         }
+
+        // materialize links on their first use if requested
+        if (lazy_links) {
+            topology->set_lazy_links(true);
+        }
+
+        // apply time-varying link bandwidths
+        topology->apply_bandwidth_schedule(bandwidth_schedule);
+
+        // fail, restore, and derate links at runtime
+        topology->apply_link_health_schedule(link_health_schedule);
+
+        // bound input buffers if requested
+        if (!input_buffer_sizes_per_dim.empty()) {
+            topology->set_input_buffer_size(input_buffer_sizes_per_dim[0]);
+        }
+
+        // split links into virtual channels if requested
+        if (virtual_channels_count > 1) {
+            topology->set_virtual_channels(virtual_channels_count, vc_arbitration, vc_weights);
+        }
+
+        // model switch crossbars if requested
+        if (switch_queueing != SwitchQueueing::Ideal) {
+            topology->set_switch_model(switch_queueing, switch_arbitration, crossbar_speedup);
+        }
+
+        // model NPU network interfaces if requested
+        if (nic_injection_bandwidth > 0 || nic_ejection_bandwidth > 0) {
+            topology->set_network_interfaces(nic_injection_bandwidth, nic_ejection_bandwidth, nic_dma_engines,
+                                             nic_scheduling);
+        }
+
+        // corrupt chunks on the links if requested
+        if (has_link_errors) {
+            topology->set_link_errors(bit_error_rate, packet_error_rate, link_error_rates, retransmission,
+                                      retransmission_window, error_seed);
+        }
+
+        // reduce chunks at the switch if requested
+        if (in_network_reduction_per_dim[0]) {
+            topology->set_in_network_reduction(reduction_throughputs_per_dim[0]);
+        }
+
+        // spread chunks over multiple routes if requested
+        topology->set_striping(striping);
+
+        return topology;
     } else {  // otherwise, create multi-dim basic-topology
         
-        const auto multi_dim_topology = std::make_shared<MultiDimTopology>(faulty_links, non_recursive_topo);
+        const auto multi_dim_topology = std::make_shared<MultiDimTopology>(fault_map, non_recursive_topo);
 
         // create and append dims
         for (auto dim = 0; dim < dims_count; dim++) {
@@ -91,11 +207,15 @@ std::shared_ptr<Topology> NetworkAnalyticalCongestionAware::construct_topology(
                     std::make_unique<Ring>(npus_count, bandwidth, latency, /* bidirectional = */ true, is_multi_dim);
                 break;
             case TopologyBuildingBlock::Switch:
-                dim_topology = std::make_unique<Switch>(npus_count, bandwidth, latency, is_multi_dim);
+                dim_topology =
+                    std::make_unique<Switch>(npus_count, bandwidth, latency, /* bidirectional = */ true, is_multi_dim);
                 break;
             case TopologyBuildingBlock::FullyConnected:
                 dim_topology = std::make_unique<FullyConnected>(npus_count, bandwidth, latency, is_multi_dim);
                 break;
+            case TopologyBuildingBlock::Bus:
+                dim_topology = std::make_unique<Bus>(npus_count, bandwidth, latency, bus_arbitration, is_multi_dim);
+                break;
             case TopologyBuildingBlock::BinaryTree:
                 dim_topology = std::make_unique<BinaryTree>(npus_count, bandwidth, latency, is_multi_dim);
                 break;
@@ -130,96 +250,73 @@ std::shared_ptr<Topology> NetworkAnalyticalCongestionAware::construct_topology(
             multi_dim_topology->append_dimension(std::move(dim_topology));
         }
 
+        multi_dim_topology->set_construction_threads(construction_threads);
+        multi_dim_topology->set_lazy_links(lazy_links);
+        multi_dim_topology->set_implicit(implicit_topology);
+        multi_dim_topology->set_adaptive_routing(adaptive_routing);
+        multi_dim_topology->set_cluster_agents(cluster_agents, cluster_agent_selection);
         multi_dim_topology->initialize_all_devices();
         multi_dim_topology->build_switch_length_mapping();
-        multi_dim_topology->make_connections();
+        multi_dim_topology->set_input_buffer_size_per_dim(input_buffer_sizes_per_dim);
 
-        // return created multi-dimensional topology
-        return multi_dim_topology;
-    }
-}
-
-std::vector<std::pair<MultiDimAddress, MultiDimAddress>> NetworkAnalyticalCongestionAware::generateAddressPairs(
-    const MultiDimAddress& upper, const ConnectionPolicy& policy, int dim) noexcept {
-    std::vector<std::pair<MultiDimAddress, MultiDimAddress>> result;
-    MultiDimAddress current(upper.size(), 0);
-    generateFreeComb(upper, dim, policy, current, 0, result);
-    return result;
-}
+        // an implicit topology computes its connections on the fly, so there is nothing to compile
+        if (!topology_cache.empty() && implicit_topology) {
+            std::cerr << "[Warning] (network/analytical/congestion_aware) "
+                      << "topology_cache ignored, implicit topologies aren't compiled" << std::endl;
+        }
 
-std::vector<std::pair<MultiDimAddress, MultiDimAddress>>
-NetworkAnalyticalCongestionAware::generateAddressPairs_only_first_nodes(
-    const std::vector<int>& npus_count_per_dim,
-    const ConnectionPolicy& policy,
-    int dim) noexcept
-{
-    std::vector<std::pair<MultiDimAddress, MultiDimAddress>> result;
+        // load the connections compiled from an identical topology if cached, otherwise compile them
+        if (!topology_cache.empty() && !implicit_topology) {
+            const auto topology_hash = network_parser.get_topology_hash();
+            const auto cache_path = TopologyCache::get_path(topology_cache, topology_hash);
+            const auto cached_topology = TopologyCache::load(cache_path, topology_hash);
+            if (cached_topology == nullptr || !multi_dim_topology->load_connections(*cached_topology)) {
+                multi_dim_topology->make_connections();
+                if (!multi_dim_topology->save_connections(cache_path, topology_hash)) {
+                    std::cerr << "[Warning] (network/analytical/congestion_aware) "
+                              << "failed to write the compiled topology " << cache_path << std::endl;
+                }
+            }
+        } else {
+            multi_dim_topology->make_connections();
+        }
 
-    MultiDimAddress upper(npus_count_per_dim.begin(), npus_count_per_dim.end());
-    MultiDimAddress current(upper.size(), 0);
+        // apply time-varying link bandwidths
+        multi_dim_topology->apply_bandwidth_schedule(bandwidth_schedule);
 
-    generateFreeComb_only_first_nodes(upper, dim, policy, current, 0, result);
+        // fail, restore, and derate links at runtime
+        multi_dim_topology->apply_link_health_schedule(link_health_schedule);
 
-    return result;
-}
+        // split links into virtual channels if requested
+        if (virtual_channels_count > 1) {
+            multi_dim_topology->set_virtual_channels(virtual_channels_count, vc_arbitration, vc_weights);
+        }
 
+        // model switch crossbars if requested
+        if (switch_queueing != SwitchQueueing::Ideal) {
+            multi_dim_topology->set_switch_model(switch_queueing, switch_arbitration, crossbar_speedup);
+        }
 
-void NetworkAnalyticalCongestionAware::generateFreeComb(
-    const MultiDimAddress& upper,
-    int dim,
-    const ConnectionPolicy& policy,
-    MultiDimAddress& current,
-    int index,
-    std::vector<std::pair<MultiDimAddress, MultiDimAddress>>& result) noexcept {
-    if (index == upper.size()) {
-        // Reached the end, save the pair
-        result.push_back({current, current});
-        result.back().first[dim] = policy.src;
-        result.back().second[dim] = policy.dst;
-        return;
-    }
+        // model NPU network interfaces if requested
+        if (nic_injection_bandwidth > 0 || nic_ejection_bandwidth > 0) {
+            multi_dim_topology->set_network_interfaces(nic_injection_bandwidth, nic_ejection_bandwidth,
+                                                       nic_dma_engines, nic_scheduling);
+        }
 
-    if (index == dim) {
-        // Skip fixed dimension in recursion
-        generateFreeComb(upper, dim, policy, current, index + 1, result);
-    } else {
-        for (int i = 0; i < upper[index]; ++i) {
-            current[index] = i;
-            generateFreeComb(upper, dim, policy, current, index + 1, result);
+        // corrupt chunks on the links if requested
+        if (has_link_errors) {
+            multi_dim_topology->set_link_errors(bit_error_rate, packet_error_rate, link_error_rates, retransmission,
+                                                retransmission_window, error_seed);
         }
-    }
-}
 
-void NetworkAnalyticalCongestionAware::generateFreeComb_only_first_nodes(
-    const MultiDimAddress& upper,
-    int dim,
-    const ConnectionPolicy& policy,
-    MultiDimAddress& current,
-    int index,
-    std::vector<std::pair<MultiDimAddress, MultiDimAddress>>& result) noexcept
-{
-    if (index == (int)upper.size()) {
-        result.push_back({current, current});
-        result.back().first[dim]  = policy.src;
-        result.back().second[dim] = policy.dst;
-        return;
-    }
+        // reduce chunks at the switches of the selected dimensions
+        multi_dim_topology->set_in_network_reduction_per_dim(in_network_reduction_per_dim,
+                                                             reduction_throughputs_per_dim);
 
-    if (index < dim) {
-        // NON-RECURSIVE MODE: only take the FIRST node in this dimension
-        current[index] = 0;
-        generateFreeComb_only_first_nodes(upper, dim, policy, current, index + 1, result);
-    }
-    else if (index == dim) {
-        // same behavior as original code
-        generateFreeComb_only_first_nodes(upper, dim, policy, current, index + 1, result);
-    }
-    else {
-        // FULL recursion for dimensions > dim
-        for (int i = 0; i < upper[index]; ++i) {
-            current[index] = i;
-            generateFreeComb_only_first_nodes(upper, dim, policy, current, index + 1, result);
-        }
+        // spread chunks over multiple routes if requested
+        multi_dim_topology->set_striping(striping);
+
+        // return created multi-dimensional topology
+        return multi_dim_topology;
     }
 }
-
@@ -4,20 +4,47 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "congestion_aware/Topology.h"
+#include "congestion_aware/Crossbar.h"
+#include "congestion_aware/FaultMap.h"
 #include "congestion_aware/Link.h"
+#include "congestion_aware/LinkTable.h"
+#include "congestion_aware/NetworkInterface.h"
+#include "congestion_aware/ReductionEngine.h"
+#include <algorithm>
 #include <cassert>
+#include <functional>
+#include <limits>
+#include <iostream>
+#include <utility>
 
 using namespace NetworkAnalyticalCongestionAware;
 
+// declaring static event_queue
+std::shared_ptr<EventQueue> Topology::event_queue;
+
 void Topology::set_event_queue(std::shared_ptr<EventQueue> event_queue) noexcept {
     assert(event_queue != nullptr);
 
-    // pass the given event_queue to Link
+    // link health changes are scheduled by the topology itself
+    Topology::event_queue = event_queue;
+
+    // chunks still blocked by flow control once every event is processed are deadlocked
+    event_queue->set_drain_callback(LinkTable::check_deadlock, nullptr);
+
+    // pass the given event_queue to Link, Crossbar, NetworkInterface, and ReductionEngine
+    Crossbar::set_event_queue(event_queue);
+    NetworkInterface::set_event_queue(event_queue);
+    ReductionEngine::set_event_queue(event_queue);
     Link::set_event_queue(std::move(event_queue));
 }
 
-Topology::Topology() noexcept : npus_count(-1), devices_count(-1), dims_count(-1) {
+Topology::Topology() noexcept : npus_count(-1), devices_count(-1), dims_count(-1), striping(StripingPolicy::None) {
     npus_count_per_dim = {};
+    link_table = std::make_shared<LinkTable>();
+    fault_map = nullptr;
+
+    // chunks meeting a dead link are steered around it
+    link_table->set_rerouter([this](const DeviceId src, const DeviceId dest) { return reroute(src, dest); });
 }
 
 int Topology::get_devices_count() const noexcept {
@@ -54,6 +81,382 @@ std::vector<Bandwidth> Topology::get_bandwidth_per_dim() const noexcept {
     return bandwidth_per_dim;
 }
 
+int Topology::get_links_count() const noexcept {
+    return link_table->get_links_count();
+}
+
+int Topology::get_materialized_links_count() const noexcept {
+    return link_table->get_materialized_links_count();
+}
+
+void Topology::set_lazy_links(const bool lazy_links) noexcept {
+    link_table->set_lazy(lazy_links);
+}
+
+const LinkStats& Topology::get_link_stats(const DeviceId src, const DeviceId dest) const noexcept {
+    // assert the src and dest are valid
+    assert(0 <= src && src < devices_count);
+    assert(0 <= dest && dest < devices_count);
+
+    // look up the link id from the src device
+    const auto link_id = device(src)->get_link_id(dest);
+    return std::as_const(*link_table).get_link_stats(link_id);
+}
+
+void Topology::dump_link_stats_csv(std::ostream& os, const EventTime elapsed_time) const noexcept {
+    link_table->get_stats().dump_csv(os, elapsed_time);
+}
+
+void Topology::dump_link_stats_json(std::ostream& os, const EventTime elapsed_time) const noexcept {
+    link_table->get_stats().dump_json(os, elapsed_time);
+}
+
+void Topology::apply_bandwidth_schedule(
+    const std::vector<std::tuple<int, int, EventTime, double>>& bandwidth_schedule) noexcept {
+    for (const auto& [src, dest, time, scale] : bandwidth_schedule) {
+        // assert the src and dest are valid
+        assert(0 <= src && src < devices_count);
+        assert(0 <= dest && dest < devices_count);
+        assert(scale > 0);
+
+        auto applied = false;
+        const auto add_step = [time = time, scale = scale](Link& link) { link.add_bandwidth_step(time, scale); };
+
+        // src -> dest
+        if (device(src)->connected(dest)) {
+            link_table->setup_link(device(src)->get_link_id(dest), add_step);
+            applied = true;
+        }
+
+        // dest -> src, unless both directions share the same link (e.g., a bus)
+        if (device(dest)->connected(src) &&
+            !(applied && device(dest)->get_link_id(src) == device(src)->get_link_id(dest))) {
+            link_table->setup_link(device(dest)->get_link_id(src), add_step);
+            applied = true;
+        }
+
+        if (!applied) {
+            std::cerr << "[Warning] (network/analytical/congestion_aware) "
+                      << "bandwidth_schedule step ignored, no link between " << src << " and " << dest << std::endl;
+        }
+    }
+}
+
+void Topology::set_link_health(const DeviceId src,
+                               const DeviceId dest,
+                               const EventTime time,
+                               const double health) noexcept {
+    // assert the src and dest are valid
+    assert(0 <= src && src < devices_count);
+    assert(0 <= dest && dest < devices_count);
+    assert(health >= 0);
+
+    // a change due now can't wait for an event at the current time
+    if (event_queue == nullptr || time <= event_queue->get_current_time()) {
+        change_link_health(src, dest, health);
+        return;
+    }
+
+    // the links time the transmissions overlapping the change ahead of it
+    const auto health_scale = link_health_scale(src, dest, health);
+    for (const auto link_id : links_between(src, dest)) {
+        link_table->setup_link(link_id, [time, health_scale](Link& link) { link.add_health_step(time, health_scale); });
+    }
+
+    auto* const change = new LinkHealthChange{this, src, dest, health};
+    event_queue->schedule_event(time, link_health_changed, static_cast<void*>(change));
+}
+
+void Topology::apply_link_health_schedule(
+    const std::vector<std::tuple<int, int, EventTime, double>>& link_health_schedule) noexcept {
+    for (const auto& [src, dest, time, health] : link_health_schedule) {
+        set_link_health(src, dest, time, health);
+    }
+}
+
+void Topology::link_health_changed(void* const change_ptr) noexcept {
+    assert(change_ptr != nullptr);
+
+    // take ownership of the change
+    const auto change = std::unique_ptr<LinkHealthChange>(static_cast<LinkHealthChange*>(change_ptr));
+    change->topology->change_link_health(change->src, change->dest, change->health);
+}
+
+void Topology::change_link_health(const DeviceId src, const DeviceId dest, const double health) noexcept {
+    // routes constructed from now on see the new health
+    link_health[FaultMap::key(src, dest)] = health;
+
+    // health relative to the construction of the links between src and dest
+    const auto health_scale = link_health_scale(src, dest, health);
+    const auto changed_links = links_between(src, dest);
+    if (changed_links.empty()) {
+        std::cerr << "[Warning] (network/analytical/congestion_aware) "
+                  << "link_health change ignored, no link between " << src << " and " << dest << std::endl;
+        return;
+    }
+
+    for (const auto link_id : changed_links) {
+        invalidate_cached_routes(link_id, link_table->get_health(link_id), health_scale);
+        link_table->set_health(link_id, health_scale);
+
+        // the chunks queued on a dead link leave from their current device again, which reroutes them
+        if (link_table->is_dead(link_id)) {
+            for (auto& chunk : link_table->at(link_id).take_pending_chunks()) {
+                const auto current_device = chunk->current_device();
+                current_device->send(std::move(chunk));
+            }
+        }
+    }
+}
+
+std::vector<LinkId> Topology::links_between(const DeviceId src, const DeviceId dest) const noexcept {
+    // src -> dest, then dest -> src, unless both directions share the same link (e.g., a bus)
+    auto links = std::vector<LinkId>();
+    if (device(src)->connected(dest)) {
+        links.push_back(device(src)->get_link_id(dest));
+    }
+    if (device(dest)->connected(src) && (links.empty() || device(dest)->get_link_id(src) != links.front())) {
+        links.push_back(device(dest)->get_link_id(src));
+    }
+
+    return links;
+}
+
+double Topology::link_health_scale(const DeviceId src, const DeviceId dest, const double health) const noexcept {
+    // links are constructed with the faulty_links derate applied, unless dead, which keep their full bandwidth
+    const auto constructed_derate = (fault_map != nullptr) ? fault_map->derate(src, dest) : 1.0;
+    return (constructed_derate > 0) ? health / constructed_derate : health;
+}
+
+void Topology::invalidate_cached_routes(const LinkId link_id,
+                                        const double old_health,
+                                        const double new_health) noexcept {
+    // a link getting better may shorten any route,
+    // the striped routes and their weights being rebuilt once used, keeping the striping progress
+    if (new_health > old_health) {
+        cached_routes.clear();
+        cached_routes_per_link.clear();
+        for (auto& striping_state : striping_states) {
+            striping_state.second.routes.clear();
+        }
+        striping_states_per_link.clear();
+        return;
+    }
+
+    // a link getting worse only lengthens the routes crossing it, and the weights of the striped ones
+    if (const auto it = cached_routes_per_link.find(link_id); it != cached_routes_per_link.end()) {
+        for (const auto key : it->second) {
+            cached_routes.erase(key);
+        }
+        cached_routes_per_link.erase(it);
+    }
+    if (const auto it = striping_states_per_link.find(link_id); it != striping_states_per_link.end()) {
+        for (const auto key : it->second) {
+            striping_states[key].routes.clear();
+        }
+        striping_states_per_link.erase(it);
+    }
+}
+
+Route Topology::reroute(const DeviceId src, const DeviceId dest) const noexcept {
+    // assert the src and dest are valid
+    assert(0 <= src && src < devices_count);
+    assert(0 <= dest && dest < devices_count);
+    assert(src != dest);
+
+    const auto key = (static_cast<uint64_t>(src) << 32) | static_cast<uint32_t>(dest);
+    auto cached_route = cached_routes.find(key);
+    if (cached_route == cached_routes.end()) {
+        auto& scratch = reroute_scratch;
+        if (scratch.time_per_byte.size() != devices.size()) {
+            scratch.time_per_byte.assign(devices.size(), std::numeric_limits<double>::infinity());
+            scratch.reached_from.assign(devices.size(), -1);
+            scratch.reached_through.assign(devices.size(), 0);
+        }
+
+        // Dijkstra over the live links, weighted by the time each one takes to serialize a byte,
+        // reading the ports of the devices never materialized from the topology instead of creating them
+        const auto reach = [&scratch](const DeviceId device_id, const double time_per_byte, const DeviceId from,
+                                      const LinkId link_id) {
+            if (scratch.time_per_byte[device_id] == std::numeric_limits<double>::infinity()) {
+                scratch.reached_devices.push_back(device_id);
+            }
+            scratch.time_per_byte[device_id] = time_per_byte;
+            scratch.reached_from[device_id] = from;
+            scratch.reached_through[device_id] = link_id;
+            scratch.frontier.emplace_back(time_per_byte, device_id);
+            std::push_heap(scratch.frontier.begin(), scratch.frontier.end(), std::greater<>());
+        };
+        reach(src, 0, -1, 0);
+        while (!scratch.frontier.empty()) {
+            std::pop_heap(scratch.frontier.begin(), scratch.frontier.end(), std::greater<>());
+            const auto current_time_per_byte = scratch.frontier.back().first;
+            const auto current = scratch.frontier.back().second;
+            scratch.frontier.pop_back();
+            if (current == dest) {
+                break;
+            }
+            if (current_time_per_byte > scratch.time_per_byte[current]) {
+                continue;
+            }
+
+            const auto relax = [&](const DeviceId next, const LinkId link_id) {
+                const auto bandwidth = link_table->get_bandwidth_Bpns(link_id) * link_table->get_health(link_id);
+                if (bandwidth <= 0 || fault_derate(current, next) == 0) {
+                    return;
+                }
+
+                const auto next_time_per_byte = current_time_per_byte + 1 / bandwidth;
+                if (next_time_per_byte < scratch.time_per_byte[next]) {
+                    reach(next, next_time_per_byte, current, link_id);
+                }
+            };
+            if (const auto& current_device = devices[current]; current_device != nullptr) {
+                const auto& port_dests = current_device->get_port_dests();
+                const auto& port_links = current_device->get_port_links();
+                for (auto port = size_t{0}; port < port_dests.size(); port++) {
+                    relax(port_dests[port], port_links[port]);
+                }
+            } else {
+                get_implicit_ports(current, scratch.implicit_ports);
+                for (const auto& [next, link_id] : scratch.implicit_ports) {
+                    relax(next, link_id);
+                }
+            }
+        }
+
+        // walk back from dest, if reached, indexing the route by the links it crosses
+        auto route_ids = std::vector<DeviceId>();
+        if (scratch.reached_from[dest] >= 0) {
+            for (auto current = dest; current != src; current = scratch.reached_from[current]) {
+                route_ids.push_back(current);
+                cached_routes_per_link[scratch.reached_through[current]].push_back(key);
+            }
+            route_ids.push_back(src);
+            std::reverse(route_ids.begin(), route_ids.end());
+        }
+
+        // reset the entries of the reached devices for the next search
+        for (const auto device_id : scratch.reached_devices) {
+            scratch.time_per_byte[device_id] = std::numeric_limits<double>::infinity();
+            scratch.reached_from[device_id] = -1;
+        }
+        scratch.reached_devices.clear();
+        scratch.frontier.clear();
+
+        // dest unreachable
+        if (route_ids.empty()) {
+            return {};
+        }
+        cached_route = cached_routes.emplace(key, std::move(route_ids)).first;
+    }
+
+    auto route = Route();
+    for (const auto device_id : cached_route->second) {
+        route.push_back(device(device_id));
+    }
+
+    return route;
+}
+
+std::vector<Route> Topology::routes(const DeviceId src, const DeviceId dest) const noexcept {
+    // a single route by default
+    return {route(src, dest)};
+}
+
+void Topology::set_input_buffer_size(const ChunkSize buffer_size) noexcept {
+    assert(buffer_size > 0);
+
+    link_table->setup_links(0, link_table->get_links_count(),
+                            [buffer_size](Link& link) { link.set_input_buffer_size(buffer_size); });
+}
+
+void Topology::set_virtual_channels(const int vcs_count,
+                                    const VirtualChannelArbitration arbitration,
+                                    const std::vector<int>& weights) noexcept {
+    assert(vcs_count > 0);
+    assert(weights.size() == vcs_count);
+
+    link_table->setup_links(0, link_table->get_links_count(), [vcs_count, arbitration, weights](Link& link) {
+        link.set_virtual_channels(vcs_count, arbitration, weights);
+    });
+}
+
+void Topology::set_switch_model(const SwitchQueueing queueing,
+                                const SwitchArbitration arbitration,
+                                const double speedup) noexcept {
+    assert(speedup > 0);
+
+    // switches are the devices beyond NPUs
+    const auto switches_count = static_cast<int>(devices.size()) - npus_count;
+    setup_devices(npus_count, switches_count, [queueing, arbitration, speedup](Device& device) {
+        device.set_crossbar(queueing, arbitration, speedup);
+    });
+}
+
+void Topology::set_network_interfaces(const Bandwidth injection_bandwidth,
+                                      const Bandwidth ejection_bandwidth,
+                                      const int dma_engines,
+                                      const NicScheduling scheduling) noexcept {
+    assert(injection_bandwidth >= 0);
+    assert(ejection_bandwidth >= 0);
+    assert(dma_engines > 0);
+
+    setup_devices(0, npus_count, [=](Device& device) {
+        device.set_network_interface(injection_bandwidth, ejection_bandwidth, dma_engines, scheduling);
+    });
+}
+
+void Topology::set_link_errors(const double bit_error_rate,
+                               const double packet_error_rate,
+                               const std::vector<std::tuple<int, int, double>>& link_error_rates,
+                               const Retransmission retransmission,
+                               const int window,
+                               const uint64_t seed) noexcept {
+    assert(0 <= bit_error_rate && bit_error_rate < 1);
+    assert(0 <= packet_error_rate && packet_error_rate < 1);
+    assert(window > 0);
+
+    // every link gets the topology-wide rates
+    link_table->setup_links(0, link_table->get_links_count(), [=](Link& link) {
+        link.set_error_model(bit_error_rate, packet_error_rate, retransmission, window, seed);
+    });
+
+    // then the per-link overrides
+    for (const auto& [src, dest, link_packet_error_rate] : link_error_rates) {
+        // assert the src and dest are valid
+        assert(0 <= src && src < devices_count);
+        assert(0 <= dest && dest < devices_count);
+
+        auto applied = false;
+        const auto set_error_model = [=, rate = link_packet_error_rate](Link& link) {
+            link.set_error_model(bit_error_rate, rate, retransmission, window, seed);
+        };
+        if (device(src)->connected(dest)) {
+            link_table->setup_link(device(src)->get_link_id(dest), set_error_model);
+            applied = true;
+        }
+        if (device(dest)->connected(src)) {
+            link_table->setup_link(device(dest)->get_link_id(src), set_error_model);
+            applied = true;
+        }
+
+        if (!applied) {
+            std::cerr << "[Warning] (network/analytical/congestion_aware) "
+                      << "link_error_rates entry ignored, no link between " << src << " and " << dest << std::endl;
+        }
+    }
+}
+
+void Topology::set_in_network_reduction(const Bandwidth throughput) noexcept {
+    assert(throughput >= 0);
+
+    // switches are the devices beyond NPUs
+    const auto switches_count = static_cast<int>(devices.size()) - npus_count;
+    setup_devices(npus_count, switches_count,
+                  [throughput](Device& device) { device.set_reduction_engine(throughput); });
+}
+
 void Topology::send(std::unique_ptr<Chunk> chunk) noexcept {
     assert(chunk != nullptr);
 
@@ -63,8 +466,113 @@ void Topology::send(std::unique_ptr<Chunk> chunk) noexcept {
     // assert src is valid
     assert(0 <= src && src < devices_count);
 
+    // spread the chunks leaving an NPU over its routes to dest
+    if (striping != StripingPolicy::None && src < npus_count && chunk->get_ingress_link() == nullptr) {
+        stripe(*chunk);
+    }
+
     // initiate transmission from src
-    devices.at(src)->send(std::move(chunk));
+    device(src)->send(std::move(chunk));
+}
+
+void Topology::set_striping(const StripingPolicy striping) noexcept {
+    this->striping = striping;
+}
+
+void Topology::stripe(Chunk& chunk) noexcept {
+    const auto src = chunk.current_device()->get_id();
+    const auto dest = chunk.dest_device()->get_id();
+    if (src == dest) {
+        return;
+    }
+
+    // the routes of a pair, and their weights, are only built once per each link health
+    const auto key = (static_cast<uint64_t>(src) << 32) | static_cast<uint32_t>(dest);
+    auto& state = striping_states[key];
+    if (state.routes.empty()) {
+        state.routes = routes(src, dest);
+        assert(!state.routes.empty());
+
+        // index the pair by the links its routes cross, for invalidate_cached_routes()
+        for (const auto& route : state.routes) {
+            for (auto current = route.begin(), next = std::next(route.begin()); next != route.end();
+                 current++, next++) {
+                striping_states_per_link[(*current)->get_link_id((*next)->get_id())].push_back(key);
+            }
+        }
+
+        if (striping == StripingPolicy::BandwidthWeighted) {
+            state.weights.resize(state.routes.size());
+            state.total_weight = 0;
+            for (auto i = size_t{0}; i < state.routes.size(); i++) {
+                state.weights[i] = bottleneck_bandwidth(state.routes[i]);
+                state.total_weight += state.weights[i];
+            }
+        }
+    }
+    const auto& candidate_routes = state.routes;
+    if (candidate_routes.size() == 1) {
+        return;
+    }
+
+    auto picked = size_t{0};
+    switch (striping) {
+    case StripingPolicy::Hash: {
+        // every chunk of a flow takes the same route
+        const auto flow = key ^ (static_cast<uint64_t>(chunk.get_traffic_class()) * 0x9e3779b97f4a7c15ULL);
+        picked = static_cast<size_t>(scramble(flow) % candidate_routes.size());
+        break;
+    }
+    case StripingPolicy::RoundRobin: {
+        picked = static_cast<size_t>(state.chunks_count % candidate_routes.size());
+        state.chunks_count++;
+        break;
+    }
+    case StripingPolicy::BandwidthWeighted: {
+        // smooth weighted round-robin: credit every route its weight, pick the richest, charge it the total
+        if (state.total_weight <= 0) {
+            // every route crosses a dead link, left for the links to reroute
+            break;
+        }
+
+        state.credits.resize(candidate_routes.size(), 0);
+        auto richest = -std::numeric_limits<double>::infinity();
+        for (auto i = size_t{0}; i < candidate_routes.size(); i++) {
+            // routes crossing a dead link earn no credit and are never picked
+            if (state.weights[i] <= 0) {
+                continue;
+            }
+            state.credits[i] += state.weights[i];
+            if (state.credits[i] > richest) {
+                richest = state.credits[i];
+                picked = i;
+            }
+        }
+        state.credits[picked] -= state.total_weight;
+        break;
+    }
+    default:
+        // shouldn't reach here
+        assert(false);
+    }
+
+    chunk.set_route(candidate_routes[picked]);
+}
+
+uint64_t Topology::scramble(uint64_t value) noexcept {
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+    return value ^ (value >> 31);
+}
+
+double Topology::bottleneck_bandwidth(const Route& route) const noexcept {
+    auto bandwidth = std::numeric_limits<double>::infinity();
+    for (auto current = route.begin(), next = std::next(route.begin()); next != route.end(); current++, next++) {
+        const auto link_id = (*current)->get_link_id((*next)->get_id());
+        bandwidth = std::min(bandwidth, link_table->get_bandwidth_Bpns(link_id) * link_table->get_health(link_id));
+    }
+
+    return bandwidth;
 }
 
 void Topology::connect(const DeviceId src,
@@ -91,25 +599,33 @@ void Topology::connect(const DeviceId src,
     }
 }
 
-void Topology::bus_connect(const DeviceId src,
-                       const DeviceId dest,
-                       const Bandwidth bandwidth,
-                       const Latency latency,
-                       const bool bidirectional) noexcept {
-    // assert the src and dest are valid
-    assert(0 <= src && src < devices_count);
-    assert(0 <= dest && dest < devices_count);
+void Topology::shared_medium_connect(const std::vector<DeviceId>& device_ids,
+                                     const Bandwidth bandwidth,
+                                     const Latency latency,
+                                     const BusArbitration arbitration) noexcept {
+    // assert the devices are valid
+    assert(device_ids.size() > 1);
+    for (const auto device_id : device_ids) {
+        assert(0 <= device_id && device_id < devices_count);
+    }
 
     // assert bandwidth and latency are valid
     assert(bandwidth > 0);
     assert(latency >= 0);
 
-    // connect src -> dest
-    devices.at(src)->connect(dest, bandwidth, latency);
+    // create the one link of the medium
+    const auto link_id = link_table->add_link(-1, -1, bandwidth, latency);
+    if (arbitration == BusArbitration::RoundRobin) {
+        link_table->setup_link(link_id, [device_ids](Link& link) { link.set_round_robin_ports(device_ids); });
+    }
 
-    // if bidirectional, connect dest -> src
-    if (bidirectional) {
-        devices.at(dest)->connect(src, bandwidth, latency);
+    // every attached device reaches every other one through the medium
+    for (const auto src : device_ids) {
+        for (const auto dest : device_ids) {
+            if (src != dest) {
+                devices.at(src)->attach(dest, link_id);
+            }
+        }
     }
 }
 
@@ -117,6 +633,89 @@ void Topology::bus_connect(const DeviceId src,
 void Topology::instantiate_devices() noexcept {
     // instantiate all devices
     for (auto i = 0; i < devices_count; i++) {
-        devices.push_back(std::make_shared<Device>(i));
+        devices.push_back(std::make_shared<Device>(i, link_table));
+    }
+}
+
+void Topology::set_fault_map(std::shared_ptr<const FaultMap> fault_map) noexcept {
+    this->fault_map = std::move(fault_map);
+}
+
+double Topology::fault_derate(const DeviceId src, const DeviceId dest) const noexcept {
+    // a health changed at runtime overrides the faulty links
+    if (!link_health.empty()) {
+        const auto it = link_health.find(FaultMap::key(src, dest));
+        if (it != link_health.end()) {
+            return it->second;
+        }
+    }
+
+    if (fault_map == nullptr) {
+        return 1.0;
     }
+
+    return fault_map->derate(src, dest);
+}
+
+bool Topology::has_faults() const noexcept {
+    return fault_map != nullptr || !link_health.empty();
+}
+
+double Topology::route_time_per_byte(const Route& route) const noexcept {
+    auto time_per_byte = 0.0;
+    for (auto current = route.begin(), next = std::next(route.begin()); next != route.end(); current++, next++) {
+        const auto link_id = (*current)->get_link_id((*next)->get_id());
+        const auto bandwidth = link_table->get_bandwidth_Bpns(link_id) * link_table->get_health(link_id);
+        if (bandwidth <= 0 || fault_derate((*current)->get_id(), (*next)->get_id()) == 0) {
+            return std::numeric_limits<double>::infinity();
+        }
+        time_per_byte += 1 / bandwidth;
+    }
+
+    return time_per_byte;
+}
+
+const std::shared_ptr<Device>& Topology::device(const DeviceId device_id) const noexcept {
+    assert(0 <= device_id && device_id < devices.size());
+
+    auto& entry = devices[device_id];
+    if (entry != nullptr) {
+        return entry;
+    }
+
+    // materialize the device of an implicit topology, attaching its ports in order, then replay its setups in order
+    entry = std::make_shared<Device>(device_id, link_table);
+    auto ports = std::vector<std::pair<DeviceId, LinkId>>();
+    get_implicit_ports(device_id, ports);
+    entry->reserve_ports(static_cast<int>(ports.size()));
+    for (const auto& [dest, link_id] : ports) {
+        entry->attach(dest, link_id);
+    }
+    for (const auto& [first_device_id, end_device_id, setup] : device_setups) {
+        if (first_device_id <= device_id && device_id < end_device_id) {
+            setup(*entry);
+        }
+    }
+
+    return entry;
+}
+
+void Topology::setup_devices(const DeviceId first_device_id, const int count, const DeviceSetup& setup) noexcept {
+    assert(first_device_id >= 0);
+    assert(count >= 0);
+    assert(first_device_id + count <= devices.size());
+
+    const auto end_device_id = first_device_id + count;
+    for (auto device_id = first_device_id; device_id < end_device_id; device_id++) {
+        if (devices[device_id] != nullptr) {
+            setup(*devices[device_id]);
+        }
+    }
+    device_setups.push_back({first_device_id, end_device_id, setup});
+}
+
+void Topology::get_implicit_ports(const DeviceId /* device_id */,
+                                  std::vector<std::pair<DeviceId, LinkId>>& /* ports */) const noexcept {
+    // only implicit topologies leave devices to be materialized
+    assert(false);
 }
@@ -0,0 +1,169 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/TopologyCache.h"
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace NetworkAnalyticalCongestionAware;
+
+std::string TopologyCache::get_path(const std::string& cache_directory, const uint64_t topology_hash) noexcept {
+    auto file_name = std::ostringstream();
+    file_name << "topology-" << std::hex << std::setw(16) << std::setfill('0') << topology_hash << ".bin";
+
+    return (std::filesystem::path(cache_directory) / file_name.str()).string();
+}
+
+std::unique_ptr<TopologyCache> TopologyCache::load(const std::string& path, const uint64_t topology_hash) noexcept {
+    const auto fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    // the file must at least hold its header
+    struct stat file_stat {};
+    if (fstat(fd, &file_stat) != 0 || static_cast<size_t>(file_stat.st_size) < sizeof(FileHeader)) {
+        close(fd);
+        return nullptr;
+    }
+    const auto mapping_size = static_cast<size_t>(file_stat.st_size);
+    auto* const mapping = mmap(nullptr, mapping_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return nullptr;
+    }
+
+    // reject a file of another format version or config, or whose size doesn't match its header
+    const auto& header = *static_cast<const FileHeader*>(mapping);
+    if (std::memcmp(header.magic, file_magic, sizeof(file_magic)) != 0 || header.version != format_version ||
+        header.topology_hash != topology_hash || get_layout(header).file_size != mapping_size) {
+        munmap(mapping, mapping_size);
+        return nullptr;
+    }
+
+    // point the arrays into the mapping
+    const auto layout = get_layout(header);
+    const auto* const base = static_cast<const char*>(mapping);
+    auto compiled_topology = CompiledTopology();
+    compiled_topology.dims_count = static_cast<int>(header.dims_count);
+    compiled_topology.devices_count = static_cast<int>(header.devices_count);
+    compiled_topology.links_count = static_cast<int>(header.links_count);
+    compiled_topology.ports_count = static_cast<int64_t>(header.ports_count);
+    compiled_topology.first_link_per_dim = reinterpret_cast<const LinkId*>(base + layout.first_link_per_dim);
+    compiled_topology.link_srcs = reinterpret_cast<const DeviceId*>(base + layout.link_srcs);
+    compiled_topology.link_dests = reinterpret_cast<const DeviceId*>(base + layout.link_dests);
+    compiled_topology.link_bandwidths_Bpns = reinterpret_cast<const Bandwidth*>(base + layout.link_bandwidths_Bpns);
+    compiled_topology.link_latencies = reinterpret_cast<const Latency*>(base + layout.link_latencies);
+    compiled_topology.port_offsets = reinterpret_cast<const int64_t*>(base + layout.port_offsets);
+    compiled_topology.port_dests = reinterpret_cast<const DeviceId*>(base + layout.port_dests);
+    compiled_topology.port_links = reinterpret_cast<const LinkId*>(base + layout.port_links);
+
+    return std::unique_ptr<TopologyCache>(new TopologyCache(mapping, mapping_size, compiled_topology));
+}
+
+bool TopologyCache::save(const std::string& path,
+                         const uint64_t topology_hash,
+                         const CompiledTopology& compiled_topology) noexcept {
+    assert(compiled_topology.dims_count > 0);
+    assert(compiled_topology.devices_count > 0);
+    assert(compiled_topology.links_count >= 0);
+    assert(compiled_topology.ports_count >= 0);
+
+    auto header = FileHeader();
+    std::memcpy(header.magic, file_magic, sizeof(file_magic));
+    header.version = format_version;
+    header.dims_count = static_cast<uint32_t>(compiled_topology.dims_count);
+    header.topology_hash = topology_hash;
+    header.devices_count = static_cast<uint64_t>(compiled_topology.devices_count);
+    header.links_count = static_cast<uint64_t>(compiled_topology.links_count);
+    header.ports_count = static_cast<uint64_t>(compiled_topology.ports_count);
+
+    // lay out the file in memory
+    const auto layout = get_layout(header);
+    auto buffer = std::vector<char>(layout.file_size, 0);
+    const auto place = [&buffer](const size_t offset, const void* const array, const size_t bytes) {
+        if (bytes > 0) {
+            std::memcpy(buffer.data() + offset, array, bytes);
+        }
+    };
+    const auto links_count = static_cast<size_t>(compiled_topology.links_count);
+    const auto ports_count = static_cast<size_t>(compiled_topology.ports_count);
+    place(0, &header, sizeof(header));
+    place(layout.first_link_per_dim, compiled_topology.first_link_per_dim,
+          (header.dims_count + 1) * sizeof(LinkId));
+    place(layout.link_srcs, compiled_topology.link_srcs, links_count * sizeof(DeviceId));
+    place(layout.link_dests, compiled_topology.link_dests, links_count * sizeof(DeviceId));
+    place(layout.link_bandwidths_Bpns, compiled_topology.link_bandwidths_Bpns, links_count * sizeof(Bandwidth));
+    place(layout.link_latencies, compiled_topology.link_latencies, links_count * sizeof(Latency));
+    place(layout.port_offsets, compiled_topology.port_offsets, (header.devices_count + 1) * sizeof(int64_t));
+    place(layout.port_dests, compiled_topology.port_dests, ports_count * sizeof(DeviceId));
+    place(layout.port_links, compiled_topology.port_links, ports_count * sizeof(LinkId));
+
+    // write aside, then rename over the final path, which is atomic
+    auto error = std::error_code();
+    const auto directory = std::filesystem::path(path).parent_path();
+    if (!directory.empty()) {
+        std::filesystem::create_directories(directory, error);
+    }
+    const auto temporary_path = path + ".tmp." + std::to_string(getpid());
+    {
+        auto file = std::ofstream(temporary_path, std::ios::binary | std::ios::trunc);
+        file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        if (!file) {
+            std::remove(temporary_path.c_str());
+            return false;
+        }
+    }
+
+    return std::rename(temporary_path.c_str(), path.c_str()) == 0;
+}
+
+TopologyCache::TopologyCache(void* const mapping, const size_t mapping_size, const CompiledTopology compiled_topology) noexcept
+    : mapping(mapping),
+      mapping_size(mapping_size),
+      compiled_topology(compiled_topology) {
+    assert(mapping != nullptr);
+}
+
+TopologyCache::~TopologyCache() noexcept {
+    munmap(mapping, mapping_size);
+}
+
+const TopologyCache::CompiledTopology& TopologyCache::get_compiled_topology() const noexcept {
+    return compiled_topology;
+}
+
+TopologyCache::FileLayout TopologyCache::get_layout(const FileHeader& header) noexcept {
+    // place each array after the previous one, at the next multiple of 8 bytes
+    auto offset = sizeof(FileHeader);
+    const auto place = [&offset](const size_t bytes) {
+        const auto array_offset = (offset + 7) & ~size_t{7};
+        offset = array_offset + bytes;
+        return array_offset;
+    };
+
+    auto layout = FileLayout();
+    layout.first_link_per_dim = place((header.dims_count + 1) * sizeof(LinkId));
+    layout.link_srcs = place(header.links_count * sizeof(DeviceId));
+    layout.link_dests = place(header.links_count * sizeof(DeviceId));
+    layout.link_bandwidths_Bpns = place(header.links_count * sizeof(Bandwidth));
+    layout.link_latencies = place(header.links_count * sizeof(Latency));
+    layout.port_offsets = place((header.devices_count + 1) * sizeof(int64_t));
+    layout.port_dests = place(header.ports_count * sizeof(DeviceId));
+    layout.port_links = place(header.ports_count * sizeof(LinkId));
+    layout.file_size = (offset + 7) & ~size_t{7};
+
+    return layout;
+}
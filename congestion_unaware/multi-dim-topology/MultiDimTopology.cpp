@@ -56,35 +56,14 @@ void MultiDimTopology::append_dimension(std::unique_ptr<BasicTopology> topology)
     // push back topology and npus_count
     topology_per_dim.push_back(std::move(topology));
     npus_count_per_dim.push_back(topology_size);
+    address_translator.append_dimension(topology_size);
 }
 
 MultiDimAddress MultiDimTopology::translate_address(const DeviceId npu_id) const noexcept {
-    // If units-count if [2, 8, 4], and the given id is 47, then the id should be
-    // 47 // 16 = 2, leftover = 47 % 16 = 15
-    // 15 // 2 = 7, leftover = 15 % 2 = 1
-    // 1 // 1 = 1, leftover = 0
-    // therefore the address is [1, 7, 2]
-
-    // create empty address
-    auto multi_dim_address = MultiDimAddress();
-    for (auto i = 0; i < dims_count; i++) {
-        multi_dim_address.push_back(-1);
-    }
-
-    auto leftover = npu_id;
-    auto denominator = npus_count;
+    assert(0 <= npu_id && npu_id < npus_count);
 
-    for (auto dim = dims_count - 1; dim >= 0; dim--) {
-        // change denominator
-        denominator /= npus_count_per_dim[dim];
-
-        // get and update address
-        const auto quotient = leftover / denominator;
-        leftover %= denominator;
-
-        // update address
-        multi_dim_address[dim] = quotient;
-    }
+    // e.g., if units-count if [2, 8, 4] and the given id is 47, the address is [1, 7, 2]
+    const auto multi_dim_address = address_translator.translate_address(npu_id);
 
     // check address translation
     for (auto i = 0; i < dims_count; i++) {
@@ -0,0 +1,105 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/MultiDimAddress.h"
+#include "common/Type.h"
+#include <array>
+#include <cstdint>
+
+namespace NetworkAnalytical {
+
+/**
+ * FastDivisor divides by an invariant divisor with a multiplication and a shift,
+ * using a multiplier computed once when the divisor is set.
+ */
+class FastDivisor {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param divisor divisor, must be positive
+     */
+    explicit FastDivisor(uint32_t divisor = 1) noexcept;
+
+    /**
+     * Divide a number by the divisor.
+     *
+     * @param dividend number to divide
+     * @return quotient of the division
+     */
+    [[nodiscard]] uint32_t divide(const uint32_t dividend) const noexcept {
+        // the multiplier wraps to 0 only when dividing by 1
+        if (multiplier == 0) {
+            return dividend;
+        }
+        return static_cast<uint32_t>((static_cast<__uint128_t>(multiplier) * dividend) >> 64);
+    }
+
+  private:
+    /// ceil(2^64 / divisor), which makes the high half of multiplier * dividend the exact quotient
+    uint64_t multiplier;
+};
+
+/**
+ * AddressTranslator translates NPU ids of a multi-dimensional topology
+ * to their multi-dimensional addresses and back.
+ * Dimension 0 is the least significant one, and the per-dimension strides and divisors
+ * are computed once when each dimension is appended.
+ */
+class AddressTranslator {
+  public:
+    /**
+     * Constructor.
+     */
+    AddressTranslator() noexcept;
+
+    /**
+     * Append a dimension on top of the existing ones.
+     *
+     * @param npus_count number of NPUs in the new dimension
+     */
+    void append_dimension(int npus_count) noexcept;
+
+    /**
+     * Translate an NPU id to its multi-dimensional address.
+     *
+     * @param npu_id NPU id
+     * @return multi-dimensional address of the NPU
+     */
+    [[nodiscard]] MultiDimAddress translate_address(DeviceId npu_id) const noexcept;
+
+    /**
+     * Translate a multi-dimensional address back to its NPU id.
+     *
+     * @param address multi-dimensional address of the NPU
+     * @return NPU id
+     */
+    [[nodiscard]] DeviceId translate_address_back(const MultiDimAddress& address) const noexcept;
+
+    /**
+     * Get the difference between the ids of two NPUs one step apart in a dimension.
+     *
+     * @param dim dimension
+     * @return stride of the dimension
+     */
+    [[nodiscard]] DeviceId get_stride(int dim) const noexcept;
+
+  private:
+    /// number of dimensions
+    int dims_count;
+
+    /// number of NPUs per each dimension
+    std::array<int, MultiDimAddress::max_dims_count> npus_count_per_dim;
+
+    /// stride of each dimension, i.e., the product of the NPUs counts of the lower dimensions
+    std::array<DeviceId, MultiDimAddress::max_dims_count> strides;
+
+    /// divisor by the NPUs count of each dimension
+    std::array<FastDivisor, MultiDimAddress::max_dims_count> divisors;
+};
+
+}  // namespace NetworkAnalytical
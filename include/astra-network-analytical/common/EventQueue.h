@@ -52,12 +52,27 @@ class EventQueue {
      */
     void schedule_event(EventTime event_time, Callback callback, CallbackArg callback_arg) noexcept;
 
+    /**
+     * Set the callback invoked whenever proceeding leaves the event queue empty,
+     * e.g., to check that no work was left stranded.
+     *
+     * @param callback callback function pointer, nullptr to clear it
+     * @param callback_arg argument of the callback function
+     */
+    void set_drain_callback(Callback callback, CallbackArg callback_arg) noexcept;
+
   private:
     /// current time of the event queue
     EventTime current_time;
 
     /// list of EventLists
     std::list<EventList> event_queue;
+
+    /// callback invoked once the event queue gets empty, nullptr if none
+    Callback drain_callback;
+
+    /// argument of drain_callback
+    CallbackArg drain_callback_arg;
 };
 
 }  // namespace NetworkAnalytical
@@ -0,0 +1,141 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <type_traits>
+
+namespace NetworkAnalytical {
+
+/**
+ * Multi-dimensional address of a device.
+ * Each NPU ID can be broken down into multiple dimensions.
+ * for example, if the topology size is [2, 8, 4] and the NPU ID is 31,
+ * then the NPU ID can be broken down into [1, 7, 1].
+ *
+ * The coordinates are stored inline, up to max_dims_count dimensions,
+ * so addresses can be created and copied on every route without heap allocations.
+ */
+class MultiDimAddress {
+  public:
+    /// maximum number of dimensions of an address
+    static constexpr int max_dims_count = 8;
+
+    using iterator = DeviceId*;
+    using const_iterator = const DeviceId*;
+
+    /**
+     * Constructor of an empty address.
+     */
+    MultiDimAddress() noexcept : coordinates{}, dims_count(0) {}
+
+    /**
+     * Constructor.
+     *
+     * @param dims_count number of dimensions
+     * @param coordinate coordinate of every dimension
+     */
+    MultiDimAddress(const size_t dims_count, const DeviceId coordinate) noexcept
+        : coordinates{}, dims_count(static_cast<int>(dims_count)) {
+        assert(dims_count <= max_dims_count);
+        std::fill_n(coordinates.begin(), dims_count, coordinate);
+    }
+
+    /**
+     * Constructor from a range of coordinates.
+     *
+     * @param first iterator to the coordinate of dimension 0
+     * @param last iterator past the coordinate of the last dimension
+     */
+    template <typename InputIt, typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+    MultiDimAddress(InputIt first, InputIt last) noexcept : coordinates{}, dims_count(0) {
+        for (; first != last; ++first) {
+            push_back(static_cast<DeviceId>(*first));
+        }
+    }
+
+    /**
+     * Constructor from a list of coordinates.
+     *
+     * @param coordinates coordinate of each dimension
+     */
+    MultiDimAddress(const std::initializer_list<DeviceId> coordinates) noexcept
+        : MultiDimAddress(coordinates.begin(), coordinates.end()) {}
+
+    /**
+     * Append a dimension to the address.
+     *
+     * @param coordinate coordinate of the new dimension
+     */
+    void push_back(const DeviceId coordinate) noexcept {
+        assert(dims_count < max_dims_count);
+        coordinates[dims_count++] = coordinate;
+    }
+
+    [[nodiscard]] size_t size() const noexcept {
+        return static_cast<size_t>(dims_count);
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return dims_count == 0;
+    }
+
+    [[nodiscard]] DeviceId& operator[](const size_t dim) noexcept {
+        return coordinates[dim];
+    }
+
+    [[nodiscard]] DeviceId operator[](const size_t dim) const noexcept {
+        return coordinates[dim];
+    }
+
+    [[nodiscard]] DeviceId& at(const size_t dim) noexcept {
+        assert(dim < size());
+        return coordinates[dim];
+    }
+
+    [[nodiscard]] DeviceId at(const size_t dim) const noexcept {
+        assert(dim < size());
+        return coordinates[dim];
+    }
+
+    [[nodiscard]] iterator begin() noexcept {
+        return coordinates.data();
+    }
+
+    [[nodiscard]] iterator end() noexcept {
+        return coordinates.data() + dims_count;
+    }
+
+    [[nodiscard]] const_iterator begin() const noexcept {
+        return coordinates.data();
+    }
+
+    [[nodiscard]] const_iterator end() const noexcept {
+        return coordinates.data() + dims_count;
+    }
+
+    [[nodiscard]] bool operator==(const MultiDimAddress& other) const noexcept {
+        return std::equal(begin(), end(), other.begin(), other.end());
+    }
+
+    [[nodiscard]] bool operator!=(const MultiDimAddress& other) const noexcept {
+        return !(*this == other);
+    }
+
+  private:
+    /// coordinate of each dimension, only the first dims_count are valid
+    std::array<DeviceId, max_dims_count> coordinates;
+
+    /// number of dimensions of the address
+    int dims_count;
+};
+
+}  // namespace NetworkAnalytical
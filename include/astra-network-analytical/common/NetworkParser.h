@@ -63,6 +63,235 @@ class NetworkParser {
     [[nodiscard]] std::vector<std::tuple<int, int, double>> get_faulty_links() const noexcept;
     [[nodiscard]] std::vector<int> get_non_recursive_topo() const noexcept;
 
+    /**
+     * Read "bandwidth_schedule" value, merged with the steps of "bandwidth_schedule_file" if given.
+     * Each step is (src, dst, time in ns, bandwidth scale),
+     * meaning the link between src and dst runs at (scale * bandwidth) from the given time on.
+     *
+     * @return list of bandwidth schedule steps
+     */
+    [[nodiscard]] std::vector<std::tuple<int, int, EventTime, double>> get_bandwidth_schedule() const noexcept;
+
+    /**
+     * Read "link_health_schedule" value.
+     * Each change is (src, dst, time in ns, health),
+     * meaning the link between src and dst runs at (health * bandwidth) from the given time on,
+     * 0 failing the link and 1 restoring it.
+     *
+     * @return list of link health changes
+     */
+    [[nodiscard]] std::vector<std::tuple<int, int, EventTime, double>> get_link_health_schedule() const noexcept;
+
+    /**
+     * Read "input_buffer_size" value
+     * Ring dimensions need buffers larger than the traffic going around them, or deadlock-free routing,
+     * as their buffers depend on each other cyclically; a credit deadlock is reported as an error.
+     *
+     * @return input buffer size in bytes per each dimension, empty if buffers are unbounded
+     */
+    [[nodiscard]] std::vector<ChunkSize> get_input_buffer_sizes_per_dim() const noexcept;
+
+    /**
+     * Read "virtual_channels" value
+     *
+     * @return number of virtual channels per link, 1 if not given
+     */
+    [[nodiscard]] int get_virtual_channels_count() const noexcept;
+
+    /**
+     * Read "vc_arbitration" value
+     *
+     * @return arbitration policy among the virtual channels, StrictPriority if not given
+     */
+    [[nodiscard]] VirtualChannelArbitration get_vc_arbitration() const noexcept;
+
+    /**
+     * Read "vc_weights" value
+     *
+     * @return number of chunks each virtual channel sends per WeightedRoundRobin turn, all 1 if not given
+     */
+    [[nodiscard]] std::vector<int> get_vc_weights() const noexcept;
+
+    /**
+     * Read "bus_arbitration" value
+     *
+     * @return arbitration policy among the devices attached to a Bus, FIFO if not given
+     */
+    [[nodiscard]] BusArbitration get_bus_arbitration() const noexcept;
+
+    /**
+     * Read "switch_queueing" value
+     *
+     * @return queueing discipline of the switch crossbars, Ideal if not given
+     */
+    [[nodiscard]] SwitchQueueing get_switch_queueing() const noexcept;
+
+    /**
+     * Read "switch_arbitration" value
+     *
+     * @return arbitration policy of input-queued switch crossbars, RoundRobin if not given
+     */
+    [[nodiscard]] SwitchArbitration get_switch_arbitration() const noexcept;
+
+    /**
+     * Read "crossbar_speedup" value
+     *
+     * @return bandwidth of each crossbar port relative to its egress link, 1 if not given
+     */
+    [[nodiscard]] double get_crossbar_speedup() const noexcept;
+
+    /**
+     * Read "nic_injection_bandwidth" value
+     *
+     * @return aggregate injection bandwidth per NPU in GB/s, 0 (unlimited) if not given
+     */
+    [[nodiscard]] Bandwidth get_nic_injection_bandwidth() const noexcept;
+
+    /**
+     * Read "nic_ejection_bandwidth" value
+     *
+     * @return aggregate ejection bandwidth per NPU in GB/s, 0 (unlimited) if not given
+     */
+    [[nodiscard]] Bandwidth get_nic_ejection_bandwidth() const noexcept;
+
+    /**
+     * Read "nic_dma_engines" value
+     *
+     * @return number of DMA engines per NPU, 1 if not given
+     */
+    [[nodiscard]] int get_nic_dma_engines() const noexcept;
+
+    /**
+     * Read "nic_scheduling" value
+     *
+     * @return order in which waiting chunks take a free DMA engine, FIFO if not given
+     */
+    [[nodiscard]] NicScheduling get_nic_scheduling() const noexcept;
+
+    /**
+     * Read "bit_error_rate" value
+     *
+     * @return probability of a corrupted bit on every link, 0 if not given
+     */
+    [[nodiscard]] double get_bit_error_rate() const noexcept;
+
+    /**
+     * Read "packet_error_rate" value
+     *
+     * @return probability of a corrupted chunk on every link, 0 if not given
+     */
+    [[nodiscard]] double get_packet_error_rate() const noexcept;
+
+    /**
+     * Read "link_error_rates" value
+     *
+     * @return per-link packet error rates overriding packet_error_rate, (src, dst, packet error rate)
+     */
+    [[nodiscard]] std::vector<std::tuple<int, int, double>> get_link_error_rates() const noexcept;
+
+    /**
+     * Read "retransmission" value
+     *
+     * @return retransmission protocol of corrupted chunks, SelectiveRepeat if not given
+     */
+    [[nodiscard]] Retransmission get_retransmission() const noexcept;
+
+    /**
+     * Read "retransmission_window" value
+     *
+     * @return number of chunks a GoBackN sender can have in flight, 8 if not given
+     */
+    [[nodiscard]] int get_retransmission_window() const noexcept;
+
+    /**
+     * Read "error_seed" value
+     *
+     * @return seed of the random streams drawing link errors, 0 if not given
+     */
+    [[nodiscard]] uint64_t get_error_seed() const noexcept;
+
+    /**
+     * Read "construction_threads" value
+     *
+     * @return number of threads building the topology, 0 (all hardware threads) if not given
+     */
+    [[nodiscard]] int get_construction_threads() const noexcept;
+
+    /**
+     * Read "lazy_links" value
+     *
+     * @return whether links are only materialized once used, false if not given
+     */
+    [[nodiscard]] bool get_lazy_links() const noexcept;
+
+    /**
+     * Read "implicit_topology" value
+     *
+     * @return whether devices and links are computed from their addresses and only materialized once used,
+     *     false if not given
+     */
+    [[nodiscard]] bool get_implicit_topology() const noexcept;
+
+    /**
+     * Read "adaptive_routing" value
+     *
+     * @return whether multi-dimensional routes pick the dimension traversed first by the load of the links,
+     *     false if not given
+     */
+    [[nodiscard]] bool get_adaptive_routing() const noexcept;
+
+    /**
+     * Read "striping" value
+     *
+     * @return policy spreading the chunks of each NPU pair over the routes between them, None if not given
+     */
+    [[nodiscard]] StripingPolicy get_striping() const noexcept;
+
+    /**
+     * Read "cluster_agents" value
+     *
+     * @return number of agents per cluster crossing the non-recursive dimensions, 1 if not given
+     */
+    [[nodiscard]] int get_cluster_agents() const noexcept;
+
+    /**
+     * Read "cluster_agent_selection" value
+     *
+     * @return policy picking the agent of each chunk among the cluster agents, Hash if not given
+     */
+    [[nodiscard]] ClusterAgentSelection get_cluster_agent_selection() const noexcept;
+
+    /**
+     * Read "topology_cache" value
+     * A relative directory is resolved against the directory of the network config file.
+     *
+     * @return directory of the compiled topologies, empty (no caching) if not given
+     */
+    [[nodiscard]] std::string get_topology_cache() const noexcept;
+
+    /**
+     * Hash the values the connections of the topology are built from,
+     * i.e., the shape of each dimension, the faulty links, and the non-recursive dimensions.
+     * Configs differing only in other values (buffers, NICs, errors, ...) share a compiled topology.
+     *
+     * @return hash of the topology
+     */
+    [[nodiscard]] uint64_t get_topology_hash() const noexcept;
+
+    /**
+     * Read "in_network_reduction" value
+     *
+     * @return whether the switches of each dimension reduce chunks, all false if not given
+     */
+    [[nodiscard]] std::vector<bool> get_in_network_reduction_per_dim() const noexcept;
+
+    /**
+     * Read "reduction_throughput" value
+     *
+     * @return reduction throughput of each switch per each dimension in GB/s, all 0 (instant) if not given
+     */
+    [[nodiscard]] std::vector<Bandwidth> get_reduction_throughputs_per_dim() const noexcept;
+
 
   private:
     /// number of network dimensions
@@ -75,6 +304,99 @@ class NetworkParser {
     std::vector<std::tuple<int, int, double>> faulty_links;
     std::vector<int> non_recursive_topo;
 
+    /// path of the network configuration file
+    std::string config_path;
+
+    /// piecewise-constant bandwidth schedule steps, (src, dst, time, scale)
+    std::vector<std::tuple<int, int, EventTime, double>> bandwidth_schedule;
+
+    /// link health changes at runtime, (src, dst, time, health)
+    std::vector<std::tuple<int, int, EventTime, double>> link_health_schedule;
+
+    /// input buffer size per each dimension, empty if buffers are unbounded
+    std::vector<ChunkSize> input_buffer_size_per_dim;
+
+    /// number of virtual channels per link
+    int virtual_channels_count;
+
+    /// arbitration policy among the virtual channels
+    VirtualChannelArbitration vc_arbitration;
+
+    /// WeightedRoundRobin weight per each virtual channel
+    std::vector<int> vc_weights;
+
+    /// arbitration policy among the devices attached to a Bus
+    BusArbitration bus_arbitration;
+
+    /// queueing discipline of the switch crossbars
+    SwitchQueueing switch_queueing;
+
+    /// arbitration policy of input-queued switch crossbars
+    SwitchArbitration switch_arbitration;
+
+    /// bandwidth of each crossbar port relative to its egress link
+    double crossbar_speedup;
+
+    /// aggregate injection bandwidth per NPU, 0 if unlimited
+    Bandwidth nic_injection_bandwidth;
+
+    /// aggregate ejection bandwidth per NPU, 0 if unlimited
+    Bandwidth nic_ejection_bandwidth;
+
+    /// number of DMA engines per NPU
+    int nic_dma_engines;
+
+    /// order in which waiting chunks take a free DMA engine
+    NicScheduling nic_scheduling;
+
+    /// probability of a corrupted bit on every link
+    double bit_error_rate;
+
+    /// probability of a corrupted chunk on every link
+    double packet_error_rate;
+
+    /// per-link packet error rates, (src, dst, packet error rate)
+    std::vector<std::tuple<int, int, double>> link_error_rates;
+
+    /// retransmission protocol of corrupted chunks
+    Retransmission retransmission;
+
+    /// number of chunks a GoBackN sender can have in flight
+    int retransmission_window;
+
+    /// seed of the random streams drawing link errors
+    uint64_t error_seed;
+
+    /// number of threads building the topology, 0 for all hardware threads
+    int construction_threads;
+
+    /// whether links are only materialized once used
+    bool lazy_links;
+
+    /// whether devices and links are computed from their addresses and only materialized once used
+    bool implicit_topology;
+
+    /// whether multi-dimensional routes pick the dimension traversed first by the load of the links
+    bool adaptive_routing;
+
+    /// policy spreading the chunks of each NPU pair over the routes between them
+    StripingPolicy striping;
+
+    /// number of agents per cluster crossing the non-recursive dimensions
+    int cluster_agents;
+
+    /// policy picking the agent of each chunk among the cluster agents
+    ClusterAgentSelection cluster_agent_selection;
+
+    /// directory of the compiled topologies, empty if topologies are not cached
+    std::string topology_cache;
+
+    /// whether the switches of each dimension reduce chunks, empty if not given
+    std::vector<int> in_network_reduction_per_dim;
+
+    /// reduction throughput of each switch per each dimension, empty if not given
+    std::vector<Bandwidth> reduction_throughput_per_dim;
+
 
     /// bandwidth per each dimension
     std::vector<Bandwidth> bandwidth_per_dim;
@@ -94,6 +416,80 @@ class NetworkParser {
      */
     [[nodiscard]] static TopologyBuildingBlock parse_topology_name(const std::string& topology_name) noexcept;
 
+    /**
+     * Parse arbitration policy name (in string) into VirtualChannelArbitration enum
+     *
+     * @param arbitration_name arbitration policy name in string
+     *    which can be "StrictPriority" or "WeightedRoundRobin"
+     * @return parsed VirtualChannelArbitration enum class value
+     */
+    [[nodiscard]] static VirtualChannelArbitration parse_vc_arbitration_name(
+        const std::string& arbitration_name) noexcept;
+
+    /**
+     * Parse arbitration policy name (in string) into BusArbitration enum
+     *
+     * @param arbitration_name arbitration policy name in string
+     *    which can be "FIFO" or "RoundRobin"
+     * @return parsed BusArbitration enum class value
+     */
+    [[nodiscard]] static BusArbitration parse_bus_arbitration_name(const std::string& arbitration_name) noexcept;
+
+    /**
+     * Parse queueing discipline name (in string) into SwitchQueueing enum
+     *
+     * @param queueing_name queueing discipline name in string
+     *    which can be "Ideal", "OutputQueued", or "InputQueued"
+     * @return parsed SwitchQueueing enum class value
+     */
+    [[nodiscard]] static SwitchQueueing parse_switch_queueing_name(const std::string& queueing_name) noexcept;
+
+    /**
+     * Parse arbitration policy name (in string) into SwitchArbitration enum
+     *
+     * @param arbitration_name arbitration policy name in string
+     *    which can be "RoundRobin" or "iSLIP"
+     * @return parsed SwitchArbitration enum class value
+     */
+    [[nodiscard]] static SwitchArbitration parse_switch_arbitration_name(const std::string& arbitration_name) noexcept;
+
+    /**
+     * Parse scheduling policy name (in string) into NicScheduling enum
+     *
+     * @param scheduling_name scheduling policy name in string
+     *    which can be "FIFO" or "RoundRobin"
+     * @return parsed NicScheduling enum class value
+     */
+    [[nodiscard]] static NicScheduling parse_nic_scheduling_name(const std::string& scheduling_name) noexcept;
+
+    /**
+     * Parse retransmission protocol name (in string) into Retransmission enum
+     *
+     * @param retransmission_name retransmission protocol name in string
+     *    which can be "GoBackN" or "SelectiveRepeat"
+     * @return parsed Retransmission enum class value
+     */
+    [[nodiscard]] static Retransmission parse_retransmission_name(const std::string& retransmission_name) noexcept;
+
+    /**
+     * Parse striping policy name (in string) into StripingPolicy enum
+     *
+     * @param striping_name striping policy name in string
+     *    which can be "None", "Hash", "RoundRobin", or "BandwidthWeighted"
+     * @return parsed StripingPolicy enum class value
+     */
+    [[nodiscard]] static StripingPolicy parse_striping_name(const std::string& striping_name) noexcept;
+
+    /**
+     * Parse agent selection policy name (in string) into ClusterAgentSelection enum
+     *
+     * @param selection_name agent selection policy name in string
+     *    which can be "Hash" or "LeastLoaded"
+     * @return parsed ClusterAgentSelection enum class value
+     */
+    [[nodiscard]] static ClusterAgentSelection parse_cluster_agent_selection_name(
+        const std::string& selection_name) noexcept;
+
     /**
      * Parse the given YAML node and retrieve network configuration values
      *
@@ -101,6 +497,14 @@ class NetworkParser {
      */
     void parse_network_config_yml(const YAML::Node& network_config) noexcept;
 
+    /**
+     * Parse a list of bandwidth schedule steps, each in [src, dst, time, scale] format,
+     * and append them to bandwidth_schedule.
+     *
+     * @param schedule_node YAML node (in list type) to read
+     */
+    void parse_bandwidth_schedule(const YAML::Node& schedule_node) noexcept;
+
     /**
      * Check the validity and correctness of the parsed network input
      * configurations.
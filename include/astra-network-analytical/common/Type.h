@@ -31,6 +31,36 @@ using Latency = double;
 /// Event time in ns
 using EventTime = uint64_t;
 
+/// Traffic class of a chunk, larger values are more latency-critical
+using TrafficClass = int;
+
+/// Reduction group of a chunk, i.e., the collective its contribution is reduced in
+using ReductionGroup = int;
+
+/// Arbitration policy among the virtual channels of a link
+enum class VirtualChannelArbitration { StrictPriority, WeightedRoundRobin };
+
+/// Arbitration policy among the devices attached to a shared-medium bus
+enum class BusArbitration { FIFO, RoundRobin };
+
+/// Queueing discipline of a switch crossbar, Ideal if the crossbar never contends
+enum class SwitchQueueing { Ideal, OutputQueued, InputQueued };
+
+/// Arbitration policy of an input-queued switch crossbar
+enum class SwitchArbitration { RoundRobin, iSLIP };
+
+/// Order in which a network interface injects chunks heading to different destinations
+enum class NicScheduling { FIFO, RoundRobin };
+
+/// Retransmission protocol recovering the chunks corrupted on a link
+enum class Retransmission { GoBackN, SelectiveRepeat };
+
+/// Policy spreading the chunks an NPU sends to another over the routes between them
+enum class StripingPolicy { None, Hash, RoundRobin, BandwidthWeighted };
+
+/// Policy picking the agent a chunk leaves and enters the clusters of a cluster topology through
+enum class ClusterAgentSelection { Hash, LeastLoaded };
+
 /// Basic multi-dimensional topology building blocks
 enum class TopologyBuildingBlock {
     Undefined,
@@ -47,12 +77,6 @@ enum class TopologyBuildingBlock {
     KingMesh2D
 };
 
-/// Multi-dimensional address of a device.
-/// Each NPU ID can be broken down into multiple dimensions.
-/// for example, if the topology size is [2, 8, 4] and the NPU ID is 31,
-/// then the NPU ID can be broken down into [1, 7, 1].
-using MultiDimAddress = std::vector<DeviceId>;
-
 enum class ConnectionType { Dedicated, Shared };
 /// Connection policy between two devices, (src, dst) means a link from src to dst
 struct ConnectionPolicy {
@@ -14,30 +14,38 @@ using namespace NetworkAnalytical;
 namespace NetworkAnalyticalCongestionAware {
 
 /**
- * Implements a switch topology.
+ * Implements a shared-medium bus topology.
  *
- * Switch(4) example:
- * <-switch->
+ * Bus(4) example:
+ * <---bus--->
  * |  |  |  |
  * 0  1  2  3
  *
- * Therefore, the number of NPUs is 4 (excluding the switch),
- * and the number of devices is 5 (including the switch).
+ * All NPUs are attached to a single shared link,
+ * so only one chunk can be on the bus at a time.
+ * Therefore, the number of NPUs and devices are both 4,
+ * and the number of links is 1.
  *
  * For example, send(0 -> 2) flows through:
- * 0 -> switch -> 2
- * so takes 2 hops.
+ * 0 -> 2
+ * so takes 1 hop, but contends with every other transfer on the bus.
  */
 class Bus final : public BasicTopology {
   public:
     /**
      * Constructor.
      *
-     * @param npus_count number of npus connected to the switch
-     * @param bandwidth bandwidth of link
-     * @param latency latency of link
+     * @param npus_count number of npus attached to the bus
+     * @param bandwidth bandwidth of the bus
+     * @param latency latency of the bus
+     * @param arbitration arbitration policy among the attached npus
+     * @param is_multi_dim true if the bus is a dimension of a multi-dimensional topology
      */
-    Bus(int npus_count, Bandwidth bandwidth, Latency latency) noexcept;
+    Bus(int npus_count,
+        Bandwidth bandwidth,
+        Latency latency,
+        BusArbitration arbitration = BusArbitration::FIFO,
+        bool is_multi_dim = false) noexcept;
 
     /**
      * Implementation of route function in Topology.
@@ -47,16 +55,24 @@ class Bus final : public BasicTopology {
     /**
      * Get connection policies
      * Each connection policy is represented as a pair of (src, dest) device ids.
+     * Every pair of npus is logically connected, although all pairs share one link.
      * For a 4-node topology, the connection policies are:
-     * - if bidirectional: (0, 4), (1, 4), (2, 4), (3, 4), (4, 0), (4, 1), (4, 2), (4, 3)
+     * (0, 1), (0, 2), (0, 3), (1, 0), (1, 2), (1, 3), (2, 0), (2, 1), (2, 3), (3, 0), (3, 1), (3, 2)
      *
      * @return list of connection policies
      */
     [[nodiscard]] std::vector<ConnectionPolicy> get_connection_policies() const noexcept override;
 
+    /**
+     * Get the arbitration policy among the attached npus.
+     *
+     * @return arbitration policy of the bus
+     */
+    [[nodiscard]] BusArbitration get_arbitration() const noexcept;
+
   private:
-    /// node_id of the switch node
-    DeviceId bus_id;
+    /// arbitration policy among the attached npus
+    BusArbitration arbitration;
 };
 
 }  // namespace NetworkAnalyticalCongestionAware
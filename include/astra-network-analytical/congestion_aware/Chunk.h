@@ -8,6 +8,7 @@ LICENSE file in the root directory of this source tree.
 #include "common/Type.h"
 #include "congestion_aware/Type.h"
 #include <memory>
+#include <vector>
 
 using namespace NetworkAnalytical;
 
@@ -35,8 +36,13 @@ class Chunk {
      * @param route: route of the chunk from its source to destination
      * @param callback: callback to be invoked when the chunk arrives destination
      * @param callback_arg: argument of the callback
+     * @param traffic_class: traffic class of the chunk, larger values are more latency-critical
      */
-    Chunk(ChunkSize chunk_size, Route route, Callback callback, CallbackArg callback_arg) noexcept;
+    Chunk(ChunkSize chunk_size,
+          Route route,
+          Callback callback,
+          CallbackArg callback_arg,
+          TrafficClass traffic_class = 0) noexcept;
 
     /**
      * Get the current sitting device of the chunk
@@ -52,12 +58,26 @@ class Chunk {
      */
     [[nodiscard]] std::shared_ptr<Device> next_device() const noexcept;
 
+    /**
+     * Get the destination device of the chunk
+     *
+     * @return destination device of the chunk
+     */
+    [[nodiscard]] std::shared_ptr<Device> dest_device() const noexcept;
+
     /**
      * Mark the chunk arrived at its next device
      * i.e., drop the current device from the route
      */
     void mark_arrived_next_device() noexcept;
 
+    /**
+     * Replace the rest of the route of the chunk, e.g., to steer it around a dead link.
+     *
+     * @param new_route route from the current device to the destination of the chunk
+     */
+    void set_route(Route new_route) noexcept;
+
     /**
      * Check if the chunk arrived at its destination
      * i.e., if the route length is 1 (only destination device left)
@@ -73,12 +93,78 @@ class Chunk {
      */
     [[nodiscard]] ChunkSize get_size() const noexcept;
 
+    /**
+     * Get the traffic class of the chunk
+     *
+     * @return traffic class of the chunk
+     */
+    [[nodiscard]] TrafficClass get_traffic_class() const noexcept;
+
+    /**
+     * Tag the chunk as a contribution to an in-network reduction.
+     * A reduction-capable switch on the route holds the chunk until
+     * every contribution of the group heading to the same destination arrived,
+     * then forwards a single reduced chunk.
+     *
+     * @param reduction_group reduction group of the chunk
+     * @param contributions_count number of chunks reduced into one at the switch
+     */
+    void set_reduction_group(ReductionGroup reduction_group, int contributions_count) noexcept;
+
+    /**
+     * Get the reduction group of the chunk
+     *
+     * @return reduction group of the chunk, -1 if the chunk is not reduced
+     */
+    [[nodiscard]] ReductionGroup get_reduction_group() const noexcept;
+
+    /**
+     * Get the number of chunks reduced into one with this chunk
+     *
+     * @return number of contributions of the reduction
+     */
+    [[nodiscard]] int get_contributions_count() const noexcept;
+
+    /**
+     * Mark the chunk reduced, i.e., it is no longer held by reduction-capable switches.
+     */
+    void clear_reduction_group() noexcept;
+
+    /**
+     * Reduce another chunk into this chunk.
+     * The other chunk stops travelling, and its callback is invoked once this chunk arrives.
+     *
+     * @param contribution chunk reduced into this chunk
+     */
+    void merge(std::unique_ptr<Chunk> contribution) noexcept;
+
     /**
      * Invoke the registered callback
      * i.e., this method should be called when the chunk arrives its destination.
      */
     void invoke_callback() noexcept;
 
+    /**
+     * Hand the chunk to its destination,
+     * i.e., free its slot in the input buffer and invoke the callback.
+     */
+    void deliver() noexcept;
+
+    /**
+     * Set the link the chunk most recently traversed,
+     * i.e., the link whose downstream input buffer currently holds the chunk.
+     *
+     * @param link link the chunk arrived through, nullptr if the chunk is at its source
+     */
+    void set_ingress_link(Link* link) noexcept;
+
+    /**
+     * Get the link the chunk most recently traversed.
+     *
+     * @return link the chunk arrived through, nullptr if the chunk is at its source
+     */
+    [[nodiscard]] Link* get_ingress_link() const noexcept;
+
   private:
     /// size of the chunk
     ChunkSize chunk_size;
@@ -94,6 +180,21 @@ class Chunk {
 
     /// argument of the callback
     CallbackArg callback_arg;
+
+    /// traffic class of the chunk, selecting the virtual channel it travels on
+    TrafficClass traffic_class;
+
+    /// link the chunk most recently traversed, used to return buffer credits
+    Link* ingress_link;
+
+    /// reduction group of the chunk, -1 if the chunk is not reduced
+    ReductionGroup reduction_group;
+
+    /// number of chunks reduced into one with this chunk
+    int contributions_count;
+
+    /// chunks reduced into this chunk, whose callbacks are invoked when this chunk arrives
+    std::vector<std::unique_ptr<Chunk>> merged_contributions;
 };
 
 }  // namespace NetworkAnalyticalCongestionAware
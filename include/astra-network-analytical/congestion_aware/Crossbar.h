@@ -0,0 +1,176 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/EventQueue.h"
+#include "common/Type.h"
+#include "congestion_aware/Type.h"
+#include <list>
+#include <map>
+#include <memory>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * Crossbar models the internal switching fabric of a switch device.
+ * Without a Crossbar, a switch forwards an arriving chunk to its egress link instantly,
+ * i.e., the fabric has unlimited internal bandwidth.
+ *
+ * With a Crossbar, a chunk has to cross the fabric before reaching its egress link.
+ * Each fabric port runs at (speedup * bandwidth of the egress link), and:
+ *   - OutputQueued: chunks only contend for the output port they head to.
+ *   - InputQueued: chunks also contend for the input port they arrived through,
+ *     and every time a port frees up, inputs are matched to outputs by
+ *       - RoundRobin: each input only offers its oldest chunk (suffering head-of-line blocking),
+ *         and each output grants the requesting inputs in round-robin order.
+ *       - iSLIP: each input keeps a virtual output queue per each output,
+ *         and inputs and outputs are matched by iterative request-grant-accept rounds.
+ * Input ports are identified by the link the chunk arrived through,
+ * and output ports by the output port of the switch device.
+ */
+class Crossbar {
+  public:
+    /**
+     * Callback to be called when a chunk finishes crossing the fabric.
+     * The chunk is handed over to its egress link, and the freed ports are matched again.
+     *
+     * @param transfer_ptr pointer to the finished transfer
+     */
+    static void transfer_finished(void* transfer_ptr) noexcept;
+
+    /**
+     * Set the event queue to be used by the crossbar.
+     *
+     * @param event_queue_ptr pointer to the event queue
+     */
+    static void set_event_queue(std::shared_ptr<EventQueue> event_queue_ptr) noexcept;
+
+    /**
+     * Constructor.
+     *
+     * @param link_table table owning the egress links of the switch
+     * @param output_links egress link per each output port of the switch
+     * @param queueing queueing discipline of the crossbar
+     * @param arbitration arbitration policy, used by InputQueued only
+     * @param speedup bandwidth of each fabric port relative to its egress link
+     */
+    Crossbar(LinkTable* link_table,
+             std::vector<LinkId> output_links,
+             SwitchQueueing queueing,
+             SwitchArbitration arbitration,
+             double speedup) noexcept;
+
+    /**
+     * Send a chunk across the fabric.
+     *
+     * @param chunk chunk that arrived at the switch
+     * @param output output port the chunk leaves the switch through
+     */
+    void send(std::unique_ptr<Chunk> chunk, int output) noexcept;
+
+  private:
+    /// event queue Crossbar uses to schedule events
+    static std::shared_ptr<EventQueue> event_queue;
+
+    /**
+     * Transfer is a chunk crossing the fabric from an input port to an output port.
+     */
+    struct Transfer {
+        /// crossbar the transfer happens in
+        Crossbar* crossbar;
+
+        /// input port of the transfer, -1 if OutputQueued
+        int input;
+
+        /// output port of the transfer
+        int output;
+
+        /// the crossing chunk
+        std::unique_ptr<Chunk> chunk;
+    };
+
+    /// table owning the egress links of the switch
+    LinkTable* link_table;
+
+    /// egress link per each output port
+    std::vector<LinkId> output_links;
+
+    /// queueing discipline
+    SwitchQueueing queueing;
+
+    /// arbitration policy among input ports
+    SwitchArbitration arbitration;
+
+    /// bandwidth of each fabric port relative to its egress link
+    double speedup;
+
+    /// input port per each ingress link, assigned as chunks first arrive through the link
+    std::map<LinkId, int> input_of_link;
+
+    /**
+     * QueuedChunk is a chunk waiting to cross the fabric, along with the output port it heads to.
+     */
+    struct QueuedChunk {
+        /// the waiting chunk
+        std::unique_ptr<Chunk> chunk;
+
+        /// output port the chunk heads to
+        int output;
+    };
+
+    /// queued chunks per each input port, and per each output port within it
+    /// RoundRobin keeps a single FIFO queue (at index 0) per each input port
+    /// OutputQueued keeps a single input port (at index 0) with a queue per each output port
+    std::vector<std::vector<std::list<QueuedChunk>>> queues;
+
+    /// busy flag per each input port
+    std::vector<bool> input_busy;
+
+    /// busy flag per each output port
+    std::vector<bool> output_busy;
+
+    /// input to be granted first per each output port, in round-robin order
+    std::vector<int> grant_pointer;
+
+    /// output to be accepted first per each input port, in round-robin order (iSLIP only)
+    std::vector<int> accept_pointer;
+
+    /**
+     * Get the input port of a chunk, adding a new port if the chunk arrived through a new link.
+     *
+     * @param chunk chunk that arrived at the switch
+     * @return input port of the chunk
+     */
+    [[nodiscard]] int input_of(const Chunk& chunk) noexcept;
+
+    /**
+     * Match free input ports to free output ports and start the matched transfers.
+     */
+    void arbitrate() noexcept;
+
+    /**
+     * Match free input ports to free output ports in round-robin order.
+     */
+    void arbitrate_round_robin() noexcept;
+
+    /**
+     * Match free input ports to free output ports by iSLIP.
+     */
+    void arbitrate_islip() noexcept;
+
+    /**
+     * Start moving the first chunk of a queue across the fabric.
+     *
+     * @param input input port to move the chunk from, -1 if OutputQueued
+     * @param queue queue holding the chunk
+     */
+    void start_transfer(int input, std::list<QueuedChunk>& queue) noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
@@ -7,8 +7,8 @@ LICENSE file in the root directory of this source tree.
 
 #include "common/Type.h"
 #include "congestion_aware/Type.h"
-#include <map>
 #include <memory>
+#include <vector>
 
 using namespace NetworkAnalytical;
 
@@ -24,8 +24,9 @@ class Device {
      * Constructor.
      *
      * @param id id of the device
+     * @param link_table table owning the links of the topology the device belongs to
      */
-    explicit Device(DeviceId id) noexcept;
+    Device(DeviceId id, std::shared_ptr<LinkTable> link_table) noexcept;
 
     /**
      * Get id of the device.
@@ -42,6 +43,13 @@ class Device {
      */
     void send(std::unique_ptr<Chunk> chunk) noexcept;
 
+    /**
+     * Receive a chunk that arrived at its destination, i.e., this device.
+     *
+     * @param chunk arrived chunk
+     */
+    void receive(std::unique_ptr<Chunk> chunk) noexcept;
+
     /**
      * Connect a device to another device.
      *
@@ -51,13 +59,88 @@ class Device {
      */
     void connect(DeviceId id, Bandwidth bandwidth, Latency latency) noexcept;
 
-  private:
-    /// device Id
-    DeviceId device_id;
+    /**
+     * Reach another device through an existing link,
+     * which may be shared with other devices (e.g., a bus).
+     *
+     * @param id id of the device to reach
+     * @param link_id id of the link to send chunks to the device through
+     */
+    void attach(DeviceId id, LinkId link_id) noexcept;
+
+    /**
+     * Get the number of output ports of this device, i.e., the number of devices it's connected to.
+     *
+     * @return number of output ports
+     */
+    [[nodiscard]] int get_ports_count() const noexcept;
+
+    /**
+     * Pre-size the output ports of this device, so connecting it doesn't reallocate them.
+     *
+     * @param ports_count number of output ports the device will have
+     */
+    void reserve_ports(int ports_count) noexcept;
+
+    /**
+     * Get the ids of the connected devices, one per each output port, in increasing order.
+     *
+     * @return ids of the connected devices
+     */
+    [[nodiscard]] const std::vector<DeviceId>& get_port_dests() const noexcept;
+
+    /**
+     * Get the link of each output port, parallel to get_port_dests().
+     *
+     * @return ids of the links of the output ports
+     */
+    [[nodiscard]] const std::vector<LinkId>& get_port_links() const noexcept;
 
-    /// links to other nodes
-    /// map[dest node node_id] -> link
-    std::map<DeviceId, std::shared_ptr<Link>> links;
+    /**
+     * Make chunks cross a contended switching fabric before leaving this device.
+     * Must be invoked after every output port of the device is connected.
+     *
+     * @param queueing queueing discipline of the fabric
+     * @param arbitration arbitration policy of an input-queued fabric
+     * @param speedup bandwidth of each fabric port relative to its egress link
+     */
+    void set_crossbar(SwitchQueueing queueing, SwitchArbitration arbitration, double speedup) noexcept;
+
+    /**
+     * Make chunks go through a network interface when leaving or arriving at this device.
+     *
+     * @param injection_bandwidth aggregate injection bandwidth in GB/s, 0 if unlimited
+     * @param ejection_bandwidth aggregate ejection bandwidth in GB/s, 0 if unlimited
+     * @param dma_engines number of DMA engines injecting chunks in parallel
+     * @param scheduling order in which waiting chunks take a free DMA engine
+     */
+    void set_network_interface(Bandwidth injection_bandwidth,
+                               Bandwidth ejection_bandwidth,
+                               int dma_engines,
+                               NicScheduling scheduling) noexcept;
+
+    /**
+     * Make this device reduce the chunks tagged with a reduction group in the network.
+     *
+     * @param throughput reduction throughput in GB/s, 0 if reductions take no time
+     */
+    void set_reduction_engine(Bandwidth throughput) noexcept;
+
+    /**
+     * Get the link from this device to another device.
+     *
+     * @param dest id of the connected device
+     * @return link to the given device
+     */
+    [[nodiscard]] Link& get_link(DeviceId dest) const noexcept;
+
+    /**
+     * Get the id of the link from this device to another device.
+     *
+     * @param dest id of the connected device
+     * @return id of the link to the given device
+     */
+    [[nodiscard]] LinkId get_link_id(DeviceId dest) const noexcept;
 
     /**
      * Check if this device is connected to another device.
@@ -66,6 +149,45 @@ class Device {
      * @return true if connected to the given device, false otherwise
      */
     [[nodiscard]] bool connected(DeviceId dest) const noexcept;
+
+  private:
+    /// device Id
+    DeviceId device_id;
+
+    /// ids of the connected devices, one per each output port of the device
+    /// kept sorted in a contiguous array, so the port to a device is found by binary search
+    std::vector<DeviceId> port_dests;
+
+    /// link of each output port, parallel to port_dests
+    std::vector<LinkId> port_links;
+
+    /// table owning the links of the topology
+    std::shared_ptr<LinkTable> link_table;
+
+    /// switching fabric chunks cross before leaving this device, nullptr if ideal
+    std::shared_ptr<Crossbar> crossbar;
+
+    /// network interface chunks go through when leaving or arriving at this device, nullptr if ideal
+    std::shared_ptr<NetworkInterface> network_interface;
+
+    /// in-network reduction unit of this device, nullptr if the device doesn't reduce chunks
+    std::shared_ptr<ReductionEngine> reduction_engine;
+
+    /**
+     * Find the output port leading to another device.
+     *
+     * @param dest id of the device to reach
+     * @return index of the port, -1 if the device is not connected
+     */
+    [[nodiscard]] int find_port(DeviceId dest) const noexcept;
+
+    /**
+     * Add an output port leading to another device, keeping the ports sorted.
+     *
+     * @param dest id of the device the port leads to
+     * @param link_id id of the link of the port
+     */
+    void add_port(DeviceId dest, LinkId link_id) noexcept;
 };
 
 }  // namespace NetworkAnalyticalCongestionAware
@@ -55,6 +55,12 @@ public:
    */
   [[nodiscard]] Route route(DeviceId src, DeviceId dest) const noexcept override;
 
+  /**
+   * Implementation of routes function in Topology.
+   * The paths through both trees, the one route() picks first, even if the other one is longer.
+   */
+  [[nodiscard]] std::vector<Route> routes(DeviceId src, DeviceId dest) const noexcept override;
+
   /**
    * Get connection policies
    *
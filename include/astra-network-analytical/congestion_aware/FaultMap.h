@@ -0,0 +1,65 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include <cstdint>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * FaultMap holds the health of the faulty links of a topology,
+ * hashed on the (src, dest) pair so a link is looked up in constant time.
+ * A fault applies to both src -> dest and dest -> src directions.
+ * It is built once from the network config and shared by the topologies.
+ */
+class FaultMap {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param faulty_links list of faulty links as tuples (src, dst, health)
+     */
+    explicit FaultMap(const std::vector<std::tuple<int, int, double>>& faulty_links = {}) noexcept;
+
+    /**
+     * Get the health of the link between two devices,
+     * i.e., the fraction of its bandwidth left.
+     * If a link is listed more than once, its first entry is used.
+     *
+     * @param src src device id
+     * @param dest dest device id
+     * @return health of the link, 0 if dead and 1 if not faulty
+     */
+    [[nodiscard]] double derate(DeviceId src, DeviceId dest) const noexcept;
+
+    /**
+     * Get the number of faulty links.
+     *
+     * @return number of faulty links
+     */
+    [[nodiscard]] int size() const noexcept;
+
+    /**
+     * Get the key of the link between two devices, which is the same for both directions.
+     *
+     * @param src src device id
+     * @param dest dest device id
+     * @return key of the link
+     */
+    [[nodiscard]] static uint64_t key(DeviceId src, DeviceId dest) noexcept;
+
+  private:
+    /// health of each faulty link, keyed on its direction-less (src, dest) pair
+    std::unordered_map<uint64_t, double> health;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
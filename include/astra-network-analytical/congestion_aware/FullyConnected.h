@@ -34,14 +34,14 @@ class FullyConnected final : public BasicTopology {
      * @param latency latency of link
      * @param bidirectional true if is bidirectional
      * @param is_multi_dim  true if part of multidimensional topology
-     * @param faulty_links  list of faulty links as tuples (src, dst, weight)
+     * @param fault_map health of the faulty links, nullptr if no link is faulty
      */
     FullyConnected(int npus_count,
          Bandwidth bandwidth,
          Latency latency,
          bool bidirectional = true,
          bool is_multi_dim = false,
-         const std::vector<std::tuple<int, int, double>>& faulty_links = {}) noexcept;
+         std::shared_ptr<const FaultMap> fault_map = nullptr) noexcept;
 
     /**
      * Alternate constructor for convenience
@@ -49,8 +49,8 @@ class FullyConnected final : public BasicTopology {
     FullyConnected(int npus_count,
          Bandwidth bandwidth,
          Latency latency,
-         const std::vector<std::tuple<int, int, double>>& faulty_links) noexcept
-        : FullyConnected(npus_count, bandwidth, latency, true, false, faulty_links) {}
+         std::shared_ptr<const FaultMap> fault_map) noexcept
+        : FullyConnected(npus_count, bandwidth, latency, true, false, std::move(fault_map)) {}
     /**
      * Implementation of route function in Topology.
      */
@@ -66,10 +66,7 @@ class FullyConnected final : public BasicTopology {
      */
     [[nodiscard]] std::vector<ConnectionPolicy> get_connection_policies() const noexcept override;
 
-    double fault_derate(int src, int dst) const;
-
     bool bidirectional;
-    std::vector<std::tuple<int, int, double>> faulty_links;
 };
 
 }  // namespace NetworkAnalyticalCongestionAware
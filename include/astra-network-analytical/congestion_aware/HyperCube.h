@@ -37,7 +37,7 @@ class HyperCube final : public BasicTopology {
      * @param bidirectional true if HyperCube is bidirectional
      * @param is_multi_dim  true if part of multidimensional topology
      * @param non_recursive_topo
-     * @param faulty_links  list of faulty links as tuples (src, dst, weight)
+     * @param fault_map health of the faulty links, nullptr if no link is faulty
      */
     HyperCube(int npus_count,
          Bandwidth bandwidth,
@@ -45,7 +45,7 @@ class HyperCube final : public BasicTopology {
          bool bidirectional = true,
          bool is_multi_dim = false,
          int non_recursive_topo = 1,
-         const std::vector<std::tuple<int, int, double>>& faulty_links = {}) noexcept;
+         std::shared_ptr<const FaultMap> fault_map = nullptr) noexcept;
 
     /**
      * Alternate constructor for convenience
@@ -53,24 +53,39 @@ class HyperCube final : public BasicTopology {
     HyperCube(int npus_count,
          Bandwidth bandwidth,
          Latency latency,
-         const std::vector<std::tuple<int, int, double>>& faulty_links) noexcept
-        : HyperCube(npus_count, bandwidth, latency, true, false, 1, faulty_links) {}
+         std::shared_ptr<const FaultMap> fault_map) noexcept
+        : HyperCube(npus_count, bandwidth, latency, true, false, 1, std::move(fault_map)) {}
 
     /**
      * Implementation of route function in Topology.
      */
     [[nodiscard]] Route route(DeviceId src, DeviceId dest) const noexcept override;
 
+    /**
+     * Implementation of routes function in Topology.
+     * One route per differing bit, flipping the differing bits in ascending order starting from that bit,
+     * which makes the routes link-disjoint.
+     */
+    [[nodiscard]] std::vector<Route> routes(DeviceId src, DeviceId dest) const noexcept override;
+
     /**
      * Get connection policies of the HyperCube topology.
      */
     [[nodiscard]] std::vector<ConnectionPolicy> get_connection_policies() const noexcept override;
 
  private:
-    double fault_derate(int src, int dst) const;
+    /**
+     * Construct the route from src to dest flipping the differing bits in ascending order,
+     * starting from a given bit and wrapping around to the lower ones.
+     *
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @param first_bit differing bit flipped first
+     * @return route from src NPU to dest NPU, empty if it leaves the NPUs of an incomplete HyperCube
+     */
+    [[nodiscard]] Route route_from_bit(DeviceId src, DeviceId dest, int first_bit) const noexcept;
 
     bool bidirectional;
-    std::vector<std::tuple<int, int, double>> faulty_links;
     int non_recursive_topo;
 };
 
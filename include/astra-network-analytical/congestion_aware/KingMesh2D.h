@@ -41,14 +41,14 @@ class KingMesh2D final : public BasicTopology {
    * @param latency    link latency
    * @param bidirectional true if torus is bidirectional
    * @param is_multi_dim  true if part of multidimensional topology
-   * @param faulty_links  list of faulty links as tuples (src, dst, weight)
+   * @param fault_map health of the faulty links, nullptr if no link is faulty
    */
   KingMesh2D(int npus_count,
           Bandwidth bandwidth,
           Latency latency,
           bool bidirectional = true,
           bool is_multi_dim = false,
-          const std::vector<std::tuple<int, int, double>>& faulty_links = {}) noexcept;
+          std::shared_ptr<const FaultMap> fault_map = nullptr) noexcept;
 
   /**
    * Alternate constructor for convenience (used by Helper.cpp)
@@ -56,8 +56,8 @@ class KingMesh2D final : public BasicTopology {
   KingMesh2D(int npus_count,
           Bandwidth bandwidth,
           Latency latency,
-          const std::vector<std::tuple<int, int, double>>& faulty_links) noexcept
-      : KingMesh2D(npus_count, bandwidth, latency, true, false, faulty_links) {}
+          std::shared_ptr<const FaultMap> fault_map) noexcept
+      : KingMesh2D(npus_count, bandwidth, latency, true, false, std::move(fault_map)) {}
 
     /**
      * Implementation of route function in Topology.
@@ -76,10 +76,7 @@ class KingMesh2D final : public BasicTopology {
 
   private:
     /// true if the ring is bidirectional, false otherwise
-    double fault_derate(int src, int dst) const;
-
     bool bidirectional;
-    std::vector<std::tuple<int, int, double>> faulty_links;
 };
 
 }  // namespace NetworkAnalyticalCongestionAware
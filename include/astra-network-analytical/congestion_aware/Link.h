@@ -7,8 +7,13 @@ LICENSE file in the root directory of this source tree.
 
 #include "common/EventQueue.h"
 #include "common/Type.h"
+#include "congestion_aware/LinkStats.h"
 #include "congestion_aware/Type.h"
+#include <list>
+#include <map>
 #include <memory>
+#include <utility>
+#include <vector>
 
 using namespace NetworkAnalytical;
 
@@ -37,16 +42,155 @@ class Link {
 
     /**
      * Constructor.
+     * Links are created by LinkTable::add_link,
+     * which holds the bandwidth, latency, and traffic counters of the link.
      *
-     * @param bandwidth bandwidth of the link
-     * @param latency latency of the link
+     * @param link_table table owning the link
+     * @param link_id id of the link in the table
      */
-    Link(Bandwidth bandwidth, Latency latency) noexcept;
+    Link(LinkTable* link_table, LinkId link_id) noexcept;
+
+    /**
+     * Get id of the link.
+     *
+     * @return id of the link
+     */
+    [[nodiscard]] LinkId get_id() const noexcept;
+
+    /**
+     * Add a step to the piecewise-constant bandwidth schedule of the link.
+     * From the given time on, the link runs at (scale * constructed bandwidth)
+     * until the next step. Transmissions overlapping a step boundary
+     * are serialized at the old bandwidth before it and at the new one after it.
+     *
+     * @param time time the step takes effect, in ns
+     * @param scale bandwidth scale relative to the bandwidth the link was constructed with
+     */
+    void add_bandwidth_step(EventTime time, double scale) noexcept;
+
+    /**
+     * Announce a health change of the link ahead of its time, see set_health().
+     * Transmissions overlapping it are then serialized at the old health before it
+     * and at the new one after it, like across the steps of the bandwidth schedule.
+     * The transmission under way when the link dies keeps the health it had.
+     *
+     * @param time time the change takes effect, in ns
+     * @param health fraction of the constructed bandwidth left from then on
+     */
+    void add_health_step(EventTime time, double health) noexcept;
+
+    /**
+     * Set the health of the link, i.e., the fraction of its bandwidth left,
+     * scaling the bandwidth the link was constructed with, along with its bandwidth schedule.
+     * The chunk under transmission keeps the timing it started with,
+     * which accounts for the changes announced by add_health_step().
+     * A dead link starts no transmission: chunks sent to it are rerouted if the table can,
+     * and otherwise wait for the link to be restored.
+     *
+     * @param health fraction of the constructed bandwidth left, 0 if the link is dead
+     */
+    void set_health(double health) noexcept;
+
+    /**
+     * Get the health of the link.
+     *
+     * @return fraction of the constructed bandwidth left, 0 if the link is dead
+     */
+    [[nodiscard]] double get_health() const noexcept;
+
+    /**
+     * Check if the link is dead.
+     *
+     * @return true if the link is dead, false otherwise
+     */
+    [[nodiscard]] bool is_dead() const noexcept;
+
+    /**
+     * Take every pending chunk out of the link, e.g., to reroute them once the link died.
+     * Chunks are returned by virtual channel, then input port, then enqueue order.
+     *
+     * @return the pending chunks
+     */
+    [[nodiscard]] std::vector<std::unique_ptr<Chunk>> take_pending_chunks() noexcept;
+
+    /**
+     * Set the size of the input buffer at the downstream device of the link,
+     * which enables credit-based flow control on the link.
+     * A chunk can only start transmission when the downstream buffer has room for it,
+     * and the room is returned once the chunk leaves the downstream device.
+     * To avoid a permanent stall, a chunk larger than the buffer can be sent into an empty buffer.
+     * Links whose buffers depend on each other cyclically, e.g., around a Ring, can still deadlock,
+     * which LinkTable::check_deadlock() reports once the event queue is drained.
+     *
+     * @param buffer_size size of the downstream input buffer in bytes, 0 for an unbounded buffer
+     */
+    void set_input_buffer_size(ChunkSize buffer_size) noexcept;
+
+    /**
+     * Split the link into multiple virtual channels.
+     * Each virtual channel has its own pending queue and its own downstream input buffer,
+     * so a chunk blocked on one channel never blocks the chunks of another.
+     * A chunk of traffic class c travels on virtual channel min(c, vcs_count - 1).
+     * Whenever the link becomes free, the next chunk is picked among the channels
+     * whose first pending chunk can be sent, following the arbitration policy:
+     *   - StrictPriority: the channel with the largest index always wins.
+     *   - WeightedRoundRobin: channels take turns, each sending up to its weight in chunks per turn.
+     *
+     * @param vcs_count number of virtual channels
+     * @param arbitration arbitration policy among the virtual channels
+     * @param weights number of chunks each channel sends per turn, used by WeightedRoundRobin only
+     */
+    void set_virtual_channels(int vcs_count,
+                              VirtualChannelArbitration arbitration,
+                              std::vector<int> weights) noexcept;
+
+    /**
+     * Give the link one input port per each attached device, for a link shared by multiple devices.
+     * Each port has its own pending queue per each virtual channel,
+     * and within a virtual channel the ports are served in round-robin order,
+     * so no device can monopolize the shared medium.
+     * Without input ports, the pending chunks of all devices are served in FIFO order.
+     *
+     * @param device_ids ids of the devices sending chunks through the link
+     */
+    void set_round_robin_ports(const std::vector<DeviceId>& device_ids) noexcept;
+
+    /**
+     * Make chunks sent through the link randomly corrupted, paying for their retransmission.
+     * A chunk of n bytes is corrupted with probability 1 - (1 - packet_error_rate) * (1 - bit_error_rate)^(8n),
+     * and each corruption is detected after a round trip (2 * latency),
+     * then the chunk is sent again until it goes through intact:
+     *   - SelectiveRepeat: only the corrupted chunk is serialized again.
+     *   - GoBackN: the chunks sent during the round trip are also discarded,
+     *     so the link additionally wastes up to (window - 1) serializations.
+     * Each link draws from its own random stream derived from (seed, link id),
+     * so runs with the same seed are reproducible.
+     *
+     * @param bit_error_rate probability of a corrupted bit
+     * @param packet_error_rate probability of a corrupted chunk regardless of its size
+     * @param retransmission retransmission protocol
+     * @param window number of chunks the sender can have in flight, used by GoBackN only
+     * @param seed seed of the random streams
+     */
+    void set_error_model(double bit_error_rate,
+                         double packet_error_rate,
+                         Retransmission retransmission,
+                         int window,
+                         uint64_t seed) noexcept;
+
+    /**
+     * Return credits to the link, i.e., a chunk left the downstream input buffer.
+     * If the link is free and a pending chunk now fits, it starts transmission.
+     *
+     * @param chunk_size size of the chunk that left the downstream input buffer
+     * @param traffic_class traffic class of the chunk, selecting its virtual channel
+     */
+    void return_credits(ChunkSize chunk_size, TrafficClass traffic_class) noexcept;
 
     /**
      * Try to send a chunk through the link.
-     * - If the link is free, service the chunk immediately.
-     * - If the link is busy, add the chunk to the pending chunks list.
+     * - If the link is free and the downstream buffer has room, service the chunk immediately.
+     * - Otherwise, add the chunk to the pending chunks list.
      *
      * @param chunk the chunk to be served by the link
      */
@@ -54,7 +198,7 @@ class Link {
 
     /**
      * Dequeue and try to send the first pending chunk
-     * in the pending chunks list.
+     * of the virtual channel picked by the arbitration policy.
      */
     void process_pending_transmission() noexcept;
 
@@ -65,6 +209,13 @@ class Link {
      */
     [[nodiscard]] bool pending_chunk_exists() const noexcept;
 
+    /**
+     * Get the number of chunks waiting for the link.
+     *
+     * @return number of pending chunks over all virtual channels
+     */
+    [[nodiscard]] uint64_t get_pending_chunks_count() const noexcept;
+
     /**
      * Set the link as busy.
      */
@@ -79,38 +230,232 @@ class Link {
     /// event queue Link uses to schedule events
     static std::shared_ptr<EventQueue> event_queue;
 
-    /// bandwidth of the link in GB/s
-    Bandwidth bandwidth;
+    /// piecewise-constant bandwidth schedule, sorted by time
+    /// each step is (time the step takes effect in ns, bandwidth in B/ns)
+    /// empty if the bandwidth of the link never changes
+    std::vector<std::pair<EventTime, Bandwidth>> bandwidth_schedule;
+
+    /// fraction of the constructed bandwidth left, 0 if the link is dead
+    double health;
+
+    /// health changes announced ahead, sorted by time
+    /// each change is (time it takes effect in ns, health), dropped once in the past
+    std::vector<std::pair<EventTime, double>> health_schedule;
+
+    /**
+     * PendingChunk is a chunk waiting for the link, along with its enqueue time.
+     */
+    struct PendingChunk {
+        /// the waiting chunk
+        std::unique_ptr<Chunk> chunk;
+
+        /// time the chunk was enqueued
+        EventTime enqueue_time;
+    };
+
+    /// queue of pending chunks per each (virtual channel, input port),
+    /// indexed by (vc * ports_count + port)
+    std::vector<std::list<PendingChunk>> pending_chunks;
+
+    /// number of virtual channels
+    int vcs_count;
+
+    /// number of input ports, 1 unless the link is a shared medium with round-robin arbitration
+    int ports_count;
+
+    /// input port per each attached device, empty if the link has a single port
+    std::map<DeviceId, int> port_of_device;
+
+    /// input port to be checked first in the round-robin order, per each virtual channel
+    /// empty if the link has a single port
+    std::vector<int> next_port;
+
+    /// total number of pending chunks over all virtual channels
+    uint64_t pending_chunks_count;
+
+    /// arbitration policy among the virtual channels
+    VirtualChannelArbitration vc_arbitration;
+
+    /// number of chunks each virtual channel sends per turn under WeightedRoundRobin
+    /// empty unless the link has multiple virtual channels
+    std::vector<int> vc_weights;
 
-    /// bandwidth of the link in B/ns, used in actual computation
-    Bandwidth bandwidth_Bpns;
+    /// virtual channel holding the current WeightedRoundRobin turn
+    int wrr_current_vc;
 
-    /// latency of the link in ns
-    Latency latency;
+    /// chunks the current virtual channel can still send in its WeightedRoundRobin turn
+    int wrr_remaining_quota;
 
-    /// queue of pending chunks
-    std::list<std::unique_ptr<Chunk>> pending_chunks;
+    /// table owning the link, holding its bandwidth, latency, busy flag, and traffic counters
+    LinkTable* link_table;
 
-    /// flag to indicate if the link is busy
-    bool busy;
+    /// id of the link in the table
+    LinkId link_id;
+
+    /// size of the input buffer at the downstream device in bytes
+    /// 0 if the buffer is unbounded, i.e., credit-based flow control is disabled
+    ChunkSize input_buffer_size;
+
+    /// bytes currently held in the input buffer at the downstream device, per each virtual channel
+    /// empty if the buffer is unbounded
+    std::vector<ChunkSize> buffered_bytes;
+
+    /// link the chunk under serialization arrived through
+    /// its credits are returned once the chunk is fully serialized onto this link
+    Link* serializing_chunk_ingress_link;
+
+    /// size of the chunk under serialization
+    ChunkSize serializing_chunk_size;
+
+    /// traffic class of the chunk under serialization
+    TrafficClass serializing_chunk_traffic_class;
+
+    /**
+     * ErrorModel holds the parameters and the random stream of a link corrupting chunks.
+     */
+    struct ErrorModel {
+        /// probability of a corrupted bit
+        double bit_error_rate;
+
+        /// probability of a corrupted chunk regardless of its size
+        double packet_error_rate;
+
+        /// retransmission protocol
+        Retransmission retransmission;
+
+        /// number of chunks the sender can have in flight
+        int window;
+
+        /// state of the random stream
+        uint64_t rng_state;
+    };
+
+    /// error model of the link, nullptr if the link never corrupts chunks
+    std::unique_ptr<ErrorModel> error_model;
+
+    /**
+     * Draw how many times a chunk gets corrupted before going through intact.
+     *
+     * @param chunk_size size of the chunk
+     * @return number of corrupted transmissions
+     */
+    [[nodiscard]] uint64_t draw_corrupted_transmissions(ChunkSize chunk_size) noexcept;
+
+    /**
+     * Get the virtual channel a traffic class travels on.
+     *
+     * @param traffic_class traffic class of a chunk
+     * @return virtual channel of the traffic class
+     */
+    [[nodiscard]] int virtual_channel_of(TrafficClass traffic_class) const noexcept;
+
+    /**
+     * Get the input port a chunk enters the link through.
+     *
+     * @param chunk chunk about to be sent through the link
+     * @return input port of the chunk
+     */
+    [[nodiscard]] int port_of(const Chunk& chunk) const noexcept;
+
+    /**
+     * Get the pending queue of a (virtual channel, input port) pair.
+     *
+     * @param vc virtual channel
+     * @param port input port
+     * @return index of the pending queue
+     */
+    [[nodiscard]] int queue_of(int vc, int port) const noexcept;
+
+    /**
+     * Pick the input port to serve next within a virtual channel, in round-robin order.
+     *
+     * @param vc virtual channel to serve
+     * @return input port to serve next, -1 if no pending chunk of the channel can be sent
+     */
+    [[nodiscard]] int select_port(int vc) const noexcept;
+
+    /**
+     * Reset the pending queues to hold (vcs_count * ports_count) empty queues.
+     */
+    void reset_pending_queues() noexcept;
+
+    /**
+     * Check if the link is busy.
+     *
+     * @return true if the link is busy, false otherwise
+     */
+    [[nodiscard]] bool is_busy() const noexcept;
+
+    /**
+     * Get the traffic counters of the link.
+     *
+     * @return traffic counters of the link
+     */
+    [[nodiscard]] LinkStats& stats() noexcept;
+
+    /**
+     * Check if the downstream input buffer of a virtual channel has room for a chunk.
+     *
+     * @param chunk_size size of the chunk
+     * @param vc virtual channel of the chunk
+     * @return true if the chunk can be sent, false otherwise
+     */
+    [[nodiscard]] bool has_credits(ChunkSize chunk_size, int vc) const noexcept;
+
+    /**
+     * Check if a pending chunk of a virtual channel could start transmission,
+     * i.e., the downstream input buffer of the channel has room for it.
+     *
+     * @param vc virtual channel to check
+     * @return true if the channel has a sendable pending chunk, false otherwise
+     */
+    [[nodiscard]] bool vc_sendable(int vc) const noexcept;
+
+    /**
+     * Pick the virtual channel to serve next, following the arbitration policy.
+     *
+     * @return virtual channel to serve next, -1 if no pending chunk can be sent
+     */
+    [[nodiscard]] int select_virtual_channel() const noexcept;
+
+    /**
+     * Check if a pending chunk can start transmission,
+     * i.e., the link is free and the downstream input buffer has room for it.
+     *
+     * @return true if a pending chunk can be sent, false otherwise
+     */
+    [[nodiscard]] bool pending_chunk_sendable() const noexcept;
+
+    /**
+     * Compute the exact serialization time of a chunk on the link.
+     * i.e., serialization time = (chunk size) / (link bandwidth),
+     * integrated over the bandwidth schedule and the announced health changes if the link has any.
+     *
+     * @param chunk_size size of the target chunk
+     * @param start_time time the serialization starts
+     * @return serialization time of the chunk in ns
+     */
+    [[nodiscard]] double exact_serialization_time(ChunkSize chunk_size, EventTime start_time) const noexcept;
 
     /**
      * Compute the serialization delay of a chunk on the link.
      * i.e., serialization delay = (chunk size) / (link bandwidth)
      *
      * @param chunk_size size of the target chunk
+     * @param start_time time the serialization starts
      * @return serialization delay of the chunk
      */
-    [[nodiscard]] EventTime serialization_delay(ChunkSize chunk_size) const noexcept;
+    [[nodiscard]] EventTime serialization_delay(ChunkSize chunk_size, EventTime start_time) const noexcept;
 
     /**
      * Compute the communication delay of a chunk.
      * i.e., communication delay = (link latency) + (serialization delay)
      *
      * @param chunk_size size of the target chunk
+     * @param start_time time the serialization starts
      * @return communication delay of the chunk
      */
-    [[nodiscard]] EventTime communication_delay(ChunkSize chunk_size) const noexcept;
+    [[nodiscard]] EventTime communication_delay(ChunkSize chunk_size, EventTime start_time) const noexcept;
 
     /**
      * Schedule the transmission of a chunk.
@@ -0,0 +1,162 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/Type.h"
+#include <ostream>
+#include <utility>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * LinkStats holds the traffic counters of a single link.
+ */
+struct LinkStats {
+    /// total bytes serialized onto the link
+    ChunkSize bytes_sent = 0;
+
+    /// total number of chunks serialized onto the link
+    uint64_t chunks_sent = 0;
+
+    /// total number of corrupted chunks sent again
+    uint64_t retransmissions = 0;
+
+    /// cumulative time the link spent serializing chunks, in ns
+    EventTime busy_time = 0;
+
+    /// cumulative time chunks waited in the pending queue of the link, in ns
+    EventTime queueing_time = 0;
+
+    /// largest number of pending chunks observed at once
+    uint64_t max_pending_chunks = 0;
+
+    /// last time the link became idle (i.e., free with no pending chunks), in ns
+    EventTime last_idle_time = 0;
+};
+
+/**
+ * LinkStatsTable is a side table holding the LinkStats of every link of a topology.
+ * Counters are packed contiguously and indexed by the slot of each link,
+ * while the (src, dest) endpoints are only kept for reporting.
+ * The slot of a link is its LinkId, unless the link was registered sparsely,
+ * i.e., only once used in an implicit topology.
+ */
+class LinkStatsTable {
+  public:
+    /**
+     * Constructor.
+     */
+    LinkStatsTable() noexcept;
+
+    /**
+     * Register multiple new links at once, with their endpoints to be set by set_endpoints().
+     *
+     * @param links_count number of links to register
+     * @return id of the first registered link, the others following consecutively
+     */
+    [[nodiscard]] LinkId register_links(int links_count) noexcept;
+
+    /**
+     * Set the endpoints of a link registered by register_links().
+     * Endpoints of different links can be set concurrently.
+     *
+     * @param link_id id of the link
+     * @param src src device id of the link
+     * @param dest dest device id of the link
+     */
+    void set_endpoints(LinkId link_id, DeviceId src, DeviceId dest) noexcept;
+
+    /**
+     * Get the endpoints of a link.
+     *
+     * @param slot slot of the link
+     * @return (src, dest) device ids of the link, -1 for a shared-medium link
+     */
+    [[nodiscard]] std::pair<DeviceId, DeviceId> get_endpoints(uint32_t slot) const noexcept;
+
+    /**
+     * Register a single new link in the next free slot, keeping its id aside.
+     * A table registering links sparsely can't register them with register_links().
+     *
+     * @param link_id id of the link
+     * @param src src device id of the link, -1 for a shared-medium link
+     * @param dest dest device id of the link, -1 for a shared-medium link
+     * @return slot of the registered link
+     */
+    [[nodiscard]] uint32_t register_sparse_link(LinkId link_id, DeviceId src, DeviceId dest) noexcept;
+
+    /**
+     * Get the counters of a link.
+     *
+     * @param slot slot of the link
+     * @return counters of the link
+     */
+    [[nodiscard]] LinkStats& at(uint32_t slot) noexcept;
+
+    /**
+     * Get the counters of a link.
+     *
+     * @param slot slot of the link
+     * @return counters of the link
+     */
+    [[nodiscard]] const LinkStats& at(uint32_t slot) const noexcept;
+
+    /**
+     * Get the number of registered links.
+     *
+     * @return number of registered links
+     */
+    [[nodiscard]] int get_links_count() const noexcept;
+
+    /**
+     * Dump the counters of every link in CSV format.
+     *
+     * @param os output stream to write to
+     * @param elapsed_time simulated time used to compute link utilization, in ns
+     */
+    void dump_csv(std::ostream& os, EventTime elapsed_time) const noexcept;
+
+    /**
+     * Dump the counters of every link in JSON format.
+     *
+     * @param os output stream to write to
+     * @param elapsed_time simulated time used to compute link utilization, in ns
+     */
+    void dump_json(std::ostream& os, EventTime elapsed_time) const noexcept;
+
+  private:
+    /// counters per each link, indexed by slot
+    std::vector<LinkStats> stats;
+
+    /// (src, dest) device ids per each link, indexed by slot
+    std::vector<std::pair<DeviceId, DeviceId>> endpoints;
+
+    /// id of the link per each slot, empty unless links are registered sparsely
+    std::vector<LinkId> link_ids;
+
+    /**
+     * Get the slots of the registered links, ordered by LinkId.
+     *
+     * @return slots of the registered links
+     */
+    [[nodiscard]] std::vector<uint32_t> slots_by_link_id() const noexcept;
+
+    /**
+     * Compute the utilization of a link.
+     * i.e., utilization = (busy time) / (elapsed time)
+     *
+     * @param slot slot of the link
+     * @param elapsed_time simulated time, in ns
+     * @return utilization of the link in [0, 1]
+     */
+    [[nodiscard]] double utilization(uint32_t slot, EventTime elapsed_time) const noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
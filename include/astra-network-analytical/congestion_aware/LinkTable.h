@@ -0,0 +1,411 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/Link.h"
+#include "congestion_aware/LinkStats.h"
+#include "congestion_aware/Type.h"
+#include <deque>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * LinkTable owns every link of a topology, referenced by LinkId.
+ * The fields touched on every transmission (busy flag, bandwidth, latency)
+ * are kept in contiguous per-field arrays, while the rest of each link
+ * (pending queues, flow control and arbitration state) lives in a Link object.
+ * Link objects are stored in chunks of a deque, so their addresses never change.
+ *
+ * In lazy mode, a Link object is only materialized the first time it is accessed,
+ * usually by the first chunk sent through it, while its hot fields and counters exist up front.
+ * The setups of the links (input buffers, virtual channels, ...) are recorded,
+ * and replayed onto each link as it gets materialized, in the order they were requested.
+ * Setups of a range of links are kept in a list, while those of a single link are indexed by its id,
+ * so materializing a link doesn't go through the setups of every other link.
+ *
+ * In implicit mode, even the hot fields and counters of a link are only allocated once it is materialized,
+ * in the next free slot of the per-field arrays, and its endpoints, bandwidth, and latency
+ * are computed by the topology at that time. An unmaterialized link only costs its slot index.
+ */
+class LinkTable {
+  public:
+    /// setup of a link, applied to its Link object once materialized
+    using LinkSetup = std::function<void(Link&)>;
+
+    /// endpoints, bandwidth in GB/s, and latency in ns of a link
+    struct LinkDescription {
+        DeviceId src;
+        DeviceId dest;
+        Bandwidth bandwidth;
+        Latency latency;
+    };
+
+    /// computes the description of a link of an implicit topology from its id
+    using LinkDescriber = std::function<LinkDescription(LinkId)>;
+
+    /// computes a route from a device to a destination around the dead links, empty if there is none
+    using Rerouter = std::function<Route(DeviceId, DeviceId)>;
+
+    /**
+     * Constructor.
+     */
+    LinkTable() noexcept;
+
+    /**
+     * Destructor.
+     */
+    ~LinkTable() noexcept;
+
+    /**
+     * Report a credit deadlock and exit if some chunks are still waiting on a flow-controlled link,
+     * to be invoked once the event queue is drained, when nothing is left to return them credits.
+     * Checks the chunks of every LinkTable.
+     *
+     * @param arg unused
+     */
+    static void check_deadlock(void* arg) noexcept;
+
+    /**
+     * Set whether Link objects are materialized lazily, on their first access.
+     * Must be invoked before any traffic.
+     * Enabling lazy mode releases the Link objects already materialized,
+     * unless some were set up while eager, since an eager table doesn't record the setups it applies.
+     *
+     * @param lazy true to materialize Link objects lazily, false to materialize every link up front
+     */
+    void set_lazy(bool lazy) noexcept;
+
+    /**
+     * Make the table implicit, allocating the state of a link only once it is materialized.
+     * Implies lazy mode, and must be invoked before any link is created.
+     *
+     * @param describer computes the description of a link from its id
+     */
+    void set_implicit(LinkDescriber describer) noexcept;
+
+    /**
+     * Create a new link and register its traffic counters.
+     *
+     * @param src src device id of the link, -1 for a shared-medium link
+     * @param dest dest device id of the link, -1 for a shared-medium link
+     * @param bandwidth bandwidth of the link in GB/s
+     * @param latency latency of the link in ns
+     * @return id of the created link
+     */
+    [[nodiscard]] LinkId add_link(DeviceId src, DeviceId dest, Bandwidth bandwidth, Latency latency) noexcept;
+
+    /**
+     * Create multiple links at once, to be set up by init_link().
+     * Used to build large topologies, whose links are then set up in parallel.
+     * In implicit mode, only the ids are reserved, and links are set up once materialized.
+     *
+     * @param links_count number of links to create
+     * @return id of the first created link, the others following consecutively
+     */
+    [[nodiscard]] LinkId add_links(int links_count) noexcept;
+
+    /**
+     * Set up a link created by add_links().
+     * Different links can be set up concurrently.
+     *
+     * @param link_id id of the link
+     * @param src src device id of the link, -1 for a shared-medium link
+     * @param dest dest device id of the link, -1 for a shared-medium link
+     * @param bandwidth bandwidth of the link in GB/s
+     * @param latency latency of the link in ns
+     */
+    void init_link(LinkId link_id, DeviceId src, DeviceId dest, Bandwidth bandwidth, Latency latency) noexcept;
+
+    /**
+     * Create multiple links at once from the arrays of a compiled topology, copying the arrays wholesale.
+     *
+     * @param links_count number of links to create
+     * @param srcs src device id per each link, -1 for a shared-medium link
+     * @param dests dest device id per each link, -1 for a shared-medium link
+     * @param bandwidths_Bpns bandwidth per each link in B/ns, as returned by get_bandwidth_Bpns()
+     * @param latencies latency per each link in ns
+     * @return id of the first created link, the others following consecutively
+     */
+    [[nodiscard]] LinkId add_compiled_links(int links_count,
+                                            const DeviceId* srcs,
+                                            const DeviceId* dests,
+                                            const Bandwidth* bandwidths_Bpns,
+                                            const Latency* latencies) noexcept;
+
+    /**
+     * Get the endpoints of a link.
+     *
+     * @param link_id id of the link
+     * @return (src, dest) device ids of the link, -1 for a shared-medium link
+     */
+    [[nodiscard]] std::pair<DeviceId, DeviceId> get_endpoints(LinkId link_id) const noexcept;
+
+    /**
+     * Set up a link, now if it is materialized, and whenever it gets materialized again.
+     * The setup is only recorded if the table is lazy, an eager table applying it right away.
+     *
+     * @param link_id id of the link
+     * @param setup setup to apply to the link
+     */
+    void setup_link(LinkId link_id, LinkSetup setup) noexcept;
+
+    /**
+     * Set up a range of consecutive links, now for those materialized, and for the others once materialized.
+     * The setup is only recorded if the table is lazy, an eager table applying it right away.
+     *
+     * @param first_link_id id of the first link of the range
+     * @param links_count number of links in the range
+     * @param setup setup to apply to each link
+     */
+    void setup_links(LinkId first_link_id, int links_count, const LinkSetup& setup) noexcept;
+
+    /**
+     * Get a link, materializing it if needed.
+     *
+     * @param link_id id of the link
+     * @return the link
+     */
+    [[nodiscard]] Link& at(LinkId link_id) noexcept;
+
+    /**
+     * Get a link, which must be materialized.
+     *
+     * @param link_id id of the link
+     * @return the link
+     */
+    [[nodiscard]] const Link& at(LinkId link_id) const noexcept;
+
+    /**
+     * Get the number of links, whether materialized or not.
+     *
+     * @return number of links
+     */
+    [[nodiscard]] int get_links_count() const noexcept;
+
+    /**
+     * Get the number of links whose Link object is materialized.
+     *
+     * @return number of materialized links
+     */
+    [[nodiscard]] int get_materialized_links_count() const noexcept;
+
+    /**
+     * Get the traffic counters of a link.
+     * A link of an implicit table that was never materialized has all-zero counters.
+     *
+     * @param link_id id of the link
+     * @return traffic counters of the link
+     */
+    [[nodiscard]] const LinkStats& get_link_stats(LinkId link_id) const noexcept;
+
+    /**
+     * Get the traffic counters of a link to update them, materializing the link if needed.
+     *
+     * @param link_id id of the link
+     * @return traffic counters of the link
+     */
+    [[nodiscard]] LinkStats& update_link_stats(LinkId link_id) noexcept;
+
+    /**
+     * Check if a link is busy.
+     * A link of an implicit table that was never materialized is free.
+     *
+     * @param link_id id of the link
+     * @return true if the link is busy, false otherwise
+     */
+    [[nodiscard]] bool is_busy(LinkId link_id) const noexcept;
+
+    /**
+     * Set whether a link is busy.
+     *
+     * @param link_id id of the link
+     * @param link_busy true if the link becomes busy, false if it becomes free
+     */
+    void set_busy(LinkId link_id, bool link_busy) noexcept;
+
+    /**
+     * Get the number of chunks occupying a link, i.e., under transmission or waiting for it.
+     * A link that was never materialized is empty.
+     *
+     * @param link_id id of the link
+     * @return number of chunks occupying the link
+     */
+    [[nodiscard]] uint64_t get_occupancy(LinkId link_id) const noexcept;
+
+    /**
+     * Get the bandwidth of a link.
+     * The bandwidth of a link of an implicit table that was never materialized is computed on the fly.
+     *
+     * @param link_id id of the link
+     * @return bandwidth of the link in B/ns
+     */
+    [[nodiscard]] Bandwidth get_bandwidth_Bpns(LinkId link_id) const noexcept;
+
+    /**
+     * Get the latency of a link.
+     * The latency of a link of an implicit table that was never materialized is computed on the fly.
+     *
+     * @param link_id id of the link
+     * @return latency of the link in ns
+     */
+    [[nodiscard]] Latency get_latency(LinkId link_id) const noexcept;
+
+    /**
+     * Set the rerouter steering chunks around the dead links.
+     *
+     * @param rerouter computes a route from a device to a destination around the dead links
+     */
+    void set_rerouter(Rerouter rerouter) noexcept;
+
+    /**
+     * Set the health of a link, materializing it if needed.
+     *
+     * @param link_id id of the link
+     * @param health fraction of the constructed bandwidth left, 0 if the link is dead
+     */
+    void set_health(LinkId link_id, double health) noexcept;
+
+    /**
+     * Get the health of a link.
+     * A link that was never materialized is healthy.
+     *
+     * @param link_id id of the link
+     * @return fraction of the constructed bandwidth left, 0 if the link is dead
+     */
+    [[nodiscard]] double get_health(LinkId link_id) const noexcept;
+
+    /**
+     * Check if a link is dead.
+     * A link that was never materialized is healthy.
+     *
+     * @param link_id id of the link
+     * @return true if the link is dead, false otherwise
+     */
+    [[nodiscard]] bool is_dead(LinkId link_id) const noexcept;
+
+    /**
+     * Route a chunk from its current device to its destination around the dead links.
+     *
+     * @param chunk chunk to reroute
+     * @return true if rerouted, false if no route is left, leaving the route of the chunk untouched
+     */
+    [[nodiscard]] bool reroute(Chunk& chunk) const noexcept;
+
+    /**
+     * Account chunks entering or leaving the pending queues of a link with a bounded input buffer.
+     * Once no event is left, such chunks can only be waiting for credits.
+     *
+     * @param delta number of chunks enqueued, negative if dequeued
+     */
+    void update_credit_waiting_chunks(int64_t delta) noexcept;
+
+    /**
+     * Get the traffic counters of every link.
+     * In implicit mode, the table only holds the links materialized so far, indexed by slot.
+     *
+     * @return traffic counters table
+     */
+    [[nodiscard]] const LinkStatsTable& get_stats() const noexcept;
+
+  private:
+    /// setup recorded for a range of links [first_link_id, end_link_id)
+    struct RecordedSetup {
+        LinkId first_link_id;
+        LinkId end_link_id;
+        uint64_t order;
+        LinkSetup setup;
+    };
+
+    /// setup recorded for a single link
+    struct RecordedLinkSetup {
+        uint64_t order;
+        LinkSetup setup;
+    };
+
+    /// slot of a link of an implicit table that was never materialized
+    static constexpr uint32_t no_slot = UINT32_MAX;
+
+    /// true if Link objects are materialized on their first access
+    bool lazy;
+
+    /// computes the description of a link, nullptr unless the table is implicit
+    LinkDescriber describer;
+
+    /// computes a route around the dead links, nullptr if chunks are never rerouted
+    Rerouter rerouter;
+
+    /// number of dead links
+    int dead_links_count;
+
+    /// slot of each link in the per-field arrays, indexed by LinkId
+    /// empty unless the table is implicit, the slot of a link being its LinkId otherwise
+    std::vector<uint32_t> slot_of_link;
+
+    /// busy flag per each link, indexed by slot
+    std::vector<uint8_t> busy;
+
+    /// bandwidth in B/ns per each link, indexed by slot
+    std::vector<Bandwidth> bandwidth_Bpns;
+
+    /// latency in ns per each link, indexed by slot
+    std::vector<Latency> latency;
+
+    /// materialized Link objects, in materialization order
+    std::deque<Link> links;
+
+    /// materialized Link object per each link, indexed by slot, nullptr if not materialized
+    std::vector<Link*> link_objects;
+
+    /// setups of the ranges of links, in the order they were requested
+    std::vector<RecordedSetup> range_setups;
+
+    /// setups of single links, indexed by LinkId, each list in the order they were requested
+    std::unordered_map<LinkId, std::vector<RecordedLinkSetup>> link_setups;
+
+    /// number of setups requested so far, ordering the range setups and the single-link ones
+    uint64_t setups_count;
+
+    /// traffic counters per each link, indexed by slot
+    LinkStatsTable stats;
+
+    /// chunks pending on the links of this table with a bounded input buffer
+    uint64_t credit_waiting_chunks;
+
+    /// chunks pending on the links with a bounded input buffer, over every LinkTable
+    static uint64_t total_credit_waiting_chunks;
+
+    /**
+     * Get the slot of a link.
+     *
+     * @param link_id id of the link
+     * @return slot of the link, no_slot if the link of an implicit table was never materialized
+     */
+    [[nodiscard]] uint32_t slot(LinkId link_id) const noexcept;
+
+    /**
+     * Get the slot of a link, allocating it if the link of an implicit table was never materialized.
+     *
+     * @param link_id id of the link
+     * @return slot of the link
+     */
+    [[nodiscard]] uint32_t materialized_slot(LinkId link_id) noexcept;
+
+    /**
+     * Create the Link object of a link and replay its setups.
+     *
+     * @param link_id id of the link
+     * @return the materialized link
+     */
+    Link& materialize(LinkId link_id) noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
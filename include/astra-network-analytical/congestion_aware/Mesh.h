@@ -32,14 +32,14 @@ class Mesh final : public BasicTopology {
      * @param latency latency of link
      * @param bidirectional true if ring is bidirectional
      * @param is_multi_dim  true if part of multidimensional topology
-     * @param faulty_links  list of faulty links as tuples (src, dst, weight)
+     * @param fault_map health of the faulty links, nullptr if no link is faulty
      */
     Mesh(int npus_count,
          Bandwidth bandwidth,
          Latency latency,
          bool bidirectional = true,
          bool is_multi_dim = false,
-         const std::vector<std::tuple<int, int, double>>& faulty_links = {}) noexcept;
+         std::shared_ptr<const FaultMap> fault_map = nullptr) noexcept;
 
     /**
      * Alternate constructor for convenience
@@ -47,8 +47,8 @@ class Mesh final : public BasicTopology {
     Mesh(int npus_count,
          Bandwidth bandwidth,
          Latency latency,
-         const std::vector<std::tuple<int, int, double>>& faulty_links) noexcept
-        : Mesh(npus_count, bandwidth, latency, true, false, faulty_links) {}
+         std::shared_ptr<const FaultMap> fault_map) noexcept
+        : Mesh(npus_count, bandwidth, latency, true, false, std::move(fault_map)) {}
 
     /**
      * Implementation of route function in Topology.
@@ -68,9 +68,6 @@ class Mesh final : public BasicTopology {
   private:
 
     bool bidirectional = true;
-    double fault_derate(int src, int dst) const;
-
-    std::vector<std::tuple<int,int,double>> faulty_links;
 
 };
 
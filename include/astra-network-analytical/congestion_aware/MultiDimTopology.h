@@ -5,13 +5,18 @@ LICENSE file in the root directory of this source tree.
 
 #pragma once
 
+#include "common/AddressTranslator.h"
+#include "common/MultiDimAddress.h"
 #include "common/Type.h"
 #include "congestion_aware/BasicTopology.h"
+#include "congestion_aware/LinkTable.h"
 #include "congestion_aware/SwitchTranslationUnit.h"
 #include "congestion_aware/Topology.h"
+#include "congestion_aware/TopologyCache.h"
 
 #include <memory>
 #include <optional>
+#include <ostream>
 
 using namespace NetworkAnalytical;
 
@@ -25,14 +30,25 @@ class MultiDimTopology : public Topology {
   public:
     /**
      * Constructor.
+     *
+     * @param fault_map health of the faulty links, nullptr if no link is faulty
+     * @param non_recursive_topo per dimension, 0 if the dimension is non-recursive
      */
-    MultiDimTopology(const std::vector<std::tuple<int, int, double>> faulty_links, std::vector<int>non_recursive_topo) noexcept;
+    MultiDimTopology(std::shared_ptr<const FaultMap> fault_map, std::vector<int> non_recursive_topo) noexcept;
 
     /**
      * Implementation of route function in Topology.
      */
     [[nodiscard]] Route route(DeviceId src, DeviceId dest) const noexcept override;
 
+    /**
+     * Implementation of routes function in Topology.
+     * A cluster topology offers one route per each agent of the clusters, see set_cluster_agents().
+     * Otherwise, the routes traverse first each dimension src and dest differ in, then the others
+     * from the highest to the lowest, each dimension taking its alternative routes in turn.
+     */
+    [[nodiscard]] std::vector<Route> routes(DeviceId src, DeviceId dest) const noexcept override;
+
     // traditional multidim
     [[nodiscard]] Route routeNormal(DeviceId src, DeviceId dest) const noexcept;
 
@@ -48,15 +64,89 @@ class MultiDimTopology : public Topology {
      */
     void append_dimension(std::unique_ptr<BasicTopology> basic_topology) noexcept;
 
+    /**
+     * Set the input buffer size of each dimension, enabling credit-based flow control.
+     * Ring dimensions need larger buffers than the traffic going around them, or deadlock-free routing,
+     * since their buffers depend on each other cyclically.
+     * Must be called before make_connections().
+     *
+     * @param input_buffer_size_per_dim input buffer size in bytes per each dimension
+     */
+    void set_input_buffer_size_per_dim(std::vector<ChunkSize> input_buffer_size_per_dim) noexcept;
+
     /**
      * Make connections for all nodes inter and intra dimensions.
      */
     void make_connections() noexcept;
 
     /**
-     * Make connections for all nodes inter and intra dimensions.
+     * Make connections for all nodes from a compiled topology, instead of make_connections().
+     * The compiled topology is checked against the shape of this topology.
+     *
+     * @param topology_cache compiled topology, built by save_connections() for the same config
+     * @return true if connected, false if the compiled topology doesn't match, leaving the topology unconnected
+     */
+    [[nodiscard]] bool load_connections(const TopologyCache& topology_cache) noexcept;
+
+    /**
+     * Compile the connections made by make_connections() into a file, to be loaded by load_connections().
+     *
+     * @param path path of the compiled topology
+     * @param topology_hash hash of the config the topology is constructed from
+     * @return true if written, false otherwise
+     */
+    [[nodiscard]] bool save_connections(const std::string& path, uint64_t topology_hash) const noexcept;
+
+    /**
+     * Set the number of threads building the topology.
+     * The constructed topology is the same regardless of the number of threads.
+     *
+     * @param threads_count number of threads, 0 for all hardware threads
+     */
+    void set_construction_threads(int threads_count) noexcept;
+
+    /**
+     * Make the topology implicit: devices and links are identified by arithmetic on their addresses,
+     * and only materialized once used, instead of being instantiated and connected up front.
+     * The links get the same ids as in an explicit topology.
+     * Must be called before initialize_all_devices().
+     *
+     * @param implicit true to make the topology implicit
+     */
+    void set_implicit(bool implicit) noexcept;
+
+    /**
+     * Make routeNormal() pick the dimension traversed first per each route, UGAL-style,
+     * instead of always traversing the dimensions from the highest to the lowest.
+     * routeCluster() does the same within the clusters, i.e., on the way to and from the agents.
+     * Among the dimensions src and dest differ in, the one whose first link holds the least work
+     * (chunks under transmission or waiting, divided by the link bandwidth) goes first,
+     * then the others from the highest to the lowest. Ties keep the highest dimension first.
+     *
+     * @param adaptive_routing true to pick the first dimension by the load of the links
+     */
+    void set_adaptive_routing(bool adaptive_routing) noexcept;
+
+    /**
+     * Set the number of agents per cluster of a cluster topology, i.e., the NPUs of each cluster
+     * linked in the non-recursive dimensions, and how routeCluster() picks the agents of each chunk.
+     * Agent k of a cluster is its NPU at offset k, i.e., its k-th NPU in id order.
+     * Must be invoked before make_connections().
+     *
+     * @param agents_count number of agents per cluster, capped at the number of NPUs per cluster
+     * @param selection Hash to spread the (src, dest) pairs over the agents,
+     *     LeastLoaded to take the route through the agents with the least work queued on its links
+     */
+    void set_cluster_agents(int agents_count, ClusterAgentSelection selection) noexcept;
+
+    /**
+     * Dump the load of each dimension in CSV format, i.e., the traffic counters summed over its links,
+     * with the average and maximum utilization of its links.
+     *
+     * @param os output stream to write to
+     * @param elapsed_time simulated time used to compute link utilization, in ns
      */
-    void make_non_recursive_connections() noexcept;
+    void dump_dim_load_csv(std::ostream& os, EventTime elapsed_time) const noexcept;
 
     /**
      * Initialize all devices in the topology.
@@ -68,6 +158,25 @@ class MultiDimTopology : public Topology {
      */
     void build_switch_length_mapping() noexcept;
 
+    /**
+     * Make the switches of the selected Switch dimensions reduce the chunks tagged with a reduction group.
+     *
+     * @param enabled_per_dim whether the switches of each dimension reduce chunks
+     * @param throughput_per_dim reduction throughput of each switch per each dimension in GB/s,
+     *     0 if reductions take no time
+     */
+    void set_in_network_reduction_per_dim(const std::vector<bool>& enabled_per_dim,
+                                          const std::vector<Bandwidth>& throughput_per_dim) noexcept;
+
+  protected:
+    /**
+     * Get the output ports of a device of an implicit topology, computed from its address.
+     *
+     * @param device_id id of the device
+     * @param ports filled with the (connected device id, link id) of each output port, sorted by device id
+     */
+    void get_implicit_ports(DeviceId device_id, std::vector<std::pair<DeviceId, LinkId>>& ports) const noexcept override;
+
   private:
     /**
      * Translate the NPU ID into a multi-dimensional address.
@@ -77,9 +186,67 @@ class MultiDimTopology : public Topology {
      */
     [[nodiscard]] MultiDimAddress translate_address(DeviceId npu_id) const noexcept;
 
-    [[nodiscard]] DeviceId translate_address_back(const MultiDimAddress multi_dim_address) const noexcept;
+    /**
+     * Translate a multi-dimensional address of an NPU back into its ID.
+     *
+     * @param multi_dim_address multi-dimensional address of the NPU
+     * @return id of the NPU
+     */
+    [[nodiscard]] DeviceId translate_address_back(const MultiDimAddress& multi_dim_address) const noexcept;
 
-    [[nodiscard]] Route routeHelper(DeviceId src, DeviceId dest, const std::vector<int>& routing_dimensions) const noexcept;
+    /**
+     * Route through the dimensions in the given order, around the faulty links if any.
+     *
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @param routing_dimensions order the dimensions are traversed in
+     * @param alternative index of the route taken within each dimension among its routes(),
+     *                    the last one of a dimension offering fewer
+     * @return route from src to dest
+     */
+    [[nodiscard]] Route routeHelper(DeviceId src,
+                                    DeviceId dest,
+                                    const std::vector<int>& routing_dimensions,
+                                    size_t alternative = 0) const noexcept;
+
+    /**
+     * Route through the given dimensions, with the first one picked by the load of the links
+     * if adaptive routing is enabled, see set_adaptive_routing().
+     *
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @param routing_dimensions static dimension order
+     * @return route from src to dest
+     */
+    [[nodiscard]] Route routeInOrder(DeviceId src, DeviceId dest, const std::vector<int>& routing_dimensions) const noexcept;
+
+    /**
+     * Route with the dimension traversed first picked by the load of its first link, see set_adaptive_routing().
+     *
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @param routing_dimensions static dimension order, the others following the first dimension in this order
+     * @return route from src to dest
+     */
+    [[nodiscard]] Route routeAdaptive(DeviceId src, DeviceId dest, const std::vector<int>& routing_dimensions) const noexcept;
+
+    /**
+     * Route from src to dest through a given agent of the clusters, see routeCluster().
+     *
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @param agent offset of the agent within its cluster
+     * @return route from src to dest
+     */
+    [[nodiscard]] Route routeClusterThroughAgent(DeviceId src, DeviceId dest, int agent) const noexcept;
+
+    /**
+     * Get the first non-recursive dimension of a cluster topology,
+     * the lower dimensions spanning the NPUs of a cluster.
+     *
+     * @return the first non-recursive dimension
+     */
+    [[nodiscard]] int get_first_non_recursive_dim() const noexcept;
 
     /**
      * Given src and dest address in multi-dimensional form,
@@ -108,13 +275,158 @@ class MultiDimTopology : public Topology {
      */
     [[nodiscard]] bool is_switch(const MultiDimAddress& address) const noexcept;
 
-    double fault_derate(int src, int dst) const;
-    std::vector<std::tuple<int, int, double>> faulty_links;
+    /**
+     * Check whether a dimension only connects cluster agents, i.e., the NPUs whose offset within
+     * the block spanned by the lower dimensions is that of an agent, see set_cluster_agents().
+     * This holds for the non-recursive dimensions of a cluster topology, which routeCluster() only crosses at agents.
+     *
+     * @param dim the dimension
+     * @return true if the dimension only connects cluster agents, false if it connects every NPU
+     */
+    [[nodiscard]] bool is_agents_only_dim(int dim) const noexcept;
+
+    /**
+     * Get the number of combinations of the addresses in the other dimensions a connection policy of a dimension
+     * yields a pair for, the lower dimensions only taking the agent offsets if the dimension only connects agents.
+     *
+     * @param dim the dimension
+     * @return number of combinations
+     */
+    [[nodiscard]] int64_t get_combinations_count(int dim) const noexcept;
+
+    /**
+     * Enumerate the (src, dest) device ids a connection policy of a dimension yields,
+     * i.e., one pair per each combination of the addresses in the other dimensions, see get_combinations_count().
+     * Device ids are computed with stride arithmetic, so no address is materialized,
+     * and pairs are visited in the lexicographic order of their addresses.
+     *
+     * @param dim dimension of the policy
+     * @param policy connection policy of the dimension
+     * @param visit callable invoked as visit(src, dest) per each pair
+     */
+    template <typename Visitor>
+    void for_each_connection(int dim, const ConnectionPolicy& policy, Visitor&& visit) const noexcept;
+
+    /**
+     * Make connections of a dimension with point-to-point links, in parallel.
+     * Links get the same ids as if the pairs were connected one by one in enumeration order,
+     * and a pair already connected is skipped.
+     *
+     * @param dim the dimension
+     */
+    void make_dim_connections(int dim) noexcept;
+
+    /**
+     * Run a task over [0, count) split into contiguous ranges, one per each construction thread.
+     *
+     * @param count number of items
+     * @param task callable invoked as task(begin, end, thread_index) per each range
+     */
+    template <typename Task>
+    void parallel_for(int64_t count, Task&& task) const noexcept;
+
+    /**
+     * Make connections of a Bus dimension.
+     * Each group of NPUs differing only in the given dimension is attached to its own shared-medium link.
+     *
+     * @param dim the Bus dimension
+     */
+    void make_bus_connections(int dim) noexcept;
+
+    /**
+     * Number the links of an implicit topology, without creating them.
+     * The links of a dimension follow those of the previous one, and within a Bus dimension,
+     * one link per each group, in the order of the ids of the group members.
+     * Within another dimension, links are numbered by distinct connection policy,
+     * then by the combination of the addresses in the other dimensions, the last dimension changing fastest.
+     */
+    void make_implicit_connections() noexcept;
+
+    /**
+     * Set up the links of each dimension numbered by m_first_link_per_dim,
+     * i.e., the round-robin arbitration of Bus dimensions, and the input buffers.
+     */
+    void setup_links_per_dim() noexcept;
+
+    /**
+     * Compute the endpoints, bandwidth, and latency of a link of an implicit topology.
+     *
+     * @param link_id id of the link
+     * @return description of the link
+     */
+    [[nodiscard]] LinkTable::LinkDescription describe_implicit_link(LinkId link_id) const noexcept;
+
+    /**
+     * Get the index of the combination of the addresses in every dimension but one,
+     * the last dimension changing fastest, the lower dimensions making up the agent offset, most significant,
+     * if the dimension only connects cluster agents.
+     *
+     * @param address multi-dimensional address
+     * @param dim the dimension left out
+     * @return index of the combination
+     */
+    [[nodiscard]] int64_t get_combination_index(const MultiDimAddress& address, int dim) const noexcept;
+
+    /**
+     * Get the id of the device at a multi-dimensional address, either an NPU or a switch.
+     *
+     * @param address multi-dimensional address of the device
+     * @return id of the device
+     */
+    [[nodiscard]] DeviceId get_device_id(const MultiDimAddress& address) const noexcept;
+
+    /**
+     * Get the members of a group of a Bus dimension, i.e., the NPUs differing only in the dimension.
+     *
+     * @param dim the Bus dimension
+     * @param group index of the group, in the order of the ids of the group members
+     * @return ids of the group members
+     */
+    [[nodiscard]] std::vector<DeviceId> get_bus_group(int dim, int64_t group) const noexcept;
+
+    /**
+     * Get the index of the group of a Bus dimension an NPU belongs to.
+     *
+     * @param dim the Bus dimension
+     * @param npu_id id of the NPU
+     * @return index of the group, in the order of the ids of the group members
+     */
+    [[nodiscard]] int64_t get_bus_group_index(int dim, DeviceId npu_id) const noexcept;
+
     std::vector<int> m_non_recursive_topo;
 
+    /// input buffer size per each dimension, empty if buffers are unbounded
+    std::vector<ChunkSize> m_input_buffer_size_per_dim;
+
+    /// number of threads building the topology
+    int m_construction_threads = 1;
+
+    /// true if devices and links are only materialized once used
+    bool m_implicit = false;
+
+    /// true if routeNormal() and routeCluster() pick the first dimension by the load of the links
+    bool m_adaptive_routing = false;
+
+    /// number of agents per cluster linked in the non-recursive dimensions
+    int m_cluster_agents_count = 1;
+
+    /// how routeCluster() picks the agents of each chunk
+    ClusterAgentSelection m_cluster_agent_selection = ClusterAgentSelection::Hash;
+
+    /// id of the first link of each dimension, followed by the number of links
+    std::vector<LinkId> m_first_link_per_dim;
+
+    /// distinct connection policies of each dimension of an implicit topology, in connection order
+    std::vector<std::vector<ConnectionPolicy>> m_policies_per_dim;
+
+    /// index in m_policies_per_dim of the policy connecting each (src, dst) pair of each dimension, -1 if none
+    /// indexed by (src * (npus_count + 1) + dst), an address equal to the npus_count denoting the switch
+    std::vector<std::vector<int>> m_policy_index_per_dim;
 
     /// BasicTopology instances per dimension.
     std::vector<std::unique_ptr<BasicTopology>> m_topology_per_dim;
+    /// Translates NPU IDs to multi-dimensional addresses and back.
+    AddressTranslator m_address_translator;
     /// Switch translation unit for address to device ID translation.
     std::optional<SwitchTranslationUnit> m_switch_translation_unit;
 };
@@ -0,0 +1,136 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/EventQueue.h"
+#include "common/Type.h"
+#include "congestion_aware/Type.h"
+#include <list>
+#include <map>
+#include <memory>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * NetworkInterface models the NIC of an NPU.
+ * Without a NetworkInterface, an NPU hands chunks straight to its links,
+ * i.e., it can inject onto and receive from every link at full rate at once.
+ *
+ * With a NetworkInterface:
+ *   - injection: a chunk has to be read by one of the DMA engines before reaching its egress link.
+ *     Each engine reads one chunk at a time at (injection bandwidth / number of DMA engines),
+ *     and waiting chunks take a free engine in FIFO order, or in round-robin order among destinations.
+ *   - ejection: arriving chunks are written out one at a time at the ejection bandwidth,
+ *     holding their input buffer space until they are written out.
+ * A bandwidth of 0 leaves the corresponding direction unlimited.
+ */
+class NetworkInterface {
+  public:
+    /**
+     * Callback to be called when a DMA engine finishes reading a chunk.
+     * The chunk is handed over to its egress link, and the engine reads the next waiting chunk.
+     *
+     * @param injection_ptr pointer to the finished injection
+     */
+    static void injection_finished(void* injection_ptr) noexcept;
+
+    /**
+     * Callback to be called when a chunk is written out to the NPU.
+     * The chunk is consumed by its destination.
+     *
+     * @param chunk_ptr pointer to the ejected chunk
+     */
+    static void ejection_finished(void* chunk_ptr) noexcept;
+
+    /**
+     * Set the event queue to be used by the network interfaces.
+     *
+     * @param event_queue_ptr pointer to the event queue
+     */
+    static void set_event_queue(std::shared_ptr<EventQueue> event_queue_ptr) noexcept;
+
+    /**
+     * Constructor.
+     *
+     * @param link_table table owning the egress links of the NPU
+     * @param injection_bandwidth aggregate injection bandwidth in GB/s, 0 if unlimited
+     * @param ejection_bandwidth aggregate ejection bandwidth in GB/s, 0 if unlimited
+     * @param dma_engines number of DMA engines injecting chunks in parallel
+     * @param scheduling order in which waiting chunks take a free DMA engine
+     */
+    NetworkInterface(LinkTable* link_table,
+                     Bandwidth injection_bandwidth,
+                     Bandwidth ejection_bandwidth,
+                     int dma_engines,
+                     NicScheduling scheduling) noexcept;
+
+    /**
+     * Inject a chunk originating from the NPU.
+     *
+     * @param chunk chunk to inject
+     * @param egress_link link the chunk leaves the NPU through
+     */
+    void inject(std::unique_ptr<Chunk> chunk, LinkId egress_link) noexcept;
+
+    /**
+     * Eject a chunk that arrived at the NPU.
+     *
+     * @param chunk chunk to eject
+     */
+    void eject(std::unique_ptr<Chunk> chunk) noexcept;
+
+  private:
+    /// event queue NetworkInterface uses to schedule events
+    static std::shared_ptr<EventQueue> event_queue;
+
+    /**
+     * Injection is a chunk being read by a DMA engine, or waiting for one.
+     */
+    struct Injection {
+        /// network interface the injection happens in
+        NetworkInterface* network_interface;
+
+        /// the injected chunk
+        std::unique_ptr<Chunk> chunk;
+
+        /// link the chunk leaves the NPU through
+        LinkId egress_link;
+    };
+
+    /// table owning the egress links of the NPU
+    LinkTable* link_table;
+
+    /// injection bandwidth of each DMA engine in B/ns, 0 if unlimited
+    Bandwidth engine_bandwidth_Bpns;
+
+    /// aggregate ejection bandwidth in B/ns, 0 if unlimited
+    Bandwidth ejection_bandwidth_Bpns;
+
+    /// number of idle DMA engines
+    int idle_dma_engines;
+
+    /// order in which waiting chunks take a free DMA engine
+    NicScheduling scheduling;
+
+    /// waiting injections per each destination NPU
+    /// FIFO keeps every waiting injection under a single destination (-1)
+    std::map<DeviceId, std::list<Injection>> waiting_injections;
+
+    /// destination served last by RoundRobin
+    DeviceId last_served_dest;
+
+    /// time the ejection path becomes free
+    EventTime ejection_free_time;
+
+    /**
+     * Start reading the next waiting chunk with an idle DMA engine.
+     */
+    void start_next_injection() noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
@@ -0,0 +1,95 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/EventQueue.h"
+#include "common/Type.h"
+#include "congestion_aware/Type.h"
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * ReductionEngine models the in-network reduction unit of a switch (e.g., SHARP).
+ * Chunks tagged with a reduction group are held at the switch
+ * until every contribution of the group heading to the same destination arrived.
+ * The contributions are then reduced into a single chunk, which is forwarded to the destination,
+ * while the other contributions stop travelling and free their input buffer space.
+ * Reductions are processed one at a time, reading all contributions at the reduction throughput.
+ */
+class ReductionEngine {
+  public:
+    /**
+     * Callback to be called when a reduction finishes.
+     * The reduced chunk is forwarded by the switch.
+     *
+     * @param reduction_ptr pointer to the finished reduction
+     */
+    static void reduction_finished(void* reduction_ptr) noexcept;
+
+    /**
+     * Set the event queue to be used by the reduction engines.
+     *
+     * @param event_queue_ptr pointer to the event queue
+     */
+    static void set_event_queue(std::shared_ptr<EventQueue> event_queue_ptr) noexcept;
+
+    /**
+     * Constructor.
+     *
+     * @param device switch the engine belongs to
+     * @param throughput reduction throughput in GB/s, 0 if reductions take no time
+     */
+    ReductionEngine(Device* device, Bandwidth throughput) noexcept;
+
+    /**
+     * Hold a contribution until every contribution of its reduction arrived.
+     *
+     * @param chunk contribution that arrived at the switch
+     */
+    void reduce(std::unique_ptr<Chunk> chunk) noexcept;
+
+  private:
+    /// event queue ReductionEngine uses to schedule events
+    static std::shared_ptr<EventQueue> event_queue;
+
+    /**
+     * Reduction is a reduced chunk being computed by the engine.
+     */
+    struct Reduction {
+        /// engine computing the reduction
+        ReductionEngine* reduction_engine;
+
+        /// the reduced chunk
+        std::unique_ptr<Chunk> chunk;
+    };
+
+    /// switch the engine belongs to
+    Device* device;
+
+    /// reduction throughput in B/ns, 0 if reductions take no time
+    Bandwidth throughput_Bpns;
+
+    /// contributions arrived so far per each (reduction group, destination)
+    std::map<std::pair<ReductionGroup, DeviceId>, std::vector<std::unique_ptr<Chunk>>> contributions;
+
+    /// time the engine becomes free
+    EventTime free_time;
+
+    /**
+     * Forward a reduced chunk to its destination.
+     *
+     * @param chunk reduced chunk
+     */
+    void forward(std::unique_ptr<Chunk> chunk) noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
@@ -33,7 +33,7 @@ class Ring final : public BasicTopology {
      * @param bidirectional true if ring is bidirectional
      * @param is_multi_dim  true if part of multidimensional topology
      * @param non_recursive_topo
-     * @param faulty_links  list of faulty links as tuples (src, dst, weight)
+     * @param fault_map health of the faulty links, nullptr if no link is faulty
      */
     Ring(int npus_count,
          Bandwidth bandwidth,
@@ -41,7 +41,7 @@ class Ring final : public BasicTopology {
          bool bidirectional = true,
          bool is_multi_dim = false,
          int non_recursive_topo = 1,
-         const std::vector<std::tuple<int, int, double>>& faulty_links = {}) noexcept;
+         std::shared_ptr<const FaultMap> fault_map = nullptr) noexcept;
 
     /**
      * Alternate constructor for convenience
@@ -49,24 +49,37 @@ class Ring final : public BasicTopology {
     Ring(int npus_count,
          Bandwidth bandwidth,
          Latency latency,
-         const std::vector<std::tuple<int, int, double>>& faulty_links) noexcept
-        : Ring(npus_count, bandwidth, latency, true, false, 1, faulty_links) {}
+         std::shared_ptr<const FaultMap> fault_map) noexcept
+        : Ring(npus_count, bandwidth, latency, true, false, 1, std::move(fault_map)) {}
 
     /**
      * Implementation of route function in Topology.
      */
     [[nodiscard]] Route route(DeviceId src, DeviceId dest) const noexcept override;
 
+    /**
+     * Implementation of routes function in Topology.
+     * Halfway around a bidirectional ring, both the clockwise and the anticlockwise routes.
+     */
+    [[nodiscard]] std::vector<Route> routes(DeviceId src, DeviceId dest) const noexcept override;
+
     /**
      * Get connection policies of the ring topology.
      */
     [[nodiscard]] std::vector<ConnectionPolicy> get_connection_policies() const noexcept override;
 
  private:
-    double fault_derate(int src, int dst) const;
+    /**
+     * Construct the route from src to dest going around the ring in one direction.
+     *
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @param step 1 to go clockwise, -1 to go anticlockwise
+     * @return route from src NPU to dest NPU
+     */
+    [[nodiscard]] Route route_in_direction(DeviceId src, DeviceId dest, int step) const noexcept;
 
     bool bidirectional;
-    std::vector<std::tuple<int, int, double>> faulty_links;
     int non_recursive_topo;
 };
 
@@ -38,14 +38,14 @@ class Switch final : public BasicTopology {
      * @param latency latency of link
      * @param bidirectional true if switch is bidirectional
      * @param is_multi_dim  true if part of multidimensional topology
-     * @param faulty_links  list of faulty links as tuples (src, dst, weight)
+     * @param fault_map health of the faulty links, nullptr if no link is faulty
      */
     Switch(int npus_count,
          Bandwidth bandwidth,
          Latency latency,
          bool bidirectional = true,
          bool is_multi_dim = false,
-         const std::vector<std::tuple<int, int, double>>& faulty_links = {}) noexcept;
+         std::shared_ptr<const FaultMap> fault_map = nullptr) noexcept;
 
     /**
      * Alternate constructor for convenience
@@ -53,8 +53,8 @@ class Switch final : public BasicTopology {
     Switch(int npus_count,
          Bandwidth bandwidth,
          Latency latency,
-         const std::vector<std::tuple<int, int, double>>& faulty_links) noexcept
-        : Switch(npus_count, bandwidth, latency, true, false, faulty_links) {}
+         std::shared_ptr<const FaultMap> fault_map) noexcept
+        : Switch(npus_count, bandwidth, latency, true, false, std::move(fault_map)) {}
     /**
      * Implementation of route function in Topology.
      */
@@ -73,10 +73,7 @@ class Switch final : public BasicTopology {
   private:
     /// node_id of the switch node
     DeviceId switch_id;
-    double fault_derate(int src, int dst) const;
-
     bool bidirectional;
-    std::vector<std::tuple<int, int, double>> faulty_links;
 };
 
 }  // namespace NetworkAnalyticalCongestionAware
@@ -5,8 +5,8 @@ LICENSE file in the root directory of this source tree.
 
 #pragma once
 
+#include "common/MultiDimAddress.h"
 #include "common/Type.h"
-#include <unordered_map>
 #include <vector>
 
 using namespace NetworkAnalytical;
@@ -35,24 +35,26 @@ class SwitchTranslationUnit final {
      */
     [[nodiscard]] DeviceId translate_address_to_id(const MultiDimAddress& address) const noexcept;
 
-  private:
-    /** Translates a partial address to an offset.
+    /** Get the device ID of the first switch of a switch dimension.
+     * Switches of the dimension take consecutive IDs, one per each combination of the higher-dimension addresses.
      *
-     * @param partial_address The partial address.
-     * @param partial_npus_count_per_dim The number of NPUs per dimension for the partial address.
-     * @return The offset.
+     * @param dim The switch dimension.
+     * @return The device ID of the switch whose higher-dimension addresses are all 0.
      */
-    [[nodiscard]] DeviceId translate_partial_address_to_offset(
-        const MultiDimAddress& partial_address, const std::vector<int>& partial_npus_count_per_dim) const noexcept;
+    [[nodiscard]] DeviceId get_first_switch_id(int dim) const noexcept;
 
+  private:
     /// Total number of NPUs connected to the switch.
     const int m_total_npus_count;
     /// BasicTopology instances per dimension.
     const std::vector<int> m_npus_count_per_dim;
     /// indicates which dimensions are switches.
     const std::vector<bool> m_is_switch_dim;
-    /// map of address length to starting offset of such switches
-    std::unordered_map<int, int> m_switch_length_number_mapping;
+    /// device ID of the first switch of each switch dimension, -1 for other dimensions
+    std::vector<DeviceId> m_first_switch_id_per_dim;
+    /// stride of each higher dimension among the switches of each switch dimension,
+    /// flattened as [switch_dim * dims_count + dim]
+    std::vector<DeviceId> m_switch_strides;
 };
 
 }  // namespace NetworkAnalyticalCongestionAware
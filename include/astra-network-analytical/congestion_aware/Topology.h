@@ -8,7 +8,12 @@ LICENSE file in the root directory of this source tree.
 #include "common/EventQueue.h"
 #include "congestion_aware/Chunk.h"
 #include "congestion_aware/Device.h"
+#include "congestion_aware/LinkStats.h"
+#include <functional>
 #include <memory>
+#include <ostream>
+#include <tuple>
+#include <unordered_map>
 #include <vector>
 
 using namespace NetworkAnalytical;
@@ -46,6 +51,31 @@ class Topology {
      */
     [[nodiscard]] virtual Route route(DeviceId src, DeviceId dest) const noexcept = 0;
 
+    /**
+     * Construct the fastest route from any device to another around the faulty links,
+     * i.e., the path minimizing the sum of 1 / (bandwidth * health) over its links, skipping dead links.
+     * Used for the routes crossing a faulty link, and to steer chunks whose route crosses a link that died.
+     * Routes are cached per (src, dest) pair, and a health change only drops the cached routes it may change:
+     * those crossing a degraded link, or all of them once a link improves.
+     *
+     * @param src src device id
+     * @param dest dest device id
+     * @return route from src to dest, empty if dest can't be reached
+     */
+    [[nodiscard]] Route reroute(DeviceId src, DeviceId dest) const noexcept;
+
+    /**
+     * Construct the set of routes from src to dest chunks can be striped over, starting with route(src, dest).
+     * Topologies offering several paths between two NPUs override it, others only return route(src, dest).
+     *
+     * e.g., routes(0, 4) of an 8-NPU bidirectional ring = [[0, 1, 2, 3, 4], [0, 7, 6, 5, 4]]
+     *
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @return routes from src NPU to dest NPU, never empty
+     */
+    [[nodiscard]] virtual std::vector<Route> routes(DeviceId src, DeviceId dest) const noexcept;
+
     /**
      * Initiate a transmission of a chunk.
      *
@@ -90,6 +120,175 @@ class Topology {
      */
     [[nodiscard]] std::vector<Bandwidth> get_bandwidth_per_dim() const noexcept;
 
+    /**
+     * Get the number of links in the topology, whether materialized or not.
+     *
+     * @return number of links in the topology
+     */
+    [[nodiscard]] int get_links_count() const noexcept;
+
+    /**
+     * Get the number of links whose Link object is materialized.
+     * Equals get_links_count() unless the links are lazy.
+     *
+     * @return number of materialized links in the topology
+     */
+    [[nodiscard]] int get_materialized_links_count() const noexcept;
+
+    /**
+     * Set whether the Link objects of the topology are only materialized
+     * the first time a chunk is sent through them, saving the memory of the unused links.
+     * Must be invoked before any traffic.
+     *
+     * @param lazy_links true to materialize links lazily, false to materialize every link up front
+     */
+    void set_lazy_links(bool lazy_links) noexcept;
+
+    /**
+     * Get the traffic counters of the link src -> dest.
+     *
+     * @param src src device id
+     * @param dest dest device id
+     * @return traffic counters of the link
+     */
+    [[nodiscard]] const LinkStats& get_link_stats(DeviceId src, DeviceId dest) const noexcept;
+
+    /**
+     * Dump the traffic counters of every link in CSV format.
+     *
+     * @param os output stream to write to
+     * @param elapsed_time simulated time used to compute link utilization, in ns
+     */
+    void dump_link_stats_csv(std::ostream& os, EventTime elapsed_time) const noexcept;
+
+    /**
+     * Dump the traffic counters of every link in JSON format.
+     *
+     * @param os output stream to write to
+     * @param elapsed_time simulated time used to compute link utilization, in ns
+     */
+    void dump_link_stats_json(std::ostream& os, EventTime elapsed_time) const noexcept;
+
+    /**
+     * Apply piecewise-constant bandwidth schedules to the links of the topology.
+     * Like faulty_links, each step applies to both src -> dst and dst -> src links if they exist.
+     *
+     * @param bandwidth_schedule list of (src, dst, time in ns, bandwidth scale) steps
+     */
+    void apply_bandwidth_schedule(
+        const std::vector<std::tuple<int, int, EventTime, double>>& bandwidth_schedule) noexcept;
+
+    /**
+     * Change the health of the link between two devices at a simulated time,
+     * i.e., the fraction of its nominal bandwidth left, overriding its faulty_links entry.
+     * Health 0 fails the link, 1 restores it, and a value in between derates it.
+     * Like faulty_links, the change applies to both src -> dst and dst -> src links if they exist.
+     * Transmissions overlapping a future change are timed with it, see Link::add_health_step().
+     * Routes constructed from then on see the new health, and the chunks queued on a link that died
+     * are rerouted from their current device, or wait for the link to be restored if no route is left.
+     *
+     * @param src src device id
+     * @param dest dest device id
+     * @param time time the change takes effect in ns, applied right away if not in the future
+     * @param health fraction of the nominal bandwidth left
+     */
+    void set_link_health(DeviceId src, DeviceId dest, EventTime time, double health) noexcept;
+
+    /**
+     * Schedule the health changes of the links of the topology, see set_link_health().
+     *
+     * @param link_health_schedule list of (src, dst, time in ns, health) changes
+     */
+    void apply_link_health_schedule(
+        const std::vector<std::tuple<int, int, EventTime, double>>& link_health_schedule) noexcept;
+
+    /**
+     * Bound every input buffer of the topology, enabling lossless credit-based flow control.
+     * A link can only start transmitting a chunk when the downstream input buffer has room for it.
+     * The buffers of a Ring depend on each other cyclically, so traffic going around it, e.g., an all-to-all,
+     * needs buffers large enough for it or deadlocks, which is reported once no event is left.
+     *
+     * @param buffer_size size of each input buffer in bytes
+     */
+    void set_input_buffer_size(ChunkSize buffer_size) noexcept;
+
+    /**
+     * Split every link of the topology into multiple virtual channels.
+     * A chunk travels on the virtual channel matching its traffic class,
+     * and each channel has its own pending queue and input buffer.
+     *
+     * @param vcs_count number of virtual channels per link
+     * @param arbitration arbitration policy among the virtual channels
+     * @param weights number of chunks each channel sends per turn, used by WeightedRoundRobin only
+     */
+    void set_virtual_channels(int vcs_count,
+                              VirtualChannelArbitration arbitration,
+                              const std::vector<int>& weights) noexcept;
+
+    /**
+     * Make every switch of the topology forward chunks through a contended crossbar,
+     * instead of an ideal fabric with unlimited internal bandwidth.
+     *
+     * @param queueing queueing discipline of the crossbars
+     * @param arbitration arbitration policy of input-queued crossbars
+     * @param speedup bandwidth of each crossbar port relative to its egress link
+     */
+    void set_switch_model(SwitchQueueing queueing, SwitchArbitration arbitration, double speedup) noexcept;
+
+    /**
+     * Give every NPU of the topology a network interface limiting its injection and ejection,
+     * instead of letting it use all of its links at full rate at once.
+     *
+     * @param injection_bandwidth aggregate injection bandwidth per NPU in GB/s, 0 if unlimited
+     * @param ejection_bandwidth aggregate ejection bandwidth per NPU in GB/s, 0 if unlimited
+     * @param dma_engines number of DMA engines per NPU
+     * @param scheduling order in which waiting chunks take a free DMA engine
+     */
+    void set_network_interfaces(Bandwidth injection_bandwidth,
+                                Bandwidth ejection_bandwidth,
+                                int dma_engines,
+                                NicScheduling scheduling) noexcept;
+
+    /**
+     * Make the links of the topology randomly corrupt chunks, which are then retransmitted.
+     * Like faulty_links, each per-link rate applies to both src -> dst and dst -> src links if they exist.
+     *
+     * @param bit_error_rate probability of a corrupted bit on every link
+     * @param packet_error_rate probability of a corrupted chunk on every link
+     * @param link_error_rates per-link packet error rates overriding packet_error_rate, (src, dst, rate)
+     * @param retransmission retransmission protocol of corrupted chunks
+     * @param window number of chunks a GoBackN sender can have in flight
+     * @param seed seed of the random streams, each link drawing from its own stream
+     */
+    void set_link_errors(double bit_error_rate,
+                         double packet_error_rate,
+                         const std::vector<std::tuple<int, int, double>>& link_error_rates,
+                         Retransmission retransmission,
+                         int window,
+                         uint64_t seed) noexcept;
+
+    /**
+     * Make every switch of the topology reduce the chunks tagged with a reduction group.
+     *
+     * @param throughput reduction throughput of each switch in GB/s, 0 if reductions take no time
+     */
+    void set_in_network_reduction(Bandwidth throughput) noexcept;
+
+    /**
+     * Set how the chunks an NPU sends are spread over routes(src, dest).
+     * Each chunk sent from an NPU then leaves along the route picked by the policy,
+     * instead of the route it was created with.
+     *
+     * Hash keeps every chunk of a (src, dest, traffic class) flow on one route,
+     * RoundRobin takes the routes in turn, and BandwidthWeighted takes them in proportion to
+     * the bandwidth of their slowest link.
+     * The routes of each (src, dest) pair are built when it first stripes a chunk,
+     * and again after a link health change.
+     *
+     * @param striping striping policy, None to keep the route each chunk was created with
+     */
+    void set_striping(StripingPolicy striping) noexcept;
+
   protected:
     /// number of total devices in the topology
     /// device includes non-NPU devices such as switches
@@ -106,16 +305,95 @@ class Topology {
     std::vector<int> npus_count_per_dim;
 
     /// holds the entire device instances in the topology
-    std::vector<std::shared_ptr<Device>> devices;
+    /// an implicit topology leaves each entry nullptr until the device is first accessed through device()
+    mutable std::vector<std::shared_ptr<Device>> devices;
 
     /// bandwidth per each network dimension
     std::vector<Bandwidth> bandwidth_per_dim;
 
+    /// every link of the topology, along with its traffic counters
+    std::shared_ptr<LinkTable> link_table;
+
+    /// health of the faulty links, nullptr if no link is faulty
+    std::shared_ptr<const FaultMap> fault_map;
+
+    /// setup of a device, applied to it once materialized
+    using DeviceSetup = std::function<void(Device&)>;
+
+    /**
+     * Get a device, materializing it if the topology is implicit and the device was never accessed.
+     *
+     * @param device_id id of the device
+     * @return the device
+     */
+    [[nodiscard]] const std::shared_ptr<Device>& device(DeviceId device_id) const noexcept;
+
+    /**
+     * Set up a range of consecutive devices, now for those materialized, and for the others once materialized.
+     *
+     * @param first_device_id id of the first device of the range
+     * @param count number of devices in the range
+     * @param setup setup to apply to each device
+     */
+    void setup_devices(DeviceId first_device_id, int count, const DeviceSetup& setup) noexcept;
+
+    /**
+     * Get the output ports of a device of an implicit topology, without materializing it.
+     * Used to attach the ports of a device once it gets materialized, and to search routes over the others.
+     * Topologies instantiating every device up front never leave one to be materialized.
+     *
+     * @param device_id id of the device
+     * @param ports filled with the (connected device id, link id) of each output port, sorted by device id
+     */
+    virtual void get_implicit_ports(DeviceId device_id, std::vector<std::pair<DeviceId, LinkId>>& ports) const noexcept;
+
     /**
      * Instantiate Device objects in the topology.
      */
     void instantiate_devices() noexcept;
 
+    /**
+     * Set the faulty links of the topology.
+     * Must be invoked before any link is connected.
+     *
+     * @param fault_map health of the faulty links, nullptr if no link is faulty
+     */
+    void set_fault_map(std::shared_ptr<const FaultMap> fault_map) noexcept;
+
+    /**
+     * Get the health of the link between two devices,
+     * i.e., the fraction of its bandwidth left, as last changed by set_link_health() if ever.
+     *
+     * @param src src device id
+     * @param dest dest device id
+     * @return health of the link, 0 if dead and 1 if not faulty
+     */
+    [[nodiscard]] double fault_derate(DeviceId src, DeviceId dest) const noexcept;
+
+    /**
+     * Check whether any link may be faulty, i.e., faulty_links were given or a link health changed at runtime.
+     *
+     * @return true if any link may be faulty, false if every link is healthy
+     */
+    [[nodiscard]] bool has_faults() const noexcept;
+
+    /**
+     * Get the time a route takes to serialize a byte over each of its links, as weighted by reroute().
+     *
+     * @param route route to be measured
+     * @return sum of 1 / (bandwidth * health) over the links of the route in ns, infinity if a link is dead
+     */
+    [[nodiscard]] double route_time_per_byte(const Route& route) const noexcept;
+
+    /**
+     * Scramble a value with the splitmix64 finalizer,
+     * so that close values, e.g., consecutive device ids, spread evenly modulo a small count.
+     *
+     * @param value value to be scrambled
+     * @return scrambled value
+     */
+    [[nodiscard]] static uint64_t scramble(uint64_t value) noexcept;
+
     /**
      * Connect src -> dest with the given bandwidth and latency.
      * (i.e., a `Link` gets constructed between the two npus)
@@ -130,7 +408,178 @@ class Topology {
      */
     void connect(DeviceId src, DeviceId dest, Bandwidth bandwidth, Latency latency, bool bidirectional = true) noexcept;
 
-    void bus_connect(DeviceId src, DeviceId dest, Bandwidth bandwidth, Latency latency, bool bidirectional = true) noexcept;
+    /**
+     * Attach the given devices to a single shared-medium link with the given bandwidth and latency.
+     * (i.e., only one `Link` gets constructed, and every device reaches every other device through it)
+     * Chunks of all attached devices contend for the link at one arbitration point.
+     *
+     * @param device_ids ids of the devices attached to the medium
+     * @param bandwidth bandwidth of the medium
+     * @param latency latency of the medium
+     * @param arbitration arbitration policy among the attached devices
+     */
+    void shared_medium_connect(const std::vector<DeviceId>& device_ids,
+                               Bandwidth bandwidth,
+                               Latency latency,
+                               BusArbitration arbitration) noexcept;
+
+  private:
+    /// event queue Topology uses to schedule link health changes
+    static std::shared_ptr<EventQueue> event_queue;
+
+    /**
+     * LinkHealthChange is a health change of a link waiting for its time.
+     */
+    struct LinkHealthChange {
+        /// topology holding the link
+        Topology* topology;
+
+        /// src device id
+        DeviceId src;
+
+        /// dest device id
+        DeviceId dest;
+
+        /// fraction of the nominal bandwidth left
+        double health;
+    };
+
+    /**
+     * Callback to be called when a link health change takes effect.
+     *
+     * @param change_ptr pointer to the LinkHealthChange, deleted once applied
+     */
+    static void link_health_changed(void* change_ptr) noexcept;
+
+    /**
+     * Apply a health change to the links between two devices,
+     * rerouting the chunks queued on a link that died.
+     *
+     * @param src src device id
+     * @param dest dest device id
+     * @param health fraction of the nominal bandwidth left
+     */
+    void change_link_health(DeviceId src, DeviceId dest, double health) noexcept;
+
+    /**
+     * Get the links between two devices, src -> dest then dest -> src, once if both directions share a link.
+     *
+     * @param src src device id
+     * @param dest dest device id
+     * @return ids of the links between src and dest, empty if they aren't connected
+     */
+    [[nodiscard]] std::vector<LinkId> links_between(DeviceId src, DeviceId dest) const noexcept;
+
+    /**
+     * Get the health a link between two devices is set to, relative to the bandwidth it was constructed with.
+     *
+     * @param src src device id
+     * @param dest dest device id
+     * @param health fraction of the nominal bandwidth left
+     * @return fraction of the constructed bandwidth left
+     */
+    [[nodiscard]] double link_health_scale(DeviceId src, DeviceId dest, double health) const noexcept;
+
+    /// health of each link changed at runtime, keyed like FaultMap, overriding the faulty links
+    std::unordered_map<uint64_t, double> link_health;
+
+    /// routes built by reroute(), as device ids, keyed by (src << 32 | dest)
+    mutable std::unordered_map<uint64_t, std::vector<DeviceId>> cached_routes;
+
+    /// keys of the cached routes crossing each link
+    /// may list routes already dropped, which only costs recomputing them
+    mutable std::unordered_map<LinkId, std::vector<uint64_t>> cached_routes_per_link;
+
+    /**
+     * RerouteScratch is the state of the shortest-path search of reroute(),
+     * allocated once and reset after each search, so cache misses don't allocate.
+     */
+    struct RerouteScratch {
+        /// time to serialize a byte from src per each device, infinity if not reached
+        std::vector<double> time_per_byte;
+
+        /// previous device on the fastest path per each device
+        std::vector<DeviceId> reached_from;
+
+        /// link from the previous device on the fastest path per each device
+        std::vector<LinkId> reached_through;
+
+        /// devices reached by the search, whose entries are reset once done
+        std::vector<DeviceId> reached_devices;
+
+        /// (time per byte, device id) of the devices left to visit, as a min-heap
+        std::vector<std::pair<double, DeviceId>> frontier;
+
+        /// output ports of the visited device if not materialized
+        std::vector<std::pair<DeviceId, LinkId>> implicit_ports;
+    };
+
+    /// state of the shortest-path search of reroute()
+    mutable RerouteScratch reroute_scratch;
+
+    /**
+     * Drop the cached routes a link health change may affect, including the routes chunks are striped over.
+     *
+     * @param link_id id of the changed link
+     * @param old_health health of the link before the change
+     * @param new_health health of the link after the change
+     */
+    void invalidate_cached_routes(LinkId link_id, double old_health, double new_health) noexcept;
+
+    /// how the chunks an NPU sends are spread over the routes to their dest
+    StripingPolicy striping;
+
+    /**
+     * StripingState is the striping progress of a (src, dest) pair.
+     */
+    struct StripingState {
+        /// routes(src, dest) the chunks are striped over, empty until built or once link health changes
+        std::vector<Route> routes;
+
+        /// bandwidth of the slowest link of each route, used by BandwidthWeighted
+        std::vector<double> weights;
+
+        /// sum of the weights
+        double total_weight;
+
+        /// number of chunks striped so far, used by RoundRobin
+        uint64_t chunks_count;
+
+        /// smooth weighted round-robin credit of each route, used by BandwidthWeighted
+        std::vector<double> credits;
+    };
+
+    /// striping progress per each (src, dest) pair, keyed by (src << 32 | dest)
+    std::unordered_map<uint64_t, StripingState> striping_states;
+
+    /// keys of the striping states whose routes cross each link
+    /// may list routes already dropped, which only costs rebuilding them
+    std::unordered_map<LinkId, std::vector<uint64_t>> striping_states_per_link;
+
+    /**
+     * Move a chunk about to leave its src NPU onto the route the striping policy picks among routes(src, dest).
+     *
+     * @param chunk chunk to be striped
+     */
+    void stripe(Chunk& chunk) noexcept;
+
+    /**
+     * Get the bandwidth of the slowest link of a route, with link health applied.
+     *
+     * @param route route to be measured
+     * @return bandwidth of the slowest link in B/ns, 0 if a link is dead
+     */
+    [[nodiscard]] double bottleneck_bandwidth(const Route& route) const noexcept;
+
+    /// setup recorded for a range of devices [first_device_id, end_device_id)
+    struct RecordedDeviceSetup {
+        DeviceId first_device_id;
+        DeviceId end_device_id;
+        DeviceSetup setup;
+    };
+
+    /// setups of the devices, in the order they were requested
+    std::vector<RecordedDeviceSetup> device_setups;
 };
 
 }  // namespace NetworkAnalyticalCongestionAware
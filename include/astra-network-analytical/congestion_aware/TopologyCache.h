@@ -0,0 +1,182 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/Type.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * TopologyCache is a compiled topology, i.e., the links and the device ports built by MultiDimTopology,
+ * stored in a versioned binary file so constructing the same topology again skips building its connections.
+ * The file is keyed by a hash of the config it was compiled from, and mapped read-only once loaded,
+ * so processes loading the same topology share its pages.
+ *
+ * The file holds a header followed by the arrays of CompiledTopology, each aligned to 8 bytes.
+ */
+class TopologyCache {
+  public:
+    /// version of the file format, bumped whenever the format or the link numbering changes
+    static constexpr uint32_t format_version = 2;
+
+    /// arrays of a compiled topology, pointing into the mapped file once loaded
+    struct CompiledTopology {
+        /// number of network dimensions
+        int dims_count;
+
+        /// number of devices, NPUs followed by switches
+        int devices_count;
+
+        /// number of links
+        int links_count;
+
+        /// total number of output ports of the devices
+        int64_t ports_count;
+
+        /// id of the first link of each dimension, followed by links_count
+        const LinkId* first_link_per_dim;
+
+        /// src device id per each link, -1 for a shared-medium link
+        const DeviceId* link_srcs;
+
+        /// dest device id per each link, -1 for a shared-medium link
+        const DeviceId* link_dests;
+
+        /// bandwidth in B/ns per each link, with link faults applied
+        const Bandwidth* link_bandwidths_Bpns;
+
+        /// latency in ns per each link
+        const Latency* link_latencies;
+
+        /// index of the first port of each device in port_dests and port_links, followed by ports_count
+        const int64_t* port_offsets;
+
+        /// id of the connected device per each port, sorted within each device
+        const DeviceId* port_dests;
+
+        /// link of each port
+        const LinkId* port_links;
+    };
+
+    /**
+     * Get the path of the cached topology compiled from a config.
+     *
+     * @param cache_directory directory holding the compiled topologies
+     * @param topology_hash hash of the config
+     * @return path of the compiled topology
+     */
+    [[nodiscard]] static std::string get_path(const std::string& cache_directory, uint64_t topology_hash) noexcept;
+
+    /**
+     * Map a compiled topology.
+     *
+     * @param path path of the compiled topology
+     * @param topology_hash hash of the config the topology must be compiled from
+     * @return the mapped topology, nullptr if missing, corrupted, or compiled from another config or format version
+     */
+    [[nodiscard]] static std::unique_ptr<TopologyCache> load(const std::string& path, uint64_t topology_hash) noexcept;
+
+    /**
+     * Write a compiled topology.
+     * The file is written aside and then renamed, so concurrent jobs never map a partial file.
+     *
+     * @param path path of the compiled topology
+     * @param topology_hash hash of the config the topology is compiled from
+     * @param compiled_topology arrays of the compiled topology
+     * @return true if written, false otherwise
+     */
+    static bool save(const std::string& path, uint64_t topology_hash, const CompiledTopology& compiled_topology) noexcept;
+
+    /**
+     * Destructor, unmapping the file.
+     */
+    ~TopologyCache() noexcept;
+
+    TopologyCache(const TopologyCache&) = delete;
+    TopologyCache& operator=(const TopologyCache&) = delete;
+
+    /**
+     * Get the arrays of the compiled topology.
+     *
+     * @return arrays of the compiled topology, valid as long as this cache exists
+     */
+    [[nodiscard]] const CompiledTopology& get_compiled_topology() const noexcept;
+
+  private:
+    /// header of the file
+    struct FileHeader {
+        /// identifies a compiled topology
+        char magic[8];
+
+        /// version of the file format
+        uint32_t version;
+
+        /// number of network dimensions
+        uint32_t dims_count;
+
+        /// hash of the config the topology is compiled from
+        uint64_t topology_hash;
+
+        /// number of devices
+        uint64_t devices_count;
+
+        /// number of links
+        uint64_t links_count;
+
+        /// total number of output ports of the devices
+        uint64_t ports_count;
+    };
+
+    /// offset in bytes of each array in the file, and the file size
+    struct FileLayout {
+        size_t first_link_per_dim;
+        size_t link_srcs;
+        size_t link_dests;
+        size_t link_bandwidths_Bpns;
+        size_t link_latencies;
+        size_t port_offsets;
+        size_t port_dests;
+        size_t port_links;
+        size_t file_size;
+    };
+
+    /// identifies a compiled topology
+    static constexpr char file_magic[8] = {'A', 'N', 'T', 'O', 'P', 'O', '\0', '\0'};
+
+    /**
+     * Lay out the arrays of a compiled topology after the header, each aligned to 8 bytes.
+     *
+     * @param header header of the file
+     * @return offset of each array, and the file size
+     */
+    [[nodiscard]] static FileLayout get_layout(const FileHeader& header) noexcept;
+
+    /**
+     * Constructor.
+     *
+     * @param mapping start of the mapped file
+     * @param mapping_size size of the mapped file in bytes
+     * @param compiled_topology arrays of the compiled topology, pointing into the mapping
+     */
+    TopologyCache(void* mapping, size_t mapping_size, CompiledTopology compiled_topology) noexcept;
+
+    /// start of the mapped file
+    void* mapping;
+
+    /// size of the mapped file in bytes
+    size_t mapping_size;
+
+    /// arrays of the compiled topology, pointing into the mapping
+    CompiledTopology compiled_topology;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
@@ -32,14 +32,14 @@ class Torus2D final : public BasicTopology {
    * @param latency    link latency
    * @param bidirectional true if torus is bidirectional
    * @param is_multi_dim  true if part of multidimensional topology
-   * @param faulty_links  list of faulty links as tuples (src, dst, weight)
+   * @param fault_map health of the faulty links, nullptr if no link is faulty
    */
   Torus2D(int npus_count,
           Bandwidth bandwidth,
           Latency latency,
           bool bidirectional = true,
           bool is_multi_dim = false,
-          const std::vector<std::tuple<int, int, double>>& faulty_links = {}) noexcept;
+          std::shared_ptr<const FaultMap> fault_map = nullptr) noexcept;
 
   /**
    * Alternate constructor for convenience (used by Helper.cpp)
@@ -47,25 +47,38 @@ class Torus2D final : public BasicTopology {
   Torus2D(int npus_count,
           Bandwidth bandwidth,
           Latency latency,
-          const std::vector<std::tuple<int, int, double>>& faulty_links) noexcept
-      : Torus2D(npus_count, bandwidth, latency, true, false, faulty_links) {}
+          std::shared_ptr<const FaultMap> fault_map) noexcept
+      : Torus2D(npus_count, bandwidth, latency, true, false, std::move(fault_map)) {}
 
   /**
    * Implementation of route function in Topology.
    */
   [[nodiscard]] Route route(DeviceId src, DeviceId dest) const noexcept override;
 
+  /**
+   * Implementation of routes function in Topology.
+   * The X-first and the Y-first routes, if src and dest differ in both coordinates.
+   */
+  [[nodiscard]] std::vector<Route> routes(DeviceId src, DeviceId dest) const noexcept override;
+
   /**
    * Get connection policies of the torus topology.
    */
   [[nodiscard]] std::vector<ConnectionPolicy> get_connection_policies() const noexcept override;
 
  private:
-  //bool is_down(int src, int dst) const;
-  double fault_derate(int src, int dst) const;
+  /**
+   * Construct the route from src to dest traversing one coordinate after the other.
+   *
+   * @param src src NPU id
+   * @param dest dest NPU id
+   * @param x_first true to traverse X then Y, false to traverse Y then X
+   * @return route from src NPU to dest NPU
+   */
+  [[nodiscard]] Route dimension_order_route(DeviceId src, DeviceId dest, bool x_first) const noexcept;
 
+  //bool is_down(int src, int dst) const;
   bool bidirectional;
-  std::vector<std::tuple<int, int, double>> faulty_links;
 };
 
 }  // namespace NetworkAnalyticalCongestionAware
@@ -5,6 +5,7 @@ LICENSE file in the root directory of this source tree.
 
 #pragma once
 
+#include <cstdint>
 #include <list>
 #include <memory>
 
@@ -14,8 +15,17 @@ namespace NetworkAnalyticalCongestionAware {
 class Chunk;
 class Link;
 class Device;
+class Crossbar;
+class NetworkInterface;
+class ReductionEngine;
+class LinkStatsTable;
+class LinkTable;
+class FaultMap;
 
 /// Route is a list of devices
 using Route = std::list<std::shared_ptr<Device>>;
 
+/// Link ID which starts from 0, unique within a topology
+using LinkId = uint32_t;
+
 }  // namespace NetworkAnalyticalCongestionAware
@@ -5,6 +5,8 @@ LICENSE file in the root directory of this source tree.
 
 #pragma once
 
+#include "common/AddressTranslator.h"
+#include "common/MultiDimAddress.h"
 #include "common/Type.h"
 #include "congestion_unaware/BasicTopology.h"
 #include "congestion_unaware/Topology.h"
@@ -41,6 +43,9 @@ class MultiDimTopology : public Topology {
     /// BasicTopology instances per dimension.
     std::vector<std::unique_ptr<BasicTopology>> topology_per_dim;
 
+    /// translates NPU IDs to multi-dimensional addresses
+    AddressTranslator address_translator;
+
     /**
      * Translate the NPU ID into a multi-dimensional address.
      *
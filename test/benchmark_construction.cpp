@@ -0,0 +1,70 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/EventQueue.h"
+#include "common/NetworkParser.h"
+#include "congestion_aware/Chunk.h"
+#include "congestion_aware/Helper.h"
+#include <chrono>
+#include <iostream>
+#include <sys/resource.h>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+/**
+ * Measure how long constructing a topology takes, and the peak memory it needs.
+ * Then run one ring step over all NPUs, reporting how many links got materialized.
+ *
+ * usage: BenchmarkAnalyticalCongestionAware <network config yml>
+ */
+int main(const int argc, char* argv[]) {
+    if (argc != 2) {
+        std::cerr << "usage: " << argv[0] << " <network config yml>" << std::endl;
+        return 1;
+    }
+
+    // set event queue
+    const auto event_queue = std::make_shared<EventQueue>();
+    Topology::set_event_queue(event_queue);
+
+    // parse the network config and construct the topology
+    const auto network_parser = NetworkParser(argv[1]);
+    const auto start = std::chrono::steady_clock::now();
+    const auto topology = construct_topology(network_parser);
+    const auto end = std::chrono::steady_clock::now();
+
+    // peak resident set size, reported in KB by Linux
+    auto usage = rusage();
+    getrusage(RUSAGE_SELF, &usage);
+
+    const auto construction_ms = std::chrono::duration<double, std::milli>(end - start).count();
+    std::cout << "npus: " << topology->get_npus_count() << std::endl;
+    std::cout << "devices: " << topology->get_devices_count() << std::endl;
+    std::cout << "links: " << topology->get_links_count() << std::endl;
+    std::cout << "construction time: " << construction_ms << " ms" << std::endl;
+    std::cout << "peak RSS: " << usage.ru_maxrss / 1024 << " MB" << std::endl;
+
+    // one ring step, each NPU sending a chunk to the next one
+    const auto npus_count = topology->get_npus_count();
+    for (auto src = 0; src < npus_count; src++) {
+        auto route = topology->route(src, (src + 1) % npus_count);
+        auto chunk = std::make_unique<Chunk>(1'048'576, route, [](void* const) {}, nullptr);
+        topology->send(std::move(chunk));
+    }
+    while (!event_queue->finished()) {
+        event_queue->proceed();
+    }
+
+    // links a lazy topology had to materialize, out of all potential ones
+    std::cout << "materialized links: " << topology->get_materialized_links_count() << " / "
+              << topology->get_links_count() << std::endl;
+
+    // including the devices and links materialized by the traffic
+    getrusage(RUSAGE_SELF, &usage);
+    std::cout << "peak RSS after ring step: " << usage.ru_maxrss / 1024 << " MB" << std::endl;
+
+    return 0;
+}
@@ -4,11 +4,19 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "common/EventQueue.h"
+#include "common/NetworkFunction.h"
 #include "common/NetworkParser.h"
 #include "common/Type.h"
 #include "congestion_aware/Chunk.h"
 #include "congestion_aware/Helper.h"
+#include "congestion_aware/MultiDimTopology.h"
+#include "congestion_aware/TopologyCache.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
 #include <gtest/gtest.h>
+#include <set>
+#include <sstream>
 
 using namespace NetworkAnalytical;
 using namespace NetworkAnalyticalCongestionAware;
@@ -28,6 +36,36 @@ class TestNetworkAnalyticalCongestionAware : public ::testing::Test {
 
     static void callback(void* const arg) {}
 
+    // records the time a chunk arrived, arg is (event queue, arrival time)
+    static void record_arrival_time(void* const arg) {
+        auto* const record = static_cast<std::pair<EventQueue*, EventTime>*>(arg);
+        record->second = record->first->get_current_time();
+    }
+
+    // time a link of the given bandwidth (GB/s) takes to serialize a chunk, in ns, truncated as by the links
+    static EventTime serialization_time(const ChunkSize size, const Bandwidth bandwidth) {
+        return static_cast<EventTime>(static_cast<double>(size) / bw_GBps_to_Bpns(bandwidth));
+    }
+
+    // runs one ring step on a fresh event queue, each NPU sending a chunk to the next one, returns the completion time
+    EventTime simulate_ring_step(Topology& topology) {
+        event_queue = std::make_shared<EventQueue>();
+        Topology::set_event_queue(event_queue);
+
+        const auto npus_count = topology.get_npus_count();
+        for (int src = 0; src < npus_count; src++) {
+            auto route = topology.route(src, (src + 1) % npus_count);
+            auto chunk = std::make_unique<Chunk>(chunk_size, route, callback, nullptr);
+            topology.send(std::move(chunk));
+        }
+
+        while (!event_queue->finished()) {
+            event_queue->proceed();
+        }
+
+        return event_queue->get_current_time();
+    }
+
     ChunkSize chunk_size;
 };
 
@@ -132,3 +170,1011 @@ TEST_F(TestNetworkAnalyticalCongestionAware, AllGatherOnRing) {
     const auto simulation_time = event_queue->get_current_time();
     EXPECT_EQ(simulation_time, 704'116);
 }
+
+TEST_F(TestNetworkAnalyticalCongestionAware, LinkStats) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/FullyConnected.yml");
+    const auto topology = construct_topology(network_parser);
+    const auto npus_count = topology->get_npus_count();
+    const auto serialization = serialization_time(chunk_size, network_parser.get_bandwidths_per_dim()[0]);
+
+    /// send two chunks over the same link
+    for (int i = 0; i < 2; i++) {
+        auto route = topology->route(1, 4);
+        auto chunk = std::make_unique<Chunk>(chunk_size, route, callback, nullptr);
+        topology->send(std::move(chunk));
+    }
+
+    /// Run simulation
+    while (!event_queue->finished()) {
+        event_queue->proceed();
+    }
+
+    /// test
+    EXPECT_EQ(topology->get_links_count(), npus_count * (npus_count - 1));
+
+    // the link serializes both chunks back to back, the second one waiting for the first one
+    const auto& link_stats = topology->get_link_stats(1, 4);
+    EXPECT_EQ(link_stats.bytes_sent, 2 * chunk_size);
+    EXPECT_EQ(link_stats.chunks_sent, 2);
+    EXPECT_EQ(link_stats.busy_time, 2 * serialization);
+    EXPECT_EQ(link_stats.queueing_time, serialization);
+    EXPECT_EQ(link_stats.max_pending_chunks, 1);
+    EXPECT_EQ(link_stats.last_idle_time, link_stats.busy_time);
+
+    const auto& idle_link_stats = topology->get_link_stats(4, 1);
+    EXPECT_EQ(idle_link_stats.chunks_sent, 0);
+    EXPECT_EQ(idle_link_stats.busy_time, 0);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, BandwidthSchedule) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/FullyConnected_BandwidthSchedule.yml");
+    const auto topology = construct_topology(network_parser);
+    const auto bandwidth = network_parser.get_bandwidths_per_dim()[0];
+    const auto latency = network_parser.get_latencies_per_dim()[0];
+
+    /// message settings
+    auto route = topology->route(0, 1);
+    auto chunk = std::make_unique<Chunk>(chunk_size, route, callback, nullptr);
+
+    // send a chunk, bandwidth halves in the middle of its serialization
+    topology->send(std::move(chunk));
+
+    /// Run simulation
+    while (!event_queue->finished()) {
+        event_queue->proceed();
+    }
+
+    /// test
+    // the bytes left at the step are serialized at half the bandwidth
+    const auto step_time = 10'000.0;
+    const auto bandwidth_Bpns = bw_GBps_to_Bpns(bandwidth);
+    const auto serialization = step_time + (chunk_size - step_time * bandwidth_Bpns) / (bandwidth_Bpns / 2);
+    const auto busy_time = topology->get_link_stats(0, 1).busy_time;
+    EXPECT_EQ(busy_time, static_cast<EventTime>(serialization));
+    EXPECT_GT(busy_time, serialization_time(chunk_size, bandwidth));
+    EXPECT_LT(busy_time, serialization_time(chunk_size, bandwidth / 2));
+
+    const auto simulation_time = event_queue->get_current_time();
+    EXPECT_EQ(simulation_time, static_cast<EventTime>(latency + serialization));
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, IncastWithInputBuffer) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Switch_InputBuffer.yml");
+    const auto topology = construct_topology(network_parser);
+    const auto serialization = serialization_time(chunk_size, network_parser.get_bandwidths_per_dim()[0]);
+    const auto hop_time = static_cast<EventTime>(network_parser.get_latencies_per_dim()[0]) + serialization;
+
+    /// 4-to-1 incast, two chunks per source
+    for (int src = 0; src < 4; src++) {
+        for (int i = 0; i < 2; i++) {
+            auto route = topology->route(src, 4);
+            auto chunk = std::make_unique<Chunk>(chunk_size, route, callback, nullptr);
+            topology->send(std::move(chunk));
+        }
+    }
+
+    /// Run simulation
+    while (!event_queue->finished()) {
+        event_queue->proceed();
+    }
+
+    /// test
+    // each buffer holds one chunk, so the egress link waits for every chunk to arrive before sending the next one,
+    // while unbounded buffers would let it serialize the 8 chunks back to back
+    const auto simulation_time = event_queue->get_current_time();
+    EXPECT_EQ(simulation_time, (1 + 8) * hop_time);
+    EXPECT_GT(simulation_time, 2 * hop_time + 7 * serialization);
+
+    // the second chunk of each source waits until the first one leaves the switch
+    const auto switch_id = topology->get_npus_count();
+    EXPECT_EQ(topology->get_link_stats(0, switch_id).queueing_time, hop_time + serialization);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, RingAllToAllCreditDeadlock) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Ring_InputBuffer.yml");
+    const auto topology = construct_topology(network_parser);
+    const auto npus_count = topology->get_npus_count();
+
+    /// all-to-all, each chunk occupying half of a buffer
+    const auto run_all_to_all = [&]() {
+        for (int src = 0; src < npus_count; src++) {
+            for (int dest = 0; dest < npus_count; dest++) {
+                if (src == dest) {
+                    continue;
+                }
+
+                auto route = topology->route(src, dest);
+                auto chunk = std::make_unique<Chunk>(chunk_size, route, callback, nullptr);
+                topology->send(std::move(chunk));
+            }
+        }
+
+        while (!event_queue->finished()) {
+            event_queue->proceed();
+        }
+    };
+
+    /// test
+    // the buffers around the ring wait on each other, which is reported instead of silently ending the simulation
+    EXPECT_EXIT(run_all_to_all(), ::testing::ExitedWithCode(255), "credit deadlock");
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, VirtualChannelsStrictPriority) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Switch_VirtualChannels.yml");
+    const auto topology = construct_topology(network_parser);
+    const auto serialization = serialization_time(chunk_size, network_parser.get_bandwidths_per_dim()[0]);
+    const auto latency = static_cast<EventTime>(network_parser.get_latencies_per_dim()[0]);
+
+    /// four bulk chunks (class 0) followed by one critical chunk (class 1)
+    for (int i = 0; i < 4; i++) {
+        auto route = topology->route(0, 4);
+        auto chunk = std::make_unique<Chunk>(chunk_size, route, callback, nullptr, /* traffic_class = */ 0);
+        topology->send(std::move(chunk));
+    }
+    auto critical_arrival = std::make_pair(event_queue.get(), EventTime{0});
+    auto route = topology->route(0, 4);
+    auto chunk = std::make_unique<Chunk>(chunk_size, route, record_arrival_time, &critical_arrival,
+                                         /* traffic_class = */ 1);
+    topology->send(std::move(chunk));
+
+    /// Run simulation
+    while (!event_queue->finished()) {
+        event_queue->proceed();
+    }
+
+    /// test
+    // the critical chunk overtakes the three queued bulk chunks at both hops,
+    // only waiting for the bulk chunk already under transmission
+    EXPECT_EQ(critical_arrival.second, 3 * serialization + 2 * latency);
+
+    // arbitration only reorders chunks, the links stay work-conserving
+    const auto simulation_time = event_queue->get_current_time();
+    EXPECT_EQ(simulation_time, (5 + 1) * serialization + 2 * latency);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, BusRoundRobin) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Bus.yml");
+    const auto topology = construct_topology(network_parser);
+    const auto serialization = serialization_time(chunk_size, network_parser.get_bandwidths_per_dim()[0]);
+    const auto latency = static_cast<EventTime>(network_parser.get_latencies_per_dim()[0]);
+
+    // all NPUs share a single link
+    EXPECT_EQ(topology->get_links_count(), 1);
+
+    /// NPU 0 sends three chunks to NPU 2, then NPU 1 sends one chunk to NPU 3
+    for (int i = 0; i < 3; i++) {
+        auto route = topology->route(0, 2);
+        auto chunk = std::make_unique<Chunk>(chunk_size, route, callback, nullptr);
+        topology->send(std::move(chunk));
+    }
+    auto npu1_arrival = std::make_pair(event_queue.get(), EventTime{0});
+    auto route = topology->route(1, 3);
+    auto chunk = std::make_unique<Chunk>(chunk_size, route, record_arrival_time, &npu1_arrival);
+    topology->send(std::move(chunk));
+
+    /// Run simulation
+    while (!event_queue->finished()) {
+        event_queue->proceed();
+    }
+
+    /// test
+    // NPU 1 gets the bus right after the first chunk of NPU 0, instead of after all three
+    EXPECT_EQ(npu1_arrival.second, 2 * serialization + latency);
+
+    // transfers on the bus never overlap
+    const auto simulation_time = event_queue->get_current_time();
+    EXPECT_EQ(simulation_time, 4 * serialization + latency);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, InputQueuedSwitch) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Switch_InputQueued.yml");
+    const auto topology = construct_topology(network_parser);
+    const auto serialization = serialization_time(chunk_size, network_parser.get_bandwidths_per_dim()[0]);
+    const auto latency = static_cast<EventTime>(network_parser.get_latencies_per_dim()[0]);
+
+    /// NPU 0 and NPU 2 send a chunk to NPU 4, NPU 1 sends a chunk to NPU 5
+    auto npu5_arrival = std::make_pair(event_queue.get(), EventTime{0});
+    for (const auto src : {0, 1, 2}) {
+        const auto dest = (src == 1) ? 5 : 4;
+        auto route = topology->route(src, dest);
+        auto chunk = (src == 1) ? std::make_unique<Chunk>(chunk_size, route, record_arrival_time, &npu5_arrival)
+                                : std::make_unique<Chunk>(chunk_size, route, callback, nullptr);
+        topology->send(std::move(chunk));
+    }
+
+    /// Run simulation
+    while (!event_queue->finished()) {
+        event_queue->proceed();
+    }
+
+    /// test
+    // chunks heading to different outputs cross the fabric in parallel,
+    // each serialized on its ingress link, through the crossbar at the link bandwidth, and on its egress link
+    EXPECT_EQ(npu5_arrival.second, 3 * serialization + 2 * latency);
+
+    // the second chunk to NPU 4 waits for the output port, then for the egress link
+    const auto simulation_time = event_queue->get_current_time();
+    EXPECT_EQ(simulation_time, 4 * serialization + 2 * latency);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, NetworkInterfaceInjection) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/FullyConnected_NetworkInterface.yml");
+    const auto topology = construct_topology(network_parser);
+    const auto hop_time = static_cast<EventTime>(network_parser.get_latencies_per_dim()[0]) +
+                          serialization_time(chunk_size, network_parser.get_bandwidths_per_dim()[0]);
+    const auto injection_time = serialization_time(chunk_size, network_parser.get_nic_injection_bandwidth());
+    const auto ejection_time = serialization_time(chunk_size, network_parser.get_nic_ejection_bandwidth());
+
+    /// NPU 0 sends a chunk to each of NPU 1, 2, and 3
+    for (const auto dest : {1, 2, 3}) {
+        auto route = topology->route(0, dest);
+        auto chunk = std::make_unique<Chunk>(chunk_size, route, callback, nullptr);
+        topology->send(std::move(chunk));
+    }
+
+    /// Run simulation
+    while (!event_queue->finished()) {
+        event_queue->proceed();
+    }
+
+    /// test
+    // the single DMA engine reads the chunks one after another, although each has its own link,
+    // then the last chunk crosses its link and is written out at the ejection bandwidth
+    const auto simulation_time = event_queue->get_current_time();
+    EXPECT_EQ(simulation_time, 3 * injection_time + hop_time + ejection_time);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, LinkErrorsSelectiveRepeat) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/FullyConnected_LinkErrors.yml");
+    const auto serialization = serialization_time(chunk_size, network_parser.get_bandwidths_per_dim()[0]);
+    const auto latency = static_cast<EventTime>(network_parser.get_latencies_per_dim()[0]);
+
+    // send eight chunks over the marginal link on a fresh topology, returning (its stats, simulation time)
+    const auto send_over_marginal_link = [this, &network_parser]() {
+        event_queue = std::make_shared<EventQueue>();
+        Topology::set_event_queue(event_queue);
+        const auto topology = construct_topology(network_parser);
+        for (int i = 0; i < 8; i++) {
+            auto route = topology->route(1, 4);
+            auto chunk = std::make_unique<Chunk>(chunk_size, route, callback, nullptr);
+            topology->send(std::move(chunk));
+        }
+
+        /// Run simulation
+        while (!event_queue->finished()) {
+            event_queue->proceed();
+        }
+
+        // other links stay error-free
+        EXPECT_EQ(topology->get_link_stats(1, 5).retransmissions, 0);
+        return std::make_pair(topology->get_link_stats(1, 4), event_queue->get_current_time());
+    };
+    const auto [link_stats, simulation_time] = send_over_marginal_link();
+
+    /// test
+    // each corrupted chunk is serialized once more
+    EXPECT_EQ(link_stats.chunks_sent, 8);
+    EXPECT_GT(link_stats.retransmissions, 0);
+    EXPECT_EQ(link_stats.busy_time, (8 + link_stats.retransmissions) * serialization);
+    EXPECT_EQ(link_stats.bytes_sent, (8 + link_stats.retransmissions) * chunk_size);
+
+    // selective repeat keeps the link busy while waiting for the corruptions to be detected,
+    // so at most each retransmission adds a round trip to the transmissions
+    const auto transmissions_time = (8 + link_stats.retransmissions) * serialization + latency;
+    EXPECT_GE(simulation_time, transmissions_time);
+    EXPECT_LE(simulation_time, transmissions_time + link_stats.retransmissions * 2 * latency);
+
+    // the error stream is seeded, so the run is reproducible
+    const auto [rerun_link_stats, rerun_simulation_time] = send_over_marginal_link();
+    EXPECT_EQ(rerun_link_stats.retransmissions, link_stats.retransmissions);
+    EXPECT_EQ(rerun_simulation_time, simulation_time);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, LinkErrorsBandwidthSchedule) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/FullyConnected_LinkErrors_BandwidthSchedule.yml");
+    const auto topology = construct_topology(network_parser);
+    const auto bandwidth = network_parser.get_bandwidths_per_dim()[0];
+    const auto latency = static_cast<EventTime>(network_parser.get_latencies_per_dim()[0]);
+    const auto round_trip_time = 2 * latency;
+
+    /// send a chunk, its first transmission ending before the bandwidth halves
+    auto route = topology->route(0, 1);
+    auto chunk = std::make_unique<Chunk>(chunk_size, route, callback, nullptr);
+    topology->send(std::move(chunk));
+
+    /// Run simulation
+    while (!event_queue->finished()) {
+        event_queue->proceed();
+    }
+
+    /// test
+    const auto& link_stats = topology->get_link_stats(0, 1);
+    const auto retransmissions = static_cast<EventTime>(link_stats.retransmissions);
+    ASSERT_GT(retransmissions, 0);
+
+    // each retransmission starts a round trip after the previous transmission, past the step,
+    // so it is serialized at half the bandwidth
+    const auto serialization = serialization_time(chunk_size, bandwidth);
+    const auto retransmission_serialization = serialization_time(chunk_size, bandwidth / 2);
+    EXPECT_EQ(link_stats.busy_time, serialization + retransmissions * retransmission_serialization);
+
+    const auto last_transmission_start_time =
+        serialization + round_trip_time + (retransmissions - 1) * (retransmission_serialization + round_trip_time);
+    const auto simulation_time = event_queue->get_current_time();
+    EXPECT_EQ(simulation_time, last_transmission_start_time + latency + retransmission_serialization);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, FaultyLinks) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Ring_FaultyLinks.yml");
+    const auto topology = construct_topology(network_parser);
+    const auto bandwidth = network_parser.get_bandwidths_per_dim()[0];
+
+    /// send a chunk over faulty and healthy links
+    const std::vector<std::pair<int, int>> pairs = {{0, 1}, {1, 0}, {1, 2}, {4, 5}};
+    for (const auto& [src, dest] : pairs) {
+        auto route = topology->route(src, dest);
+        auto chunk = std::make_unique<Chunk>(chunk_size, route, callback, nullptr);
+        topology->send(std::move(chunk));
+    }
+
+    /// Run simulation
+    while (!event_queue->finished()) {
+        event_queue->proceed();
+    }
+
+    /// test
+    // a fault derates both directions of a link, using its first entry
+    EXPECT_EQ(topology->get_link_stats(0, 1).busy_time, serialization_time(chunk_size, bandwidth * 0.5));
+    EXPECT_EQ(topology->get_link_stats(1, 0).busy_time, serialization_time(chunk_size, bandwidth * 0.5));
+    EXPECT_EQ(topology->get_link_stats(4, 5).busy_time, serialization_time(chunk_size, bandwidth * 0.25));
+
+    // other links keep their full bandwidth
+    EXPECT_EQ(topology->get_link_stats(1, 2).busy_time, serialization_time(chunk_size, bandwidth));
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, InNetworkReduction) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Switch_InNetworkReduction.yml");
+    const auto topology = construct_topology(network_parser);
+    const auto switch_id = topology->get_npus_count();
+    const auto hop_time = static_cast<EventTime>(network_parser.get_latencies_per_dim()[0]) +
+                          serialization_time(chunk_size, network_parser.get_bandwidths_per_dim()[0]);
+
+    // a reduction reads the 3 contributions at the reduction throughput
+    const auto reduction_time =
+        serialization_time(3 * chunk_size, network_parser.get_reduction_throughputs_per_dim()[0]);
+
+    /// all-reduce among NPU 0-3, each NPU contributing a chunk to every other NPU
+    auto arrived_chunks = 0;
+    const auto count_arrival = [](void* const arg) { (*static_cast<int*>(arg))++; };
+    for (int src = 0; src < 4; src++) {
+        for (int dest = 0; dest < 4; dest++) {
+            if (src == dest) {
+                continue;
+            }
+
+            auto route = topology->route(src, dest);
+            auto chunk = std::make_unique<Chunk>(chunk_size, route, count_arrival, &arrived_chunks);
+            chunk->set_reduction_group(/* reduction_group = */ 0, /* contributions_count = */ 3);
+            topology->send(std::move(chunk));
+        }
+    }
+
+    /// Run simulation
+    while (!event_queue->finished()) {
+        event_queue->proceed();
+    }
+
+    /// test
+    // every contribution is accounted for once its reduced chunk arrived
+    EXPECT_EQ(arrived_chunks, 12);
+
+    // the switch sends a single reduced chunk to each destination
+    for (int npu = 0; npu < 4; npu++) {
+        EXPECT_EQ(topology->get_link_stats(npu, switch_id).chunks_sent, 3);
+        EXPECT_EQ(topology->get_link_stats(switch_id, npu).chunks_sent, 1);
+    }
+
+    // the switch reduces one destination at a time, starting once the first chunk of each NPU arrived,
+    // reducing faster than the NPUs send, so the reductions go back to back until the last reduced chunk leaves
+    const auto simulation_time = event_queue->get_current_time();
+    EXPECT_EQ(simulation_time, hop_time + 4 * reduction_time + hop_time);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, ParallelConstruction) {
+    /// setup
+    const auto serial_parser = NetworkParser("../../input/Ring_FullyConnected_Switch_SingleThread.yml");
+    const auto parallel_parser = NetworkParser("../../input/Ring_FullyConnected_Switch_Threads.yml");
+    const auto serial_topology = construct_topology(serial_parser);
+    const auto parallel_topology = construct_topology(parallel_parser);
+
+    /// test
+    // the links get the same ids and endpoints regardless of the number of threads
+    EXPECT_EQ(parallel_topology->get_links_count(), serial_topology->get_links_count());
+
+    std::ostringstream serial_links;
+    std::ostringstream parallel_links;
+    serial_topology->dump_link_stats_csv(serial_links, 1);
+    parallel_topology->dump_link_stats_csv(parallel_links, 1);
+    EXPECT_EQ(parallel_links.str(), serial_links.str());
+
+    // and so do the routes
+    const auto npus_count = serial_topology->get_npus_count();
+    for (auto src = 0; src < npus_count; src += 7) {
+        for (auto dest = 0; dest < npus_count; dest += 5) {
+            if (src == dest) {
+                continue;
+            }
+
+            auto serial_route = serial_topology->route(src, dest);
+            auto parallel_route = parallel_topology->route(src, dest);
+            ASSERT_EQ(parallel_route.size(), serial_route.size());
+            for (auto s = serial_route.begin(), p = parallel_route.begin(); s != serial_route.end(); ++s, ++p) {
+                EXPECT_EQ((*p)->get_id(), (*s)->get_id());
+            }
+        }
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, LazyLinks) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/FullyConnected_LazyLinks.yml");
+    const auto topology = construct_topology(network_parser);
+    const auto npus_count = topology->get_npus_count();
+    const auto bandwidth = network_parser.get_bandwidths_per_dim()[0];
+    const auto latency = static_cast<EventTime>(network_parser.get_latencies_per_dim()[0]);
+
+    // every link is numbered, but none is materialized before any traffic
+    EXPECT_EQ(topology->get_links_count(), npus_count * (npus_count - 1));
+    EXPECT_EQ(topology->get_materialized_links_count(), 0);
+
+    /// one ring step, each NPU sending a chunk to the next one
+    for (int src = 0; src < npus_count; src++) {
+        auto route = topology->route(src, (src + 1) % npus_count);
+        auto chunk = std::make_unique<Chunk>(chunk_size, route, callback, nullptr);
+        topology->send(std::move(chunk));
+    }
+
+    /// Run simulation
+    while (!event_queue->finished()) {
+        event_queue->proceed();
+    }
+
+    /// test
+    // only the links of the ring got materialized
+    EXPECT_EQ(topology->get_materialized_links_count(), npus_count);
+    EXPECT_EQ(topology->get_links_count(), npus_count * (npus_count - 1));
+
+    // and they behave as if materialized up front, all chunks crossing a single link in parallel
+    const auto serialization = serialization_time(chunk_size, bandwidth);
+    EXPECT_EQ(topology->get_link_stats(0, 1).busy_time, serialization);
+    const auto simulation_time = event_queue->get_current_time();
+    EXPECT_EQ(simulation_time, serialization + latency);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, ImplicitTopology) {
+    /// setup
+    const auto explicit_topology = construct_topology(NetworkParser("../../input/Ring_FullyConnected_Switch.yml"));
+    const auto network_parser = NetworkParser("../../input/Ring_FullyConnected_Switch_Implicit.yml");
+    const auto topology = construct_topology(network_parser);
+    const auto npus_count = topology->get_npus_count();
+
+    // every link is numbered, as in the explicit topology, but none is materialized
+    EXPECT_EQ(topology->get_links_count(), explicit_topology->get_links_count());
+    EXPECT_EQ(topology->get_materialized_links_count(), 0);
+
+    /// one ring step on both topologies
+    const auto explicit_simulation_time = simulate_ring_step(*explicit_topology);
+    const auto simulation_time = simulate_ring_step(*topology);
+
+    /// test
+    // the chunks took the same routes and the links behaved as in the explicit topology
+    auto traversed_links = std::set<std::pair<DeviceId, DeviceId>>();
+    for (int src = 0; src < npus_count; src++) {
+        const auto dest = (src + 1) % npus_count;
+        auto route = topology->route(src, dest);
+        auto explicit_route = explicit_topology->route(src, dest);
+        ASSERT_EQ(route.size(), explicit_route.size());
+
+        for (auto device = route.begin(), next = std::next(route.begin()); next != route.end(); ++device, ++next) {
+            const auto link = std::make_pair((*device)->get_id(), (*next)->get_id());
+            traversed_links.insert(link);
+
+            const auto& stats = topology->get_link_stats(link.first, link.second);
+            const auto& explicit_stats = explicit_topology->get_link_stats(link.first, link.second);
+            EXPECT_EQ(stats.chunks_sent, explicit_stats.chunks_sent);
+            EXPECT_EQ(stats.busy_time, explicit_stats.busy_time);
+        }
+    }
+    EXPECT_EQ(simulation_time, explicit_simulation_time);
+
+    // only the links the chunks went through got materialized
+    EXPECT_EQ(topology->get_materialized_links_count(), traversed_links.size());
+    EXPECT_LT(topology->get_materialized_links_count(), topology->get_links_count());
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, TopologyCache) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Ring_FullyConnected_Switch_Cached.yml");
+    const auto cache_path =
+        TopologyCache::get_path(network_parser.get_topology_cache(), network_parser.get_topology_hash());
+    std::filesystem::remove(cache_path);
+
+    // the first construction compiles the topology, next to the config
+    const auto compiled_topology = construct_topology(network_parser);
+    ASSERT_TRUE(std::filesystem::exists(cache_path));
+    EXPECT_EQ(std::filesystem::path(cache_path).parent_path().parent_path(), std::filesystem::path("../../input"));
+    EXPECT_NE(TopologyCache::load(cache_path, network_parser.get_topology_hash()), nullptr);
+
+    // backdate the compiled topology, so that compiling it again would be noticed
+    const auto compiled_time = std::filesystem::file_time_type() + std::chrono::hours(24);
+    std::filesystem::last_write_time(cache_path, compiled_time);
+
+    // and the next ones load it instead of compiling it again
+    const auto topology = construct_topology(network_parser);
+    EXPECT_EQ(std::filesystem::last_write_time(cache_path), compiled_time);
+    EXPECT_EQ(topology->get_links_count(), compiled_topology->get_links_count());
+
+    /// one ring step on both topologies
+    const auto compiled_simulation_time = simulate_ring_step(*compiled_topology);
+    const auto simulation_time = simulate_ring_step(*topology);
+
+    /// test
+    // the loaded topology behaves as the one it was compiled from, link by link
+    std::ostringstream compiled_links;
+    std::ostringstream links;
+    compiled_topology->dump_link_stats_csv(compiled_links, compiled_simulation_time);
+    topology->dump_link_stats_csv(links, simulation_time);
+    EXPECT_EQ(links.str(), compiled_links.str());
+    EXPECT_EQ(simulation_time, compiled_simulation_time);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, LinkHealthSchedule) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Ring_LinkHealthSchedule.yml");
+    const auto topology = construct_topology(network_parser);
+    const auto bandwidth = network_parser.get_bandwidths_per_dim()[0];
+    const auto latency = static_cast<EventTime>(network_parser.get_latencies_per_dim()[0]);
+    const auto link_health_schedule = network_parser.get_link_health_schedule();
+    const auto derated_health = std::get<3>(link_health_schedule[0]);
+    const auto failure_time = std::get<2>(link_health_schedule[1]);
+
+    /// two chunks 1 -> 2, the second one queued when the link fails, and one chunk over the derated link
+    const std::vector<std::pair<int, int>> pairs = {{1, 2}, {1, 2}, {4, 5}};
+    for (const auto& [src, dest] : pairs) {
+        auto route = topology->route(src, dest);
+        auto chunk = std::make_unique<Chunk>(chunk_size, route, callback, nullptr);
+        topology->send(std::move(chunk));
+    }
+
+    // another chunk 1 -> 2 once the link got restored
+    auto late_send = std::make_pair(topology.get(), chunk_size);
+    event_queue->schedule_event(
+        40'000,
+        [](void* const arg) {
+            auto* const late_send = static_cast<std::pair<Topology*, ChunkSize>*>(arg);
+            auto route = late_send->first->route(1, 2);
+            auto chunk = std::make_unique<Chunk>(late_send->second, route, callback, nullptr);
+            late_send->first->send(std::move(chunk));
+        },
+        &late_send);
+
+    /// Run simulation
+    while (!event_queue->finished()) {
+        event_queue->proceed();
+    }
+
+    /// test
+    const auto serialization = serialization_time(chunk_size, bandwidth);
+    const auto derated_serialization = serialization_time(chunk_size, bandwidth * derated_health);
+
+    // the chunk under transmission and the late one go through 1 -> 2, the queued one the other way around the ring
+    EXPECT_EQ(topology->get_link_stats(1, 2).chunks_sent, 2);
+    EXPECT_EQ(topology->get_link_stats(1, 2).busy_time, 2 * serialization);
+    EXPECT_EQ(topology->get_link_stats(1, 0).chunks_sent, 1);
+    EXPECT_EQ(topology->get_link_stats(3, 2).chunks_sent, 1);
+
+    // a derated link runs at its health times its bandwidth, in both directions
+    EXPECT_EQ(topology->get_link_stats(4, 5).busy_time, derated_serialization);
+    EXPECT_EQ(topology->get_link_stats(5, 4).busy_time, derated_serialization);
+
+    // the rerouted chunk left device 1 at the failure, then crossed 7 links, 5 -> 4 being derated
+    const auto simulation_time = event_queue->get_current_time();
+    EXPECT_EQ(simulation_time, failure_time + 6 * (serialization + latency) + derated_serialization + latency);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, FaultAwareRouting) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Ring_FullyConnected_Switch_FaultyLinks.yml");
+    const auto topology = construct_topology(network_parser);
+    const auto bandwidths = network_parser.get_bandwidths_per_dim();
+    const auto latencies = network_parser.get_latencies_per_dim();
+
+    const auto route_ids = [&topology](const DeviceId src, const DeviceId dest) {
+        auto ids = std::vector<DeviceId>();
+        for (const auto& device : topology->route(src, dest)) {
+            ids.push_back(device->get_id());
+        }
+        return ids;
+    };
+
+    /// test
+    // 0 -> 64 is dead, and detouring through 1 -> 64 at half bandwidth is slower than through 2 -> 64
+    EXPECT_EQ(route_ids(0, 16), (std::vector<DeviceId>{0, 2, 64, 16}));
+
+    // restoring 1 -> 64 makes the detour over the faster ring link the fastest
+    topology->set_link_health(1, 64, 0, 1.0);
+    EXPECT_EQ(route_ids(0, 16), (std::vector<DeviceId>{0, 1, 64, 16}));
+
+    // failing a link of the cached route drops it
+    topology->set_link_health(1, 64, 0, 0.0);
+    EXPECT_EQ(route_ids(0, 16), (std::vector<DeviceId>{0, 2, 64, 16}));
+
+    // routes avoiding the faults are left as they are
+    EXPECT_EQ(route_ids(2, 18), (std::vector<DeviceId>{2, 64, 18}));
+
+    /// send a chunk along the rerouted path
+    auto route = topology->route(0, 16);
+    auto chunk = std::make_unique<Chunk>(chunk_size, route, callback, nullptr);
+    topology->send(std::move(chunk));
+
+    /// Run simulation
+    while (!event_queue->finished()) {
+        event_queue->proceed();
+    }
+
+    EXPECT_EQ(topology->get_link_stats(0, 2).chunks_sent, 1);
+    EXPECT_EQ(topology->get_link_stats(64, 16).chunks_sent, 1);
+
+    // over one FullyConnected link, then two Switch links
+    const auto fully_connected_hop =
+        serialization_time(chunk_size, bandwidths[1]) + static_cast<EventTime>(latencies[1]);
+    const auto switch_hop = serialization_time(chunk_size, bandwidths[2]) + static_cast<EventTime>(latencies[2]);
+    const auto simulation_time = event_queue->get_current_time();
+    EXPECT_EQ(simulation_time, fully_connected_hop + 2 * switch_hop);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, AdaptiveRouting) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Ring_FullyConnected_Switch_Adaptive.yml");
+    const auto oblivious_topology = construct_topology(NetworkParser("../../input/Ring_FullyConnected_Switch.yml"));
+    const auto topology = std::dynamic_pointer_cast<MultiDimTopology>(construct_topology(network_parser));
+    ASSERT_NE(topology, nullptr);
+
+    /// skewed traffic, NPU 0 sending 8 chunks to NPU 19, which differs in every dimension
+    const auto chunks_count = 8;
+    const auto send_skewed_traffic = [this, chunks_count](Topology& topology) {
+        event_queue = std::make_shared<EventQueue>();
+        Topology::set_event_queue(event_queue);
+
+        for (int i = 0; i < chunks_count; i++) {
+            auto route = topology.route(0, 19);
+            auto chunk = std::make_unique<Chunk>(chunk_size, route, callback, nullptr);
+            topology.send(std::move(chunk));
+        }
+
+        while (!event_queue->finished()) {
+            event_queue->proceed();
+        }
+
+        return event_queue->get_current_time();
+    };
+    const auto oblivious_simulation_time = send_skewed_traffic(*oblivious_topology);
+    const auto simulation_time = send_skewed_traffic(*topology);
+
+    /// test
+    // without adaptive routing, all chunks take the same first link
+    const std::vector<DeviceId> first_hops = {1, 2, 64};
+    auto oblivious_first_hop_chunks = std::vector<uint64_t>();
+    for (const auto next : first_hops) {
+        oblivious_first_hop_chunks.push_back(oblivious_topology->get_link_stats(0, next).chunks_sent);
+    }
+    EXPECT_EQ(std::count(oblivious_first_hop_chunks.begin(), oblivious_first_hop_chunks.end(), chunks_count), 1);
+
+    // with it, the chunks spread over the first links of every dimension and complete sooner
+    auto first_hop_chunks = uint64_t{0};
+    for (const auto next : first_hops) {
+        EXPECT_GT(topology->get_link_stats(0, next).chunks_sent, 0);
+        first_hop_chunks += topology->get_link_stats(0, next).chunks_sent;
+    }
+    EXPECT_EQ(first_hop_chunks, chunks_count);
+    EXPECT_LT(simulation_time, oblivious_simulation_time);
+
+    // one row per dimension, every chunk crossing each dimension once, and the switch through two links
+    std::ostringstream dim_load;
+    topology->dump_dim_load_csv(dim_load, simulation_time);
+    std::istringstream rows(dim_load.str());
+    std::string row;
+    std::getline(rows, row);
+    EXPECT_EQ(row, "dim,links,bytes_sent,chunks_sent,busy_time_ns,queueing_time_ns,avg_utilization,max_utilization");
+
+    const auto npus_counts = network_parser.get_npus_counts_per_dim();
+    const auto bandwidths = network_parser.get_bandwidths_per_dim();
+    const auto npus_count = topology->get_npus_count();
+    const std::vector<int> links_per_npu = {1, npus_counts[1] - 1, 2};
+    const std::vector<int> links_per_chunk = {1, 1, 2};
+    for (auto dim = 0; dim < 3; dim++) {
+        const auto chunks_sent = chunks_count * links_per_chunk[dim];
+        std::ostringstream expected_row;
+        expected_row << dim << "," << npus_count * links_per_npu[dim] << "," << chunks_sent * chunk_size << ","
+                     << chunks_sent << "," << chunks_sent * serialization_time(chunk_size, bandwidths[dim]) << ",";
+
+        std::getline(rows, row);
+        EXPECT_EQ(row.rfind(expected_row.str(), 0), 0) << row;
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, AdaptiveRoutingInCluster) {
+    /// setup
+    const auto oblivious_topology =
+        construct_topology(NetworkParser("../../input/Ring_FullyConnected_Switch_FastAgents.yml"));
+    const auto topology =
+        construct_topology(NetworkParser("../../input/Ring_FullyConnected_Switch_FastAgents_Adaptive.yml"));
+
+    /// NPU 5 sending 8 chunks to NPU 16, the agent of the next cluster, through the agent of its own cluster, NPU 0
+    const auto send_to_next_cluster = [this](Topology& topology) {
+        event_queue = std::make_shared<EventQueue>();
+        Topology::set_event_queue(event_queue);
+
+        for (int i = 0; i < 8; i++) {
+            auto route = topology.route(5, 16);
+
+            // the agents-only dimensions are only crossed from the agents
+            for (auto device = route.begin(), next = std::next(route.begin()); next != route.end(); ++device, ++next) {
+                EXPECT_TRUE((*device)->connected((*next)->get_id()));
+            }
+
+            auto chunk = std::make_unique<Chunk>(chunk_size, route, callback, nullptr);
+            topology.send(std::move(chunk));
+        }
+
+        while (!event_queue->finished()) {
+            event_queue->proceed();
+        }
+
+        return event_queue->get_current_time();
+    };
+    const auto oblivious_simulation_time = send_to_next_cluster(*oblivious_topology);
+    const auto simulation_time = send_to_next_cluster(*topology);
+
+    /// test
+    // within the cluster, the chunks all take the same first link towards the agent
+    const auto oblivious_ring_chunks = oblivious_topology->get_link_stats(5, 4).chunks_sent;
+    const auto oblivious_fully_connected_chunks = oblivious_topology->get_link_stats(5, 1).chunks_sent;
+    EXPECT_EQ(oblivious_ring_chunks + oblivious_fully_connected_chunks, 8);
+    EXPECT_EQ(std::min(oblivious_ring_chunks, oblivious_fully_connected_chunks), 0);
+
+    // unless adaptive, then they spread over its Ring and FullyConnected links
+    EXPECT_EQ(topology->get_link_stats(5, 4).chunks_sent, 4);
+    EXPECT_EQ(topology->get_link_stats(5, 1).chunks_sent, 4);
+
+    // and leave the cluster through its agent sooner
+    EXPECT_EQ(topology->get_link_stats(0, 64).chunks_sent, 8);
+    EXPECT_LT(simulation_time, oblivious_simulation_time);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, Striping) {
+    /// setup
+    const auto single_path_topology = construct_topology(NetworkParser("../../input/Ring_Striping_None.yml"));
+    const auto network_parser = NetworkParser("../../input/Ring_Striping.yml");
+    const auto topology = construct_topology(network_parser);
+    const auto bandwidth = network_parser.get_bandwidths_per_dim()[0];
+    const auto latency = static_cast<EventTime>(network_parser.get_latencies_per_dim()[0]);
+
+    /// test
+    // halfway around the ring, both directions are equally short
+    EXPECT_EQ(topology->routes(0, 4).size(), 2);
+    EXPECT_EQ(topology->routes(0, 3).size(), 1);
+
+    /// send 4 chunks, all created with the clockwise route
+    const auto send_halfway = [this](Topology& topology) {
+        event_queue = std::make_shared<EventQueue>();
+        Topology::set_event_queue(event_queue);
+
+        for (auto i = 0; i < 4; i++) {
+            auto route = topology.route(0, 4);
+            auto chunk = std::make_unique<Chunk>(chunk_size, route, callback, nullptr);
+            topology.send(std::move(chunk));
+        }
+
+        while (!event_queue->finished()) {
+            event_queue->proceed();
+        }
+
+        return event_queue->get_current_time();
+    };
+    const auto single_path_simulation_time = send_halfway(*single_path_topology);
+    const auto simulation_time = send_halfway(*topology);
+
+    // without striping, all chunks go clockwise
+    EXPECT_EQ(single_path_topology->get_link_stats(0, 1).chunks_sent, 4);
+    EXPECT_EQ(single_path_topology->get_link_stats(0, 7).chunks_sent, 0);
+
+    // with it, chunks alternate between both directions
+    EXPECT_EQ(topology->get_link_stats(0, 1).chunks_sent, 2);
+    EXPECT_EQ(topology->get_link_stats(0, 7).chunks_sent, 2);
+    EXPECT_EQ(topology->get_link_stats(3, 4).chunks_sent, 2);
+    EXPECT_EQ(topology->get_link_stats(5, 4).chunks_sent, 2);
+
+    // so the 4 links of each direction pipeline 2 chunks instead of 4
+    const auto serialization = serialization_time(chunk_size, bandwidth);
+    const auto hop_time = serialization + latency;
+    EXPECT_EQ(single_path_simulation_time, 4 * hop_time + 3 * serialization);
+    EXPECT_EQ(simulation_time, 4 * hop_time + serialization);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, StripingAfterLinkDerate) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Ring_Striping_BandwidthWeighted.yml");
+    const auto topology = construct_topology(network_parser);
+
+    const auto send_halfway = [&topology](const int chunks_count, const ChunkSize chunk_size) {
+        for (auto i = 0; i < chunks_count; i++) {
+            auto route = topology->route(0, 4);
+            auto chunk = std::make_unique<Chunk>(chunk_size, route, callback, nullptr);
+            topology->send(std::move(chunk));
+        }
+    };
+
+    /// both directions are equally fast at first
+    send_halfway(2, chunk_size);
+    while (!event_queue->finished()) {
+        event_queue->proceed();
+    }
+    EXPECT_EQ(topology->get_link_stats(0, 1).chunks_sent, 1);
+    EXPECT_EQ(topology->get_link_stats(0, 7).chunks_sent, 1);
+
+    /// derating a link of the clockwise route drops the routes striped over, whose weights get rebuilt
+    topology->set_link_health(1, 2, event_queue->get_current_time(), 0.25);
+    send_halfway(10, chunk_size);
+    while (!event_queue->finished()) {
+        event_queue->proceed();
+    }
+
+    /// test
+    // the clockwise route only gets a quarter of the counterclockwise one's weight
+    EXPECT_EQ(topology->get_link_stats(0, 1).chunks_sent, 1 + 2);
+    EXPECT_EQ(topology->get_link_stats(0, 7).chunks_sent, 1 + 8);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, StripingMultiDim) {
+    /// setup
+    const auto single_path_topology = construct_topology(NetworkParser("../../input/Ring_FullyConnected_Switch.yml"));
+    const auto topology = construct_topology(NetworkParser("../../input/Ring_FullyConnected_Switch_Striping.yml"));
+
+    /// test
+    // NPU 19 differs from NPU 0 in every dimension, so each of them can be traversed first
+    const auto routes = topology->routes(0, 19);
+    EXPECT_EQ(routes.size(), 3);
+    for (const auto& route : routes) {
+        EXPECT_EQ(route.front()->get_id(), 0);
+        EXPECT_EQ(route.back()->get_id(), 19);
+        for (auto device = route.begin(), next = std::next(route.begin()); next != route.end(); ++device, ++next) {
+            EXPECT_TRUE((*device)->connected((*next)->get_id()));
+        }
+    }
+
+    /// send 8 chunks, all created with the same route
+    const auto send_skewed_traffic = [this](Topology& topology) {
+        event_queue = std::make_shared<EventQueue>();
+        Topology::set_event_queue(event_queue);
+
+        for (auto i = 0; i < 8; i++) {
+            auto route = topology.route(0, 19);
+            auto chunk = std::make_unique<Chunk>(chunk_size, route, callback, nullptr);
+            topology.send(std::move(chunk));
+        }
+
+        while (!event_queue->finished()) {
+            event_queue->proceed();
+        }
+
+        return event_queue->get_current_time();
+    };
+    const auto single_path_simulation_time = send_skewed_traffic(*single_path_topology);
+    const auto simulation_time = send_skewed_traffic(*topology);
+
+    // the chunks leave NPU 0 through more than one link, and complete sooner
+    auto first_links_used = 0;
+    for (const auto next : {1, 2, 64}) {
+        first_links_used += (topology->get_link_stats(0, next).chunks_sent > 0) ? 1 : 0;
+    }
+    EXPECT_GT(first_links_used, 1);
+    EXPECT_LT(simulation_time, single_path_simulation_time);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, ClusterAgentsOnlyLinks) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Ring_FullyConnected_Switch_Cluster.yml");
+    const auto topology = construct_topology(network_parser);
+    const auto npus_counts = network_parser.get_npus_counts_per_dim();
+    const auto npus_count = topology->get_npus_count();
+
+    /// test
+    // every NPU is on a Ring of 2, with a link each way
+    const auto ring_links_count = npus_count;
+    // the FullyConnected links the agent of each Ring, i.e., its first NPU
+    const auto fully_connected_links_count = (npus_count / npus_counts[0]) * (npus_counts[1] - 1);
+    // and the Switch links the agents of the FullyConnected blocks, i.e., their first NPU, up and down
+    const auto switch_links_count = npus_counts[2] * 2;
+    EXPECT_EQ(topology->get_links_count(), ring_links_count + fully_connected_links_count + switch_links_count);
+
+    // inter-cluster traffic leaves and enters the clusters through their agents
+    auto route_ids = std::vector<DeviceId>();
+    for (const auto& device : topology->route(3, 61)) {
+        route_ids.push_back(device->get_id());
+    }
+    EXPECT_EQ(route_ids, (std::vector<DeviceId>{3, 2, 0, 64, 48, 60, 61}));
+
+    /// send a chunk along the route
+    auto route = topology->route(3, 61);
+    auto chunk = std::make_unique<Chunk>(chunk_size, route, callback, nullptr);
+    topology->send(std::move(chunk));
+
+    /// Run simulation
+    while (!event_queue->finished()) {
+        event_queue->proceed();
+    }
+
+    EXPECT_EQ(topology->get_link_stats(0, 64).chunks_sent, 1);
+    EXPECT_EQ(topology->get_link_stats(60, 61).chunks_sent, 1);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, ClusterAgents) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Ring_FullyConnected_Switch_ClusterAgents.yml");
+    const auto topology = construct_topology(network_parser);
+    const auto npus_counts = network_parser.get_npus_counts_per_dim();
+    const auto npus_count = topology->get_npus_count();
+    const auto agents_count = network_parser.get_cluster_agents();
+
+    /// test
+    // every NPU is on a Ring of 2, with a link each way
+    const auto ring_links_count = npus_count;
+    // the FullyConnected links each agent of every Ring, i.e., both of its NPUs
+    const auto fully_connected_links_count = (npus_count / npus_counts[0]) * agents_count * (npus_counts[1] - 1);
+    // and the top dimension has a single Switch (device 64), linked up and down with
+    // every agent of each of the FullyConnected blocks at the Switch positions
+    const auto switch_links_count = agents_count * npus_counts[2] * 2;
+    EXPECT_EQ(topology->get_links_count(), ring_links_count + fully_connected_links_count + switch_links_count);
+
+    // inter-cluster pairs are spread over both agents of each cluster
+    auto route_ids = std::vector<DeviceId>();
+    for (const auto& device : topology->route(3, 61)) {
+        route_ids.push_back(device->get_id());
+    }
+    EXPECT_EQ(route_ids, (std::vector<DeviceId>{3, 1, 64, 49, 61}));
+
+    route_ids.clear();
+    for (const auto& device : topology->route(3, 60)) {
+        route_ids.push_back(device->get_id());
+    }
+    EXPECT_EQ(route_ids, (std::vector<DeviceId>{3, 2, 0, 64, 48, 60}));
+
+    /// send a chunk along each route
+    for (const auto dest : {61, 60}) {
+        auto route = topology->route(3, dest);
+        auto chunk = std::make_unique<Chunk>(chunk_size, route, callback, nullptr);
+        topology->send(std::move(chunk));
+    }
+
+    /// Run simulation
+    while (!event_queue->finished()) {
+        event_queue->proceed();
+    }
+
+    // each agent carried one of the chunks
+    EXPECT_EQ(topology->get_link_stats(1, 64).chunks_sent, 1);
+    EXPECT_EQ(topology->get_link_stats(0, 64).chunks_sent, 1);
+}